@@ -0,0 +1,78 @@
+// Steady-state place+cancel latency through OrderManager, with a count of heap
+// allocations made after warm-up (expected to be zero with the slot pool).
+#include "order_manager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    constexpr size_t WARM_UP = 10'000;
+    constexpr size_t ITERATIONS = 1'000'000;
+    constexpr int RESTING = 32;
+
+    OrderManager::Config config;
+    config.max_active_orders = 64;
+    config.max_notional = 1e12;
+    OrderManager manager(config);
+
+    // Keep a resting ladder so the index is not trivially empty
+    for (int i = 0; i < RESTING; ++i) {
+        manager.place_order(OrderSide::BUY, 100.0 - i * 0.5, 1.0);
+    }
+
+    std::vector<double> samples(ITERATIONS);
+    auto place_cancel = [&](size_t i) {
+        const double price = 101.0 + (i & 0xf) * 0.5;
+        auto order = manager.place_order(OrderSide::SELL, price, 1.0);
+        if (!order || !manager.cancel_order(order->order_id)) {
+            std::fprintf(stderr, "place/cancel failed at %zu\n", i);
+            std::exit(1);
+        }
+    };
+
+    for (size_t i = 0; i < WARM_UP; ++i) {
+        place_cancel(i);
+    }
+
+    const size_t allocations_before = g_allocations.load();
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        place_cancel(i);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        samples[i] = std::chrono::duration<double, std::nano>(elapsed).count();
+    }
+    const size_t allocations = g_allocations.load() - allocations_before;
+
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double p) {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))];
+    };
+
+    std::printf("place+cancel, %zu iterations, %d resting orders\n", ITERATIONS, RESTING);
+    std::printf("  p50:   %8.1f ns\n", pct(0.50));
+    std::printf("  p99:   %8.1f ns\n", pct(0.99));
+    std::printf("  p99.9: %8.1f ns\n", pct(0.999));
+    std::printf("  heap allocations after warm-up: %zu\n", allocations);
+    return allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+// Cost of turning one order into a signed POST /order request body: the
+// per-order JSON object the connector used to build (nlohmann::json, standing
+// in for the former convert_order_to_dict path) plus a one-shot HMAC, against
+// a patched OrderTemplate plus a PrefixSigner.
+#include "order_template.h"
+#include "bitmex_rest_client.h"
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr const char* SYMBOL = "XBTUSD";
+constexpr const char* SECRET = "chNOOS4KvNXR_Xq4k4c9qsfoKWvnDecLATCRlcBwyKDYnWgO";
+constexpr int64_t EXPIRES = 1518064238;
+
+template <class F>
+double ns_per_order(size_t iterations, F&& serialize) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        serialize(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           iterations;
+}
+
+double price_of(size_t i) { return 9000.0 + static_cast<double>(i & 0x3ff) * 0.5; }
+double quantity_of(size_t i) { return static_cast<double>(1 + (i & 0xff)); }
+
+}  // namespace
+
+int main() {
+    constexpr size_t ITERATIONS = 500'000;
+    size_t checksum = 0;
+
+    const double dict_body = ns_per_order(ITERATIONS, [&](size_t i) {
+        nlohmann::json order{
+            {"symbol", SYMBOL},
+            {"side", "Buy"},
+            {"orderQty", quantity_of(i)},
+            {"price", price_of(i)},
+            {"ordType", "Limit"},
+            {"clOrdID", "mm_bitmex_" + std::to_string(i)},
+            {"execInst", "ParticipateDoNotInitiate"}
+        };
+        checksum += order.dump().size();
+    });
+
+    const OrderTemplate order_template(SYMBOL, OrderSide::BUY, true, 0.5, 1.0);
+    std::string body(order_template.size(), '\0');
+    auto render = [&](size_t i) {
+        char cl_ord_id[OrderTemplate::CL_ORD_ID_WIDTH] = "mm_bitmex_";
+        const auto end = std::to_chars(cl_ord_id + 10, cl_ord_id + sizeof(cl_ord_id), i).ptr;
+        order_template.render(std::string_view(cl_ord_id, end - cl_ord_id),
+                              price_of(i), quantity_of(i), body.data());
+    };
+    const double template_body = ns_per_order(ITERATIONS, [&](size_t i) {
+        render(i);
+        checksum += static_cast<unsigned char>(body[i % body.size()]);
+    });
+
+    const double dict_signed = ns_per_order(ITERATIONS, [&](size_t i) {
+        nlohmann::json order{
+            {"symbol", SYMBOL},
+            {"side", "Buy"},
+            {"orderQty", quantity_of(i)},
+            {"price", price_of(i)},
+            {"ordType", "Limit"},
+            {"clOrdID", "mm_bitmex_" + std::to_string(i)},
+            {"execInst", "ParticipateDoNotInitiate"}
+        };
+        checksum += bitmex_auth::sign(SECRET, "POST", "/api/v1/order", EXPIRES, order.dump())[0];
+    });
+
+    bitmex_auth::PrefixSigner signer(SECRET, "POST", "/api/v1/order");
+    char signature[bitmex_auth::PrefixSigner::SIGNATURE_SIZE];
+    const double template_signed = ns_per_order(ITERATIONS, [&](size_t i) {
+        render(i);
+        signer.sign(EXPIRES, body, signature);
+        checksum += static_cast<unsigned char>(signature[0]);
+    });
+
+    std::printf("POST /order serialization, %zu orders\n", ITERATIONS);
+    std::printf("  body only   json object: %8.1f ns   template: %8.1f ns   (%.1fx)\n",
+                dict_body, template_body, dict_body / template_body);
+    std::printf("  body + sign json + HMAC: %8.1f ns   template: %8.1f ns   (%.1fx)\n",
+                dict_signed, template_signed, dict_signed / template_signed);
+    std::printf("  (checksum %zu)\n", checksum);
+    return 0;
+}
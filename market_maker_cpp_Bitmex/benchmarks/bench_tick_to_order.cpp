@@ -0,0 +1,99 @@
+// Tick-to-order round trip against the local BitMEX stand-in: the exchange
+// moves the top of book, the connector decodes the orderBookL2 delta and
+// answers with a REST order, and the time until that order reaches the
+// exchange is recorded.
+//
+// Usage: bench_tick_to_order [iterations] [latency us] [jitter us]
+// The latency is injected on both the feed and the REST responses; only the
+// feed delay lies on the measured path.
+#include "local_bitmex_exchange.h"
+#include "bitmex_connector.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile(std::vector<int64_t>& samples, double p) {
+    const size_t i = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + i, samples.end());
+    return samples[i] / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    LocalBitMEXExchange::Config exchange_config;
+    exchange_config.ws_latency = std::chrono::microseconds(argc > 2 ? std::atoi(argv[2]) : 0);
+    exchange_config.rest_latency = exchange_config.ws_latency;
+    exchange_config.latency_jitter = std::chrono::microseconds(argc > 3 ? std::atoi(argv[3]) : 0);
+    exchange_config.requests_per_minute = 0;
+
+    LocalBitMEXExchange exchange(exchange_config);
+    std::atomic<int64_t> order_arrival{0};
+    exchange.set_request_listener([&](const std::string& method, const std::string&, int64_t ns) {
+        if (method == "POST") {
+            order_arrival.store(ns, std::memory_order_release);
+        }
+    });
+    exchange.set_level(OrderSide::BUY, 9999.5, 10);
+    exchange.set_level(OrderSide::SELL, 10000.5, 10);
+    exchange.start();
+
+    BitMEXConnector::Config config;
+    config.base_url = exchange.rest_url();
+    config.symbol = "XBTUSD";
+    config.rate_limit.per_second = 1'000'000;
+    config.rate_limit.per_minute = 1'000'000;
+    BitMEXConnector connector(config);
+
+    // Quote far from the touch whenever the best bid changes; our own
+    // resting orders also move the book and must not retrigger
+    int64_t next_id = 1;
+    double best_bid_size = 0.0;
+    std::atomic<bool> ready{false};
+    connector.subscribe_market_data([&](const MarketDepth& depth) {
+        if (!ready.load(std::memory_order_acquire) || depth.bids[0].quantity == best_bid_size) {
+            return;
+        }
+        best_bid_size = depth.bids[0].quantity;
+        Order order{};
+        order.order_id = next_id++;
+        order.side = OrderSide::BUY;
+        order.price = 9000.0;
+        order.quantity = 1;
+        connector.place_order(order);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ready.store(true, std::memory_order_release);
+
+    std::vector<int64_t> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; ++i) {
+        order_arrival.store(0, std::memory_order_relaxed);
+        const int64_t tick = steady_ns();
+        exchange.set_level(OrderSide::BUY, 9999.5, 11 + (i & 1));
+        int64_t arrival;
+        while ((arrival = order_arrival.load(std::memory_order_acquire)) == 0) {
+            std::this_thread::yield();
+        }
+        samples.push_back(arrival - tick);
+    }
+
+    std::printf("tick-to-order round trip, %d iterations, %lld us injected\n",
+                iterations, static_cast<long long>(exchange_config.ws_latency.count()));
+    std::printf("  p50: %10.1f us\n", percentile(samples, 0.50));
+    std::printf("  p99: %10.1f us\n", percentile(samples, 0.99));
+    std::printf("  max: %10.1f us\n", percentile(samples, 1.0));
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Throughput of decoding BitMEX orderBookL2 frames into the live book: the
+// zero-DOM bitmex_frame decoder against a DOM parse with per-field lookups
+// (nlohmann::json, standing in for the former py::dict path).
+//
+// Frames are read one per line from argv[1] when given (e.g. a capture of the
+// realtime feed); otherwise a synthetic session is generated.
+#include "bitmex_frame_parser.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+int64_t level_id(double price) { return 8'800'000'000 - static_cast<int64_t>(price * 2); }
+
+std::string row(double price, const char* side, int size) {
+    char buf[160];
+    std::snprintf(buf, sizeof(buf),
+                  R"({"symbol":"XBTUSD","id":%lld,"side":"%s","size":%d,"price":%.1f})",
+                  static_cast<long long>(level_id(price)), side, size, price);
+    return buf;
+}
+
+std::vector<std::string> synthetic_session(size_t count) {
+    std::vector<std::string> frames;
+    std::mt19937 rng(1);
+
+    std::string partial = R"({"table":"orderBookL2","action":"partial","keys":["symbol","id","side"],"data":[)";
+    for (int i = 0; i < 50; ++i) {
+        partial += row(10000.5 + i * 0.5, "Sell", 100 + i) + ",";
+        partial += row(10000.0 - i * 0.5, "Buy", 100 + i) + (i == 49 ? "" : ",");
+    }
+    frames.push_back(partial + "]}");
+
+    while (frames.size() < count) {
+        const bool bid = rng() & 1;
+        const double price = bid ? 10000.0 - (rng() % 50) * 0.5 : 10000.5 + (rng() % 50) * 0.5;
+        const int rows = 1 + rng() % 3;
+        std::string frame = R"({"table":"orderBookL2","action":"update","data":[)";
+        for (int r = 0; r < rows; ++r) {
+            frame += row(price + (bid ? -r : r) * 0.5, bid ? "Buy" : "Sell", 1 + rng() % 500);
+            frame += r + 1 == rows ? "" : ",";
+        }
+        frames.push_back(frame + "]}");
+    }
+    return frames;
+}
+
+template <class F>
+double messages_per_second(const std::vector<std::string>& frames, int passes, F&& decode) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const auto& frame : frames) {
+            decode(frame);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return frames.size() * passes / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> frames;
+    if (argc > 1) {
+        std::ifstream in(argv[1]);
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty()) {
+                frames.push_back(line);
+            }
+        }
+    } else {
+        frames = synthetic_session(200'000);
+    }
+    constexpr int PASSES = 5;
+
+    L2OrderBook dom_book;
+    MarketDepth dom_depth;
+    std::vector<L2OrderBook::Entry> dom_entries;
+    const double dom_rate = messages_per_second(frames, PASSES, [&](const std::string& text) {
+        const auto message = nlohmann::json::parse(text);
+        if (message.value("table", "") != "orderBookL2") {
+            return;
+        }
+        dom_entries.clear();
+        for (const auto& level : message["data"]) {
+            dom_entries.push_back(dom_book.make_entry(
+                level["id"].get<int64_t>(),
+                level["side"].get<std::string>() == "Buy" ? BookSide::BID : BookSide::ASK,
+                level.contains("price") ? level["price"].get<double>() : 0.0,
+                level.contains("size") ? level["size"].get<double>() : 0.0));
+        }
+        dom_book.apply(L2OrderBook::parse_action(message["action"].get<std::string>()),
+                       dom_entries.data(), dom_entries.size(), dom_depth);
+    });
+
+    L2OrderBook book;
+    MarketDepth depth;
+    std::vector<L2OrderBook::Entry> entries;
+    const double native_rate = messages_per_second(frames, PASSES, [&](const std::string& text) {
+        bitmex_frame::Frame frame;
+        if (!bitmex_frame::parse_frame(text, frame) || frame.table != bitmex_frame::Table::ORDER_BOOK_L2) {
+            return;
+        }
+        entries.clear();
+        bitmex_frame::parse_l2(frame.data, book, entries);
+        book.apply(frame.action, entries.data(), entries.size(), depth);
+    });
+
+    std::printf("orderBookL2 decode + apply, %zu frames x %d passes\n", frames.size(), PASSES);
+    std::printf("  DOM parse (nlohmann::json): %12.0f msg/s\n", dom_rate);
+    std::printf("  bitmex_frame (zero-DOM):    %12.0f msg/s\n", native_rate);
+    std::printf("  speedup: %.1fx\n", native_rate / dom_rate);
+    return depth.get_mid_price() == dom_depth.get_mid_price() ? 0 : 1;
+}
@@ -3,12 +3,13 @@
 #include "market_maker_strategy.h"
 #include "risk_manager.h"
 #include "performance_monitor.h"
+#include "tick_journal.h"
 #include <filesystem>
 
 class BacktestEngine {
 public:
     struct BacktestConfig {
-        std::string data_path;
+        std::string data_path;          // Tick journal written by the live feed
         std::string output_path;
         std::chrono::system_clock::time_point start_time;
         std::chrono::system_clock::time_point end_time;
@@ -62,7 +63,9 @@ private:
     
     // Internal state
     double current_capital_;
-    stable_vector<MarketDepth> market_data_;
+    std::unique_ptr<TickJournalReader> journal_;
+    TickJournalReader::Range market_data_{nullptr, nullptr};
+    stable_vector<double> benchmark_prices_;
     
     // Helper methods
     void load_market_data();
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include "order_manager.h"
+
+// In-process stand-in for BitMEX, for end-to-end tests and latency
+// benchmarks without a network.
+//
+// One loopback port serves both the REST order endpoints under /api/v1
+// (POST/PUT /order[/bulk], DELETE /order[/all], POST /order/cancelAllAfter,
+// GET /order, /position, /instrument) and the realtime WebSocket at /realtime
+// (orderBookL2 and execution topics), so a BitMEXConnector pointed at
+// rest_url() finds the feed at the usual place. GET /order lists open and
+// closed orders alike and honours the filter, count and reverse parameters;
+// as on BitMEX, a clOrdID stays taken for the life of the exchange once used.
+// Matching is done by OrderBookSimulator: the book holds background liquidity
+// placed with set_level() plus the client's orders, and trade() sends an
+// aggressor through it. Every fill of a client order is pushed on the
+// execution topic and every book change as an orderBookL2 delta.
+//
+// Fixed plus uniformly jittered latency can be added to every REST response
+// and every pushed frame (frames on one connection never overtake each
+// other), and requests are metered against a per-minute budget reported in
+// the usual x-ratelimit-* headers; over budget, or on demand through
+// inject_rate_limit()/inject_overload(), requests are answered 429 or 503.
+// Signatures are not checked.
+//
+// All state lives on one I/O thread. The public methods are thread-safe and
+// wait for that thread, so they must not be called from a request listener.
+class LocalBitMEXExchange {
+public:
+    struct Config {
+        std::string symbol = "XBTUSD";
+        double tick_size = 0.5;
+        double lot_size = 1.0;
+        uint16_t port = 0;                            // 0 picks a free port
+        std::chrono::microseconds rest_latency{0};    // Before every REST response
+        std::chrono::microseconds ws_latency{0};      // Before every pushed frame
+        std::chrono::microseconds latency_jitter{0};  // Extra uniform 0..jitter, both paths
+        int requests_per_minute = 300;                // 0 disables the budget
+        size_t book_depth = 25;                       // Levels per side on orderBookL2
+    };
+
+    // Called on the I/O thread as each REST request arrives, before any
+    // injected latency; `received_ns` is on the steady clock
+    using RequestListener = std::function<void(
+        const std::string& method, const std::string& path, int64_t received_ns)>;
+
+    explicit LocalBitMEXExchange(Config config);
+    ~LocalBitMEXExchange();
+
+    LocalBitMEXExchange(const LocalBitMEXExchange&) = delete;
+    LocalBitMEXExchange& operator=(const LocalBitMEXExchange&) = delete;
+
+    // Binds in the constructor; start() begins serving
+    void start();
+    void stop();
+
+    std::string rest_url() const;  // http://127.0.0.1:port/api/v1
+    std::string ws_url() const;    // ws://127.0.0.1:port/realtime
+    uint16_t port() const;
+
+    // Sets the background liquidity resting at one price; 0 removes it.
+    // Client orders at that price keep their place in the queue.
+    void set_level(OrderSide side, double price, double size);
+    // Aggressive background order, filled against the book up to `price`;
+    // any remainder is dropped
+    void trade(OrderSide side, double price, double quantity);
+
+    // The next `count` requests are refused with 429 and Retry-After
+    void inject_rate_limit(int count, int retry_after_seconds = 1);
+    // The next `count` requests are refused with 503 (exchange overloaded)
+    void inject_overload(int count);
+
+    void set_request_listener(RequestListener listener);
+
+    size_t open_orders();
+    double position();       // Net filled quantity of client orders
+    uint64_t requests();     // REST requests received, including refused ones
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Destructive interference size for the targets we deploy on (x86-64, Graviton).
+// Used to keep producer- and consumer-owned atomics on separate lines.
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "market_data.h"
+#include "cache_line.h"
+
+// Structure-of-arrays copy of a MarketDepth for the book kernels in
+// utils/book_kernels.h. Prices and quantities are contiguous per side, so a
+// 20-level side is five AVX2 (or two and a half AVX-512) loads instead of a
+// strided walk over Level structs with atomics in between.
+struct DepthSoA {
+    static constexpr size_t LEVELS = MarketDepth::MAX_LEVELS;
+    
+    alignas(CACHE_LINE_SIZE) double bid_px[LEVELS];
+    alignas(CACHE_LINE_SIZE) double bid_qty[LEVELS];
+    alignas(CACHE_LINE_SIZE) double ask_px[LEVELS];
+    alignas(CACHE_LINE_SIZE) double ask_qty[LEVELS];
+    
+    // Number of populated (price > 0) levels per side; the rest are zero
+    size_t bid_levels{0};
+    size_t ask_levels{0};
+    
+    DepthSoA() = default;
+    explicit DepthSoA(const MarketDepth& depth) { load(depth); }
+    
+    // Consistent with respect to concurrent writers of depth
+    void load(const MarketDepth& depth) {
+        depth.read_consistent([this](const MarketDepth& book) { copy_from(book); });
+    }
+    
+    // Unsynchronised copy, for callers that read more of the book inside
+    // their own read_consistent() callback
+    void copy_from(const MarketDepth& book) {
+        bid_levels = 0;
+        ask_levels = 0;
+        for (size_t i = 0; i < LEVELS; ++i) {
+            const bool has_bid = book.bids[i].price > 0;
+            bid_px[i] = has_bid ? book.bids[i].price : 0.0;
+            bid_qty[i] = has_bid ? book.bids[i].quantity : 0.0;
+            bid_levels += has_bid && bid_levels == i;
+            
+            const bool has_ask = book.asks[i].price > 0;
+            ask_px[i] = has_ask ? book.asks[i].price : 0.0;
+            ask_qty[i] = has_ask ? book.asks[i].quantity : 0.0;
+            ask_levels += has_ask && ask_levels == i;
+        }
+    }
+    
+    const double* px(BookSide side) const { return side == BookSide::BID ? bid_px : ask_px; }
+    const double* qty(BookSide side) const { return side == BookSide::BID ? bid_qty : ask_qty; }
+    size_t levels(BookSide side) const { return side == BookSide::BID ? bid_levels : ask_levels; }
+};
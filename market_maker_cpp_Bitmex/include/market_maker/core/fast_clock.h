@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+// Cheap nanosecond timestamps for the market data path.
+//
+// On x86-64 hosts that report an invariant TSC (CPUID 0x80000007 EDX[8])
+// this reads the TSC and scales it with a ratio calibrated once against
+// steady_clock; anywhere else, including VMs that hide the bit, it falls
+// back to steady_clock. Either way values are anchored to system_clock so
+// they stay comparable with the wall-clock nanoseconds used elsewhere, and
+// are not adjusted for NTP slew after calibration.
+//
+// Calibration busy-waits ~5ms. fast_clock.cpp runs it when the library is
+// loaded so it never lands on the first feed tick.
+class FastClock {
+public:
+    static int64_t now_ns() {
+        const Calibration& cal = calibration();
+#if defined(__x86_64__) || defined(_M_X64)
+        if (cal.use_tsc) {
+            // Signed: a core whose TSC reads slightly behind the anchor's
+            // gives a slightly earlier time, not a wrapped one
+            const auto ticks = static_cast<int64_t>(__rdtsc() - cal.tsc_anchor);
+            return cal.wall_anchor_ns + static_cast<int64_t>(static_cast<double>(ticks) * cal.ns_per_tick);
+        }
+#endif
+        return cal.wall_anchor_ns + std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - cal.steady_anchor).count();
+    }
+
+    // Whether now_ns() reads the TSC rather than steady_clock
+    static bool uses_tsc() { return calibration().use_tsc; }
+
+private:
+    struct Calibration {
+        int64_t wall_anchor_ns;
+        uint64_t tsc_anchor;
+        double ns_per_tick;
+        bool use_tsc;
+        std::chrono::steady_clock::time_point steady_anchor;
+    };
+
+    static const Calibration& calibration() {
+        static const Calibration cal = calibrate();
+        return cal;
+    }
+
+    static bool invariant_tsc() {
+#if defined(__x86_64__) || defined(_M_X64)
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007 ||
+            !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (edx & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    static Calibration calibrate() {
+        using namespace std::chrono;
+        Calibration cal{};
+        cal.wall_anchor_ns = duration_cast<nanoseconds>(
+            system_clock::now().time_since_epoch()).count();
+        cal.steady_anchor = steady_clock::now();
+        cal.ns_per_tick = 1.0;
+        cal.use_tsc = invariant_tsc();
+#if defined(__x86_64__) || defined(_M_X64)
+        if (cal.use_tsc) {
+            cal.tsc_anchor = __rdtsc();
+            // ~5ms busy window keeps the ratio error well under 0.1%
+            const auto start = steady_clock::now();
+            while (steady_clock::now() - start < milliseconds(5)) {}
+            const uint64_t tsc_end = __rdtsc();
+            const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - cal.steady_anchor).count();
+            cal.ns_per_tick = static_cast<double>(elapsed) / static_cast<double>(tsc_end - cal.tsc_anchor);
+        }
+#endif
+        return cal;
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+// Integer tick/lot representation for prices and quantities.
+//
+// Doubles are converted once at the exchange boundary; inside the book, the
+// simulator and OrderManager's position and notional accounting, comparisons,
+// map keys and hashes are plain int64 operations. Order itself is unchanged
+// and still carries doubles. Price and Qty are distinct types so they cannot be mixed
+// up, and conversion always goes through the instrument's increment.
+template <class Tag>
+class Fixed {
+public:
+    constexpr Fixed() = default;
+    constexpr explicit Fixed(int64_t raw) : raw_(raw) {}
+    
+    constexpr int64_t raw() const { return raw_; }
+    
+    constexpr Fixed operator+(Fixed o) const { return Fixed(raw_ + o.raw_); }
+    constexpr Fixed operator-(Fixed o) const { return Fixed(raw_ - o.raw_); }
+    constexpr Fixed operator-() const { return Fixed(-raw_); }
+    constexpr Fixed& operator+=(Fixed o) { raw_ += o.raw_; return *this; }
+    constexpr Fixed& operator-=(Fixed o) { raw_ -= o.raw_; return *this; }
+    
+    constexpr bool operator==(Fixed o) const { return raw_ == o.raw_; }
+    constexpr bool operator!=(Fixed o) const { return raw_ != o.raw_; }
+    constexpr bool operator< (Fixed o) const { return raw_ <  o.raw_; }
+    constexpr bool operator<=(Fixed o) const { return raw_ <= o.raw_; }
+    constexpr bool operator> (Fixed o) const { return raw_ >  o.raw_; }
+    constexpr bool operator>=(Fixed o) const { return raw_ >= o.raw_; }
+
+private:
+    int64_t raw_{0};
+};
+
+struct PriceTag {};
+struct QtyTag {};
+
+using Price = Fixed<PriceTag>;  // Whole ticks
+using Qty = Fixed<QtyTag>;      // Whole lots
+
+namespace std {
+template <class Tag>
+struct hash<Fixed<Tag>> {
+    size_t operator()(Fixed<Tag> v) const noexcept { return std::hash<int64_t>{}(v.raw()); }
+};
+} // namespace std
+
+// Per-instrument increment chosen at runtime (tick size or lot size).
+//
+// Increments of the form 1/k (0.5, 0.01, 0.05, ...) are stored as the
+// integer k and converted back by division, which gives the correctly
+// rounded decimal (e.g. 12345 ticks of 0.01 -> 123.45 exactly as parsed);
+// multiplying by 0.01 would not. Other increments (5, 2.5) multiply.
+class TickSize {
+public:
+    explicit TickSize(double increment)
+        : increment_(increment) {
+        const double inverse = 1.0 / increment;
+        const double rounded = std::round(inverse);
+        if (rounded >= 1.0 && std::abs(inverse - rounded) < 1e-9 * rounded) {
+            scale_ = rounded;
+        }
+    }
+    
+    double increment() const { return increment_; }
+    
+    template <class T = Price>
+    T from_double(double value) const {
+        return T(std::llround(scale_ > 0.0 ? value * scale_ : value / increment_));
+    }
+    
+    template <class Tag>
+    double to_double(Fixed<Tag> value) const {
+        return scale_ > 0.0 ? static_cast<double>(value.raw()) / scale_
+                            : static_cast<double>(value.raw()) * increment_;
+    }
+
+private:
+    double increment_;
+    double scale_{0.0};  // 1/increment when that is an integer, else 0
+};
+
+// Compile-time increment Num/Den for instruments whose tick is known
+// statically; the conversions fold to a multiply/divide by constants.
+template <int64_t Num, int64_t Den>
+struct StaticTickSize {
+    static_assert(Num > 0 && Den > 0, "Increment must be positive");
+    static constexpr double increment = static_cast<double>(Num) / Den;
+    
+    template <class T = Price>
+    static T from_double(double value) {
+        return T(std::llround(value * Den / Num));
+    }
+    
+    template <class Tag>
+    static constexpr double to_double(Fixed<Tag> value) {
+        return static_cast<double>(value.raw() * Num) / Den;
+    }
+    
+    static TickSize runtime() { return TickSize(increment); }
+};
+
+using HalfTick = StaticTickSize<1, 2>;      // XBTUSD
+using CentTick = StaticTickSize<1, 100>;
+using NickelTick = StaticTickSize<1, 20>;   // ETHUSD
+using UnitTick = StaticTickSize<1, 1>;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "market_data.h"
+#include "fixed_point.h"
+
+class TickJournalWriter;
+
+// Incremental book for BitMEX orderBookL2 messages.
+//
+// Levels are indexed by exchange level ID, and each side keeps a sorted
+// tick -> lot map (integer keys, see fixed_point.h), so an insert/update/delete touches O(changed levels)
+// instead of rebuilding the book. The top MarketDepth::MAX_LEVELS are
+// published into a MarketDepth only when a change reaches them. The full
+// ladder stays available through get_levels() for impact models that need
+// more than MAX_LEVELS.
+//
+// Not thread-safe: owned by the feed thread. Other threads read the
+// published MarketDepth.
+class L2OrderBook {
+public:
+    enum class Action { PARTIAL, INSERT, UPDATE, DELETE };
+    
+    struct Entry {
+        int64_t id;
+        BookSide side;
+        Price price;    // Unused for UPDATE/DELETE; BitMEX omits it there
+        Qty size;
+    };
+    
+    struct PriceLevel {
+        double price;
+        double size;
+    };
+    
+    explicit L2OrderBook(TickSize tick_size = HalfTick::runtime(),
+                         TickSize lot_size = UnitTick::runtime())
+        : tick_size_(tick_size), lot_size_(lot_size) {}
+    
+    static Action parse_action(const std::string& action);
+    
+    // Converts exchange doubles into an Entry at this instrument's increments
+    Entry make_entry(int64_t id, BookSide side, double price, double size) const {
+        return {id, side, tick_size_.from_double<Price>(price), lot_size_.from_double<Qty>(size)};
+    }
+    
+    // Applies one message. Returns true if the top of book changed and was
+    // republished into depth.
+    bool apply(Action action, const Entry* entries, size_t count, MarketDepth& depth);
+    
+    // Best-first copy of up to n levels of one side
+    size_t get_levels(BookSide side, size_t n, std::vector<PriceLevel>& out) const;
+    
+    size_t level_count(BookSide side) const {
+        return side == BookSide::BID ? bids_.size() : asks_.size();
+    }
+    
+    void clear();
+    
+    // Every publish is also appended to the journal (not owned), if set
+    void set_journal(TickJournalWriter* journal) { journal_ = journal; }
+
+private:
+    struct LevelRef {
+        BookSide side;
+        Price price;
+    };
+    
+    TickSize tick_size_;
+    TickSize lot_size_;
+    
+    std::unordered_map<int64_t, LevelRef> levels_by_id_;
+    std::map<Price, Qty, std::greater<>> bids_;
+    std::map<Price, Qty> asks_;
+    
+    // Worst price currently published per side; a change at or better than
+    // this (or any change while the side is shallower than MAX_LEVELS)
+    // dirties the published top of book.
+    Price bid_boundary_;
+    Price ask_boundary_;
+    bool bids_full_{false};
+    bool asks_full_{false};
+    
+    TickJournalWriter* journal_{nullptr};
+    
+    void insert(const Entry& entry, bool& dirty);
+    void update(const Entry& entry, bool& dirty);
+    void erase(const Entry& entry, bool& dirty);
+    bool touches_top(BookSide side, Price price) const;
+    void publish(MarketDepth& depth);
+};
@@ -1,13 +1,40 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <type_traits>
 #include "stable_vector.h"
+#include "snapshot_ring.h"
+#include "spin_wait.h"
+#include "fast_clock.h"
+
+enum class BookSide { BID, ASK };
+
+struct LevelUpdate {
+    size_t level;
+    double price;
+    double quantity;
+};
 
 struct MarketDepth {
     struct Level {
-        double price;
-        double quantity;
-        std::atomic<int64_t> update_time;
+        double price{0.0};
+        double quantity{0.0};
+        std::atomic<int64_t> update_time{0};
+
+        Level() = default;
+        Level(const Level& other)
+            : price(other.price)
+            , quantity(other.quantity)
+            , update_time(other.update_time.load(std::memory_order_relaxed)) {}
+
+        Level& operator=(const Level& other) {
+            price = other.price;
+            quantity = other.quantity;
+            update_time.store(other.update_time.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+            return *this;
+        }
     };
     
     static constexpr size_t MAX_LEVELS = 20;
@@ -15,38 +42,107 @@ struct MarketDepth {
     std::array<Level, MAX_LEVELS> bids;
     std::atomic<int64_t> last_update{0};
     
+    // Seqlock version: odd while a writer is inside begin_update()/commit()
+    std::atomic<uint64_t> sequence{0};
+
+    MarketDepth() = default;
+    MarketDepth(const MarketDepth& other) {
+        other.read_consistent([this](const MarketDepth& src) { copy_levels(src); });
+    }
+
+    MarketDepth& operator=(const MarketDepth& other) {
+        if (this != &other) {
+            begin_update();
+            other.read_consistent([this](const MarketDepth& src) { copy_levels(src); });
+            commit();
+        }
+        return *this;
+    }
+    
+    // Writer side. A book shared between threads has exactly one writer, and
+    // every batch of update_ask()/update_bid() calls must sit between
+    // begin_update() and commit() so readers never observe a half-applied book.
+    void begin_update() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void commit() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
     void update_ask(size_t level, double price, double qty);
     void update_bid(size_t level, double price, double qty);
+    
+    // Batched form: every level gets the same timestamp (FastClock::now_ns()
+    // domain) and last_update is stored once per batch.
+    void apply_levels(BookSide side, const LevelUpdate* updates, size_t count, int64_t ts);
+
+    // Reader side. Runs fn(const MarketDepth&) until it completes without a
+    // writer intervening and returns its result; never takes a lock. fn may
+    // run more than once and must only read the book.
+    template <class F>
+    auto read_consistent(F&& fn) const -> std::invoke_result_t<F&, const MarketDepth&> {
+        using Result = std::invoke_result_t<F&, const MarketDepth&>;
+        for (;;) {
+            const uint64_t seq = sequence.load(std::memory_order_acquire);
+            if (seq & 1) {
+                cpu_relax();
+                continue;
+            }
+            if constexpr (std::is_void_v<Result>) {
+                fn(*this);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == seq) {
+                    return;
+                }
+            } else {
+                Result result = fn(*this);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == seq) {
+                    return result;
+                }
+            }
+        }
+    }
+
+    // Consistent copy of the whole book
+    MarketDepth snapshot() const { return MarketDepth(*this); }
+
     double get_mid_price() const;
     double get_spread() const;
+
+private:
+    void copy_levels(const MarketDepth& src) {
+        asks = src.asks;
+        bids = src.bids;
+        last_update.store(src.last_update.load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    }
 };
 
 class MarketDataBuffer {
 public:
+    using DepthView = SnapshotRing<MarketDepth>::View;
+
+    // Capacity is rounded up to the next power of two
     explicit MarketDataBuffer(size_t capacity = 1024)
-        : capacity_(capacity) {
-        depth_buffer_.reserve(capacity);
-    }
+        : depth_ring_(capacity) {}
     
+    // Feed thread only; never blocks on readers
     void push_depth(const MarketDepth& depth) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (depth_buffer_.size() >= capacity_) {
-            depth_buffer_.erase(depth_buffer_.begin());
-        }
-        depth_buffer_.push_back(depth);
+        depth_ring_.push(depth);
     }
     
-    stable_vector<MarketDepth> get_recent_depth(size_t n) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        size_t start = depth_buffer_.size() > n ? depth_buffer_.size() - n : 0;
-        return stable_vector<MarketDepth>(
-            depth_buffer_.begin() + start,
-            depth_buffer_.end()
-        );
+    // Wait-free from any thread. The view is not a copy: entries overwritten
+    // by the feed while it is being read are reported by DepthView::read().
+    DepthView get_recent_depth(size_t n) const {
+        return depth_ring_.recent(n);
     }
 
+    size_t size() const { return depth_ring_.size(); }
+    size_t capacity() const { return depth_ring_.capacity(); }
+
 private:
-    const size_t capacity_;
-    mutable std::mutex mutex_;
-    stable_vector<MarketDepth> depth_buffer_;
+    SnapshotRing<MarketDepth> depth_ring_;
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "market_data.h"
+
+// Per-symbol fan-out of immutable book snapshots.
+//
+// The feed publishes a MarketDepth once; the hub takes one consistent copy
+// into a reference-counted snapshot and hands the same pointer to every
+// subscriber (strategies, risk, recorders). Subscribers keep the snapshot
+// alive only as long as they hold it. Subscriber lists are copy-on-write, so
+// publishing never contends with readers of other symbols or with
+// subscribe()/unsubscribe() beyond one atomic shared_ptr load.
+class MarketDataHub {
+public:
+    using Snapshot = std::shared_ptr<const MarketDepth>;
+    using Subscriber = std::function<void(const std::string& symbol, const Snapshot& snapshot)>;
+    using SubscriptionId = uint64_t;
+    
+    class Channel {
+    public:
+        explicit Channel(std::string symbol) : symbol_(std::move(symbol)) {}
+        
+        const std::string& symbol() const { return symbol_; }
+        Snapshot latest() const { return std::atomic_load(&latest_); }
+        
+    private:
+        friend class MarketDataHub;
+        using SubscriberList = std::vector<std::pair<SubscriptionId, Subscriber>>;
+        
+        const std::string symbol_;
+        std::shared_ptr<const SubscriberList> subscribers_ = std::make_shared<SubscriberList>();
+        Snapshot latest_;
+        std::mutex write_mutex_;  // Serialises subscribe/unsubscribe only
+    };
+    
+    // Stable for the hub's lifetime; feed threads should resolve it once
+    // and publish through it to skip the symbol lookup.
+    Channel& channel(const std::string& symbol);
+    
+    SubscriptionId subscribe(const std::string& symbol, Subscriber subscriber);
+    void unsubscribe(SubscriptionId id);
+    
+    void publish(Channel& channel, const MarketDepth& depth);
+    void publish(const std::string& symbol, const MarketDepth& depth) {
+        publish(channel(symbol), depth);
+    }
+    
+    // Most recent snapshot, or nullptr if nothing was published yet
+    Snapshot latest(const std::string& symbol) const;
+
+private:
+    mutable std::shared_mutex channels_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Channel>> channels_;
+    std::unordered_map<SubscriptionId, Channel*> subscriptions_;
+    SubscriptionId next_subscription_id_{1};
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "cache_line.h"
+
+// Bounded lock-free multi-producer / single-consumer queue.
+//
+// Each slot carries a sequence number: a producer claims a position with one
+// CAS on the head, writes the value and publishes it by advancing the slot's
+// sequence; the consumer reads the slot once its sequence says it is full and
+// hands it back for the next lap. Producers never wait on each other past the
+// CAS and never on the consumer, so a full queue is reported instead of
+// blocking. Capacity is rounded up to a power of two and nothing allocates
+// after construction. T must be default-constructible and copyable.
+template <class T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity)
+        : capacity_(round_up_pow2(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(new Slot[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread. False if the queue is full.
+    bool try_push(const T& value) {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[pos & mask_];
+            const uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only. False if nothing has been published yet.
+    bool try_pop(T& out) {
+        Slot& slot = slots_[tail_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return false;
+        }
+        out = slot.value;
+        slot.sequence.store(tail_ + capacity_, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    // Consumer thread; approximate while producers are pushing
+    size_t size() const {
+        return static_cast<size_t>(head_.load(std::memory_order_acquire) - tail_);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> sequence{0};
+        T value{};
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    alignas(CACHE_LINE_SIZE) uint64_t tail_{0};  // Consumer-owned
+};
@@ -2,8 +2,13 @@
 
 #include <atomic>
 #include <memory>
-#include "stable_vector.h"
+#include <optional>
+#include <shared_mutex>
 #include "market_data.h"
+#include "fixed_point.h"
+#include "order_index.h"
+#include "slot_pool.h"
+#include "exposure_limiter.h"
 
 enum class OrderSide { BUY, SELL };
 enum class OrderStatus { NEW, PARTIALLY_FILLED, FILLED, CANCELLED, REJECTED };
@@ -31,30 +36,93 @@ public:
         double max_notional{10000.0};
         int max_active_orders{50};
         double min_spread{0.0001};
+        double tick_size{0.5};
+        double lot_size{1.0};
     };
     
-    explicit OrderManager(Config config) : config_(config) {}
+    explicit OrderManager(Config config)
+        : config_(config)
+        , tick_size_(config.tick_size)
+        , lot_size_(config.lot_size)
+        , max_position_(lot_size_.from_double<Qty>(config.max_position))
+        , max_order_size_(lot_size_.from_double<Qty>(config.max_order_size))
+        , exposure_(max_position_.raw(), std::llround(config.max_notional / notional_unit()))
+        , order_pool_(static_cast<size_t>(config.max_active_orders))
+        , order_index_(static_cast<size_t>(config.max_active_orders)) {}
     
-    // Thread-safe order operations
+    // Generation-tagged reference to a live order; goes stale once the order
+    // is cancelled or completes, even if its slot has been reused since
+    using OrderHandle = PoolHandle;
+    
+    // Thread-safe order operations. place_order reserves position and notional
+    // headroom before the order exists; fills convert it and cancels or
+    // terminal updates hand the unfilled remainder back. update_order applies
+    // fills and status only; price and quantity change through amend_order,
+    // which reserves the new remainder before handing the old one back.
     std::optional<Order> place_order(OrderSide side, double price, double quantity);
+    std::optional<Order> amend_order(int64_t order_id, double price, double quantity);
+    // Puts an order back to the price and quantity the exchange still holds
+    // after an amend it did not accept. Never refused: the order is resting.
+    bool restore_order(int64_t order_id, double price, double quantity);
     bool cancel_order(int64_t order_id);
+    bool cancel_order(OrderHandle handle);
+    // Drops every live order, for after the exchange cancelled them all;
+    // returns how many there were
+    size_t cancel_all_orders();
     void update_order(const Order& order);
+    // Books a fill for an order no longer in the store, one that was
+    // cancelled locally while the exchange was filling it
+    void apply_untracked_fill(OrderSide side, double quantity, double price);
+    
+    std::optional<Order> get_order(int64_t order_id) const;
+    std::optional<Order> get_order(OrderHandle handle) const;
+    OrderHandle find_handle(int64_t order_id) const;
+    int active_order_count() const { return active_count_.load(std::memory_order_acquire); }
     
     // Position management
-    double get_position() const { return position_.load(std::memory_order_acquire); }
-    double get_notional_exposure() const { return notional_exposure_.load(std::memory_order_acquire); }
+    double get_position() const {
+        return lot_size_.to_double(Qty(exposure_.position()));
+    }
+    // Open position cost plus reserved (resting) notional
+    double get_notional_exposure() const {
+        return exposure_.notional() * notional_unit();
+    }
     
-    // Risk checks
+    // Risk checks. Advisory only: headroom is not held, place_order re-checks
+    // atomically.
     bool check_risk_limits(OrderSide side, double quantity, double price) const;
     
 private:
     Config config_;
+    
+    // Prices and sizes are converted to ticks/lots once on entry; limits and
+    // exposure are kept in the same integer units
+    TickSize tick_size_;
+    TickSize lot_size_;
+    Qty max_position_;
+    Qty max_order_size_;
+    ExposureLimiter exposure_;  // Lots, ticks x lots
+    
     std::atomic<int64_t> next_order_id_{1};
-    std::atomic<double> position_{0.0};
-    std::atomic<double> notional_exposure_{0.0};
     
+    double notional_unit() const { return config_.tick_size * config_.lot_size; }
+    
+    // Live orders only: a slot is taken on place and handed back when the
+    // order is cancelled or reaches a terminal state, so every lookup is one
+    // index probe regardless of session length. Both structures are sized at
+    // construction and nothing on the order path allocates.
     mutable std::shared_mutex orders_mutex_;
-    stable_vector<Order> active_orders_;
+    SlotPool<Order> order_pool_;
+    OrderIndex order_index_;
+    std::atomic<int> active_count_{0};
+    
+    bool cancel_locked(OrderHandle handle);
+    void release_locked(OrderHandle handle);
+    
+    int64_t signed_lots(OrderSide side, double quantity) const {
+        const int64_t lots = lot_size_.from_double<Qty>(quantity).raw();
+        return side == OrderSide::BUY ? lots : -lots;
+    }
     
     int64_t generate_order_id() {
         return next_order_id_.fetch_add(1, std::memory_order_relaxed);
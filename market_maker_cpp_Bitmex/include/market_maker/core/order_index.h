@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Fixed-capacity open-addressing map from order_id to a packed pool handle.
+//
+// Linear probing over a power-of-two table sized to at least twice the number
+// of live entries, so probe chains stay short. Erase uses backward-shift
+// deletion instead of tombstones; the table never degrades no matter how many
+// ids have passed through it, and nothing allocates after construction.
+class OrderIndex {
+public:
+    static constexpr uint64_t NPOS = std::numeric_limits<uint64_t>::max();
+
+    explicit OrderIndex(size_t max_entries)
+        : capacity_(round_up_pow2(max_entries * 2))
+        , mask_(capacity_ - 1)
+        , max_entries_(max_entries)
+        , entries_(capacity_) {}
+
+    // False if the key is already present or the index is at max_entries
+    bool insert(int64_t key, uint64_t value) {
+        if (size_ >= max_entries_) {
+            return false;
+        }
+        size_t i = home(key);
+        while (entries_[i].key != EMPTY_KEY) {
+            if (entries_[i].key == key) {
+                return false;
+            }
+            i = (i + 1) & mask_;
+        }
+        entries_[i] = {key, value};
+        ++size_;
+        return true;
+    }
+
+    uint64_t find(int64_t key) const {
+        for (size_t i = home(key); entries_[i].key != EMPTY_KEY; i = (i + 1) & mask_) {
+            if (entries_[i].key == key) {
+                return entries_[i].value;
+            }
+        }
+        return NPOS;
+    }
+
+    bool erase(int64_t key) {
+        size_t i = home(key);
+        while (entries_[i].key != key) {
+            if (entries_[i].key == EMPTY_KEY) {
+                return false;
+            }
+            i = (i + 1) & mask_;
+        }
+
+        // Pull later members of the probe chain back into the hole so lookups
+        // can keep stopping at the first empty slot
+        for (size_t j = (i + 1) & mask_; entries_[j].key != EMPTY_KEY; j = (j + 1) & mask_) {
+            const size_t h = home(entries_[j].key);
+            const bool movable = i <= j ? (h <= i || h > j) : (h <= i && h > j);
+            if (movable) {
+                entries_[i] = entries_[j];
+                i = j;
+            }
+        }
+        entries_[i] = Entry{};
+        --size_;
+        return true;
+    }
+
+    void clear() {
+        for (auto& e : entries_) {
+            e = Entry{};
+        }
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return max_entries_; }
+
+private:
+    static constexpr int64_t EMPTY_KEY = std::numeric_limits<int64_t>::min();
+
+    struct Entry {
+        int64_t key{EMPTY_KEY};
+        uint64_t value{NPOS};
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t cap = 2;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    // Fibonacci hashing; sequential ids spread across the table
+    size_t home(int64_t key) const {
+        return static_cast<size_t>(
+            (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+    }
+
+    size_t capacity_;
+    size_t mask_;
+    size_t max_entries_;
+    size_t size_{0};
+    std::vector<Entry> entries_;
+};
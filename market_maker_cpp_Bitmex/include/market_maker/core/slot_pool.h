@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include "cache_line.h"
+
+// Handle to a SlotPool entry. The generation is odd while the slot is live and
+// bumped on every acquire and release, so a handle kept past release() no
+// longer resolves even after the slot has been reused.
+struct PoolHandle {
+    uint32_t index{std::numeric_limits<uint32_t>::max()};
+    uint32_t generation{0};
+
+    bool valid() const { return index != std::numeric_limits<uint32_t>::max(); }
+
+    uint64_t pack() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+    static PoolHandle unpack(uint64_t packed) {
+        return {static_cast<uint32_t>(packed), static_cast<uint32_t>(packed >> 32)};
+    }
+
+    bool operator==(const PoolHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const PoolHandle& other) const { return !(*this == other); }
+};
+
+// Fixed-capacity pool of T, one cache line (or more) per slot so neighbouring
+// entries never share a line. Free slots are chained through an intrusive
+// next index; acquire/release are a couple of loads and stores and never
+// touch the heap after construction. Not thread-safe: callers serialise.
+template <class T>
+class SlotPool {
+public:
+    explicit SlotPool(size_t capacity)
+        : capacity_(static_cast<uint32_t>(capacity))
+        , slots_(std::make_unique<Slot[]>(capacity)) {
+        for (uint32_t i = 0; i < capacity_; ++i) {
+            slots_[i].next_free = i + 1 < capacity_ ? i + 1 : NIL;
+        }
+        free_head_ = capacity_ > 0 ? 0 : NIL;
+    }
+
+    SlotPool(const SlotPool&) = delete;
+    SlotPool& operator=(const SlotPool&) = delete;
+
+    // Invalid handle when the pool is exhausted
+    PoolHandle acquire() {
+        if (free_head_ == NIL) {
+            return PoolHandle{};
+        }
+        const uint32_t index = free_head_;
+        Slot& slot = slots_[index];
+        free_head_ = slot.next_free;
+        slot.next_free = NIL;
+        ++slot.generation;
+        ++size_;
+        return {index, slot.generation};
+    }
+
+    // False for stale or invalid handles; the slot is left untouched
+    bool release(PoolHandle handle) {
+        if (get(handle) == nullptr) {
+            return false;
+        }
+        Slot& slot = slots_[handle.index];
+        ++slot.generation;
+        slot.next_free = free_head_;
+        free_head_ = handle.index;
+        --size_;
+        return true;
+    }
+
+    T* get(PoolHandle handle) {
+        if (handle.index >= capacity_ || slots_[handle.index].generation != handle.generation ||
+            (handle.generation & 1u) == 0) {
+            return nullptr;
+        }
+        return &slots_[handle.index].value;
+    }
+
+    const T* get(PoolHandle handle) const {
+        return const_cast<SlotPool*>(this)->get(handle);
+    }
+
+    // Calls visit(handle) for every live slot in index order; visit may
+    // release the slot it is handed
+    template <class Visit>
+    void for_each(Visit&& visit) {
+        for (uint32_t i = 0; i < capacity_; ++i) {
+            if ((slots_[i].generation & 1u) != 0) {
+                visit(PoolHandle{i, slots_[i].generation});
+            }
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool full() const { return free_head_ == NIL; }
+
+private:
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        T value{};
+        uint32_t generation{0};
+        uint32_t next_free{NIL};
+    };
+
+    uint32_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    uint32_t free_head_{NIL};
+    size_t size_{0};
+};
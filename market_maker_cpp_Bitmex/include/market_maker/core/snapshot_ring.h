@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "cache_line.h"
+
+// Fixed-capacity ring of snapshots with one writer and any number of readers.
+//
+// The writer never waits: once the ring is full the oldest entry is evicted in
+// O(1) by advancing tail_. Readers never take a lock either; every slot carries
+// a sequence number (odd while being written) so a reader can tell whether the
+// entry it visited was overwritten underneath it and simply drop that entry.
+template <class T>
+class SnapshotRing {
+public:
+    explicit SnapshotRing(size_t capacity)
+        : capacity_(round_up_pow2(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(std::make_unique<Slot[]>(capacity_)) {}
+
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+
+    // Single producer only.
+    void push(const T& value) {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (head - tail >= capacity_) {
+            // Publish the eviction before the slot is reused
+            tail_.store(tail + 1, std::memory_order_release);
+        }
+
+        Slot& slot = slots_[head & mask_];
+        slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.value = value;
+        slot.sequence.store(2 * head + 2, std::memory_order_release);
+
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Read-only window over [first, last) absolute positions. Entries may be
+    // evicted while the view is alive; read() reports that instead of blocking.
+    class View {
+    public:
+        View() = default;
+
+        size_t size() const { return static_cast<size_t>(last_ - first_); }
+        bool empty() const { return first_ == last_; }
+
+        // Invokes fn(const T&) on entry i (0 = oldest in the view). Returns
+        // false if the entry was overwritten before or during the visit, in
+        // which case anything fn observed must be discarded.
+        template <class F>
+        bool read(size_t i, F&& fn) const {
+            return ring_->visit(first_ + i, std::forward<F>(fn));
+        }
+
+        bool copy(size_t i, T& out) const {
+            return read(i, [&out](const T& value) { out = value; });
+        }
+
+        // Visits every entry still intact, oldest first. Returns the number
+        // of entries delivered.
+        template <class F>
+        size_t for_each(F&& fn) const {
+            size_t delivered = 0;
+            for (uint64_t pos = first_; pos < last_; ++pos) {
+                if (ring_->visit(pos, fn)) {
+                    ++delivered;
+                }
+            }
+            return delivered;
+        }
+
+    private:
+        friend class SnapshotRing;
+
+        View(const SnapshotRing* ring, uint64_t first, uint64_t last)
+            : ring_(ring), first_(first), last_(last) {}
+
+        const SnapshotRing* ring_{nullptr};
+        uint64_t first_{0};
+        uint64_t last_{0};
+    };
+
+    // Wait-free; no copies are made until the caller reads an entry.
+    View recent(size_t n) const {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        const uint64_t available = head - tail;
+        const uint64_t count = n < available ? n : available;
+        return View(this, head - count, head);
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(
+            head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> sequence{0};
+        T value{};
+    };
+
+    template <class F>
+    bool visit(uint64_t pos, F&& fn) const {
+        const Slot& slot = slots_[pos & mask_];
+        const uint64_t expected = 2 * pos + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+        fn(slot.value);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == expected;
+    }
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+};
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+#include <boost/operators.hpp>
+
+#include "stable_vector.h"
+
+// Bounded FIFO window over the same chunked storage as stable_vector.
+//
+// Elements live in fixed-size chunks that are allocated on first use and then
+// reused forever, so a full ring never allocates, pop_front() is O(1) and an
+// element's address does not change until it is evicted. Pushing into a full
+// ring evicts the oldest element, which is what rolling windows want.
+template <class T, std::size_t ChunkSize = 1024>
+class stable_ring
+{
+public:
+	using value_type = T;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+
+	static constexpr const std::size_t chunk_size = ChunkSize;
+
+private:
+	template <std::size_t N>
+	struct is_pow2 { static constexpr bool value = (N & (N - 1)) == 0; };
+
+	static_assert(is_pow2<ChunkSize>::value, "ChunkSize needs to be a power of 2");
+
+	using __self = stable_ring<T, ChunkSize>;
+	using __const_self = const stable_ring<T, ChunkSize>;
+
+	template <class Container>
+	struct iterator_base
+	{
+		iterator_base(Container* c = nullptr, size_type i = 0) :
+			m_container(c),
+			m_index(i)
+		{}
+
+		iterator_base& operator+=(size_type i) { m_index += i; return *this; }
+		iterator_base& operator-=(size_type i) { m_index -= i; return *this; }
+		iterator_base& operator++()            { ++m_index; return *this; }
+		iterator_base& operator--()            { --m_index; return *this; }
+
+		difference_type operator-(const iterator_base& it) { assert(m_container == it.m_container); return m_index - it.m_index; }
+
+		bool operator< (const iterator_base& it) const { assert(m_container == it.m_container); return m_index < it.m_index; }
+		bool operator==(const iterator_base& it) const { return m_container == it.m_container && m_index == it.m_index; }
+
+	 protected:
+		Container* m_container;
+		size_type m_index;
+	};
+
+public:
+	struct const_iterator;
+
+	struct iterator :
+		public iterator_base<__self>,
+		public boost::random_access_iterator_helper<iterator, value_type>
+	{
+		using iterator_base<__self>::iterator_base;
+		friend struct const_iterator;
+
+		reference operator*() { return (*this->m_container)[this->m_index]; }
+	};
+
+	struct const_iterator :
+		public iterator_base<__const_self>,
+		public boost::random_access_iterator_helper<const_iterator, const value_type>
+	{
+		using iterator_base<__const_self>::iterator_base;
+
+		const_iterator(const iterator& it) :
+			iterator_base<__const_self>(it.m_container, it.m_index)
+		{
+		}
+
+		const_reference operator*() const { return (*this->m_container)[this->m_index]; }
+
+		bool operator==(const const_iterator& it) const
+		{
+			return iterator_base<__const_self>::operator==(it);
+		}
+
+		friend bool operator==(const iterator& l, const const_iterator& r) { return r == l; }
+	};
+
+	explicit stable_ring(size_type max_size);
+
+	stable_ring(const stable_ring& other);
+	stable_ring(stable_ring&& other) noexcept;
+
+	stable_ring& operator=(stable_ring v);
+
+	~stable_ring() { clear(); }
+
+	iterator begin() noexcept { return {this, 0}; }
+	const_iterator begin() const noexcept { return {this, 0}; }
+	const_iterator cbegin() const noexcept { return begin(); }
+
+	iterator end() noexcept { return {this, size()}; }
+	const_iterator end() const noexcept { return {this, size()}; }
+	const_iterator cend() const noexcept { return end(); }
+
+	size_type size() const noexcept { return m_size; }
+	size_type max_size() const noexcept { return m_max_size; }
+	size_type capacity() const noexcept { return m_chunks.size() * ChunkSize; }
+
+	bool empty() const noexcept { return m_size == 0; }
+	bool full() const noexcept { return m_size == m_max_size; }
+
+	void swap(__self& v) noexcept
+	{
+		std::swap(m_chunks, v.m_chunks);
+		std::swap(m_max_size, v.m_max_size);
+		std::swap(m_head, v.m_head);
+		std::swap(m_size, v.m_size);
+	}
+
+	friend void swap(__self& l, __self& r) noexcept { l.swap(r); }
+
+	reference front()             { return operator[](0); }
+	const_reference front() const { return operator[](0); }
+
+	reference back()             { return operator[](m_size - 1); }
+	const_reference back() const { return operator[](m_size - 1); }
+
+	// Evicts the front element first when the ring is full
+	void push_back(const T& t) { emplace_back(t); }
+	void push_back(T&& t) { emplace_back(std::move(t)); }
+
+	template <class... Args>
+	reference emplace_back(Args&&... args);
+
+	void pop_front();
+	void clear() noexcept;
+
+	reference operator[](size_type i) { return *slot(physical(i)); }
+	const_reference operator[](size_type i) const { return const_cast<__self&>(*this)[i]; }
+
+	reference at(size_type i);
+	const_reference at(size_type i) const;
+
+	// Calls fn(const T* data, size_type count) once per contiguous segment
+	// (one per chunk touched), oldest first, so hot loops can vectorise
+	// instead of going through operator[].
+	template <class F>
+	void for_each_segment(F&& fn) const;
+
+private:
+	using chunk_type = std::aligned_storage_t<sizeof(T) * ChunkSize, alignof(T)>;
+	using storage_type = std::vector<std::unique_ptr<chunk_type>>;
+
+	size_type physical(size_type i) const noexcept
+	{
+		size_type p = m_head + i;
+		const size_type slots = capacity();
+		return p >= slots ? p - slots : p;
+	}
+
+	pointer slot(size_type p) noexcept
+	{
+		return reinterpret_cast<pointer>(m_chunks[p / ChunkSize].get()) + (p % ChunkSize);
+	}
+
+	const_pointer slot(size_type p) const noexcept
+	{
+		return const_cast<__self&>(*this).slot(p);
+	}
+
+	storage_type m_chunks;
+	size_type m_max_size;
+	size_type m_head = 0;
+	size_type m_size = 0;
+};
+
+
+
+
+
+
+
+template <class T, std::size_t ChunkSize>
+stable_ring<T, ChunkSize>::stable_ring(size_type max_size) :
+	m_chunks((std::max<size_type>(max_size, 1) + ChunkSize - 1) / ChunkSize),
+	m_max_size(std::max<size_type>(max_size, 1))
+{
+}
+
+template <class T, std::size_t ChunkSize>
+stable_ring<T, ChunkSize>::stable_ring(const stable_ring& other) :
+	stable_ring(other.m_max_size)
+{
+	for (const auto& t : other)
+	{
+		push_back(t);
+	}
+}
+
+template <class T, std::size_t ChunkSize>
+stable_ring<T, ChunkSize>::stable_ring(stable_ring&& other) noexcept :
+	m_chunks(std::move(other.m_chunks)),
+	m_max_size(other.m_max_size),
+	m_head(other.m_head),
+	m_size(other.m_size)
+{
+	other.m_head = 0;
+	other.m_size = 0;
+}
+
+template <class T, std::size_t ChunkSize>
+stable_ring<T, ChunkSize>& stable_ring<T, ChunkSize>::operator=(stable_ring v)
+{
+	swap(v);
+	return *this;
+}
+
+template <class T, std::size_t ChunkSize>
+template <class... Args>
+typename stable_ring<T, ChunkSize>::reference
+stable_ring<T, ChunkSize>::emplace_back(Args&&... args)
+{
+	if (likely_false(m_size == m_max_size))
+	{
+		pop_front();
+	}
+
+	const size_type p = physical(m_size);
+	auto& chunk = m_chunks[p / ChunkSize];
+	if (likely_false(!chunk))
+	{
+		chunk = std::make_unique<chunk_type>();
+	}
+
+	pointer element = slot(p);
+	::new (static_cast<void*>(element)) T(std::forward<Args>(args)...);
+	++m_size;
+	return *element;
+}
+
+template <class T, std::size_t ChunkSize>
+void stable_ring<T, ChunkSize>::pop_front()
+{
+	assert(m_size > 0);
+	slot(m_head)->~T();
+	m_head = physical(1);
+	--m_size;
+}
+
+template <class T, std::size_t ChunkSize>
+void stable_ring<T, ChunkSize>::clear() noexcept
+{
+	if (!std::is_trivially_destructible<T>::value)
+	{
+		for (size_type i = 0; i < m_size; ++i)
+		{
+			slot(physical(i))->~T();
+		}
+	}
+	m_head = 0;
+	m_size = 0;
+}
+
+template <class T, std::size_t ChunkSize>
+typename stable_ring<T, ChunkSize>::reference
+stable_ring<T, ChunkSize>::at(size_type i)
+{
+	if (likely_false(i >= size()))
+	{
+		throw std::out_of_range("stable_ring::at");
+	}
+
+	return operator[](i);
+}
+
+template <class T, std::size_t ChunkSize>
+typename stable_ring<T, ChunkSize>::const_reference
+stable_ring<T, ChunkSize>::at(size_type i) const
+{
+	return const_cast<__self&>(*this).at(i);
+}
+
+template <class T, std::size_t ChunkSize>
+template <class F>
+void stable_ring<T, ChunkSize>::for_each_segment(F&& fn) const
+{
+	size_type i = 0;
+	while (i < m_size)
+	{
+		const size_type p = physical(i);
+		const size_type in_chunk = ChunkSize - (p % ChunkSize);
+		const size_type to_wrap = capacity() - p;
+		const size_type count = std::min({in_chunk, to_wrap, m_size - i});
+		fn(slot(p), count);
+		i += count;
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "market_data.h"
+
+// Append-only binary journal of book updates and trades.
+//
+// Layout: one 64-byte JournalHeader followed by fixed 32-byte JournalRecords
+// in timestamp order. The writer appends into an mmap'd region that is grown
+// in large steps, so an append is a couple of stores. Every INDEX_STRIDE-th
+// record is also noted in a sidecar "<path>.idx" file of (timestamp, record)
+// pairs, which lets the reader seek a time range in O(log n) without touching
+// the bulk of the file.
+
+inline constexpr uint32_t TICK_JOURNAL_SCHEMA_VERSION = 1;
+
+struct JournalHeader {
+    char magic[8];              // "MMTICKJ\0"
+    uint32_t schema_version;
+    uint32_t record_size;
+    char symbol[16];
+    double tick_size;
+    uint64_t record_count;      // Updated in place on every append
+    uint32_t index_stride;
+    uint8_t reserved[12];
+};
+static_assert(sizeof(JournalHeader) == 64, "JournalHeader must stay 64 bytes");
+
+struct JournalRecord {
+    enum Type : uint8_t { BOOK_LEVEL = 0, TRADE = 1 };
+    enum Flags : uint8_t { NONE = 0, END_OF_UPDATE = 1 };
+    
+    int64_t timestamp_ns;
+    uint8_t type;
+    uint8_t side;               // BookSide; for trades the aggressor side
+    uint8_t flags;
+    uint8_t reserved;
+    uint32_t level;             // Book level index, unused for trades
+    double price;
+    double quantity;
+};
+static_assert(sizeof(JournalRecord) == 32, "JournalRecord must stay 32 bytes");
+
+struct JournalIndexEntry {
+    int64_t timestamp_ns;
+    uint64_t record;
+};
+
+// Owning file descriptor and mapping, so a constructor that throws part way
+// through still closes and unmaps what it already had
+class JournalFd {
+public:
+    JournalFd() = default;
+    explicit JournalFd(int fd) : fd_(fd) {}
+    ~JournalFd();
+    
+    JournalFd(const JournalFd&) = delete;
+    JournalFd& operator=(const JournalFd&) = delete;
+    
+    int get() const { return fd_; }
+    void reset(int fd = -1);
+
+private:
+    int fd_{-1};
+};
+
+class JournalMapping {
+public:
+    JournalMapping() = default;
+    ~JournalMapping() { reset(); }
+    
+    JournalMapping(const JournalMapping&) = delete;
+    JournalMapping& operator=(const JournalMapping&) = delete;
+    
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    void reset(void* data = nullptr, size_t size = 0);
+
+private:
+    uint8_t* data_{nullptr};
+    size_t size_{0};
+};
+
+class TickJournalWriter {
+public:
+    static constexpr uint32_t INDEX_STRIDE = 1024;
+    
+    // Creates the journal, or reopens it for appending if it already exists
+    // with a matching schema and symbol.
+    TickJournalWriter(const std::string& path, const std::string& symbol, double tick_size);
+    ~TickJournalWriter();
+    
+    TickJournalWriter(const TickJournalWriter&) = delete;
+    TickJournalWriter& operator=(const TickJournalWriter&) = delete;
+    
+    // Single writer (the feed thread). The last record of one book update
+    // should carry end_of_update so replay knows when the book is whole.
+    void append_book(int64_t ts, BookSide side, const LevelUpdate* updates, size_t count,
+                     bool end_of_update);
+    void append_trade(int64_t ts, BookSide aggressor, double price, double quantity);
+    void append(const JournalRecord& record);
+    
+    // Schedules write-back of dirty pages without blocking
+    void flush();
+    
+    uint64_t record_count() const { return header_->record_count; }
+
+private:
+    static constexpr size_t GROW_BYTES = 64ull << 20;
+    
+    std::string path_;
+    JournalFd fd_;
+    JournalMapping mapping_;
+    std::FILE* index_file_{nullptr};
+    JournalHeader* header_{nullptr};
+    
+    void grow(size_t min_bytes);
+    JournalRecord* records() { return reinterpret_cast<JournalRecord*>(mapping_.data() + sizeof(JournalHeader)); }
+};
+
+class TickJournalReader {
+public:
+    explicit TickJournalReader(const std::string& path);
+    
+    TickJournalReader(const TickJournalReader&) = delete;
+    TickJournalReader& operator=(const TickJournalReader&) = delete;
+    
+    struct Range {
+        const JournalRecord* first;
+        const JournalRecord* last;
+        
+        const JournalRecord* begin() const { return first; }
+        const JournalRecord* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+    
+    const JournalHeader& header() const { return *header_; }
+    size_t size() const { return count_; }
+    Range all() const { return {records_, records_ + count_}; }
+    
+    // Records with from_ns <= timestamp < to_ns, straight out of the mapping
+    Range range(int64_t from_ns, int64_t to_ns) const;
+    
+    // Index of the first record with timestamp >= ts
+    size_t seek(int64_t ts) const;
+
+private:
+    JournalFd fd_;
+    JournalMapping mapping_;
+    const JournalHeader* header_{nullptr};
+    const JournalRecord* records_{nullptr};
+    size_t count_{0};
+    
+    JournalFd index_fd_;
+    JournalMapping index_mapping_;
+    const JournalIndexEntry* index_{nullptr};
+    size_t index_count_{0};
+};
+
+// Rebuilds successive books from a journal range, one per END_OF_UPDATE.
+// Trades are skipped here; the caller can walk the range for them.
+class TickJournalReplay {
+public:
+    explicit TickJournalReplay(TickJournalReader::Range range)
+        : cursor_(range.first), last_(range.last) {}
+    
+    // Applies the next whole update to depth; false once the range is exhausted
+    bool next(MarketDepth& depth);
+
+private:
+    const JournalRecord* cursor_;
+    const JournalRecord* last_;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "slot_pool.h"
+
+// Hashed timer wheel: `slots` buckets of `tick_ns` each, timers hashed by
+// their deadline tick. Timers further out than one revolution share a bucket
+// with nearer ones and are skipped until their own tick comes round, so
+// schedule and cancel are O(1) and advance costs one bucket walk per elapsed
+// tick, regardless of how many timers are pending.
+//
+// Timers live in a fixed SlotPool chained into per-bucket doubly linked
+// lists; nothing touches the heap after construction. Deadlines are rounded
+// up to the next tick. Not thread-safe: one thread owns the wheel.
+template <class T>
+class TimerWheel {
+public:
+    using TimerId = PoolHandle;
+
+    // `slots` is rounded up to a power of two
+    TimerWheel(size_t slots, int64_t tick_ns, size_t capacity, int64_t now_ns)
+        : tick_ns_(tick_ns)
+        , mask_(round_up_pow2(slots) - 1)
+        , buckets_(mask_ + 1)
+        , timers_(capacity)
+        , current_tick_(now_ns / tick_ns) {}
+
+    // Invalid id when the wheel is at capacity
+    TimerId schedule(int64_t deadline_ns, T payload) {
+        const TimerId id = timers_.acquire();
+        if (!id.valid()) {
+            return id;
+        }
+        Timer& timer = *timers_.get(id);
+        timer.payload = std::move(payload);
+        // Never behind the tick being processed, so a timer scheduled from
+        // a callback cannot land in an already-visited bucket
+        timer.deadline_tick = std::max((deadline_ns + tick_ns_ - 1) / tick_ns_, current_tick_ + 1);
+        link(id, timer);
+        return id;
+    }
+
+    // False if the timer already fired or was cancelled
+    bool cancel(TimerId id) {
+        Timer* timer = timers_.get(id);
+        if (timer == nullptr) {
+            return false;
+        }
+        unlink(*timer);
+        timer->payload = T{};
+        return timers_.release(id);
+    }
+
+    // Fires every timer due at or before `now_ns`, passing its payload by
+    // rvalue. After a gap longer than one revolution the overdue timers are
+    // fired in bucket order rather than strictly by deadline.
+    template <class Fire>
+    size_t advance(int64_t now_ns, Fire&& fire) {
+        const int64_t now_tick = now_ns / tick_ns_;
+        const int64_t first = std::max(current_tick_ + 1, now_tick - static_cast<int64_t>(mask_));
+        size_t fired = 0;
+        for (int64_t tick = first; tick <= now_tick; ++tick) {
+            current_tick_ = tick;
+            TimerId id = buckets_[tick & mask_];
+            while (id.valid()) {
+                Timer& timer = *timers_.get(id);
+                TimerId next = timer.next;
+                if (timer.deadline_tick <= tick) {
+                    unlink(timer);
+                    T payload = std::move(timer.payload);
+                    timer.payload = T{};
+                    timers_.release(id);
+                    fire(std::move(payload));
+                    ++fired;
+                    // The callback may have cancelled the next timer
+                    if (next.valid() && timers_.get(next) == nullptr) {
+                        next = buckets_[tick & mask_];
+                    }
+                }
+                id = next;
+            }
+        }
+        current_tick_ = std::max(current_tick_, now_tick);
+        return fired;
+    }
+
+    // Start of the next tick; no timer can fire before it
+    int64_t next_tick_ns() const { return (current_tick_ + 1) * tick_ns_; }
+
+    // Start of the tick the earliest pending timer fires on, or INT64_MAX
+    // when none is pending. Walks at most one revolution of buckets, so an
+    // owner can sleep until it instead of waking every tick.
+    int64_t next_deadline_ns() const {
+        int64_t earliest = std::numeric_limits<int64_t>::max();
+        if (empty()) {
+            return earliest;
+        }
+        for (int64_t tick = current_tick_ + 1; tick <= current_tick_ + 1 + static_cast<int64_t>(mask_); ++tick) {
+            for (TimerId id = buckets_[tick & mask_]; id.valid(); id = timers_.get(id)->next) {
+                const int64_t due = timers_.get(id)->deadline_tick;
+                if (due == tick) {
+                    return tick * tick_ns_;
+                }
+                earliest = std::min(earliest, due);
+            }
+        }
+        return earliest * tick_ns_;
+    }
+
+    size_t size() const { return timers_.size(); }
+    bool empty() const { return timers_.size() == 0; }
+    bool full() const { return timers_.full(); }
+
+private:
+    struct Timer {
+        T payload{};
+        int64_t deadline_tick{0};
+        TimerId prev;
+        TimerId next;
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    void link(TimerId id, Timer& timer) {
+        TimerId& head = buckets_[timer.deadline_tick & mask_];
+        timer.prev = TimerId{};
+        timer.next = head;
+        if (head.valid()) {
+            timers_.get(head)->prev = id;
+        }
+        head = id;
+    }
+
+    void unlink(Timer& timer) {
+        if (timer.prev.valid()) {
+            timers_.get(timer.prev)->next = timer.next;
+        } else {
+            buckets_[timer.deadline_tick & mask_] = timer.next;
+        }
+        if (timer.next.valid()) {
+            timers_.get(timer.next)->prev = timer.prev;
+        }
+        timer.prev = timer.next = TimerId{};
+    }
+
+    int64_t tick_ns_;
+    size_t mask_;
+    std::vector<TimerId> buckets_;
+    SlotPool<Timer> timers_;
+    int64_t current_tick_;
+};
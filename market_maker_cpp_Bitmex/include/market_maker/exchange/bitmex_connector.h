@@ -1,11 +1,45 @@
 #pragma once
 
-#include <pybind11/pybind11.h>
-#include <pybind11/stl.h>
+#include <optional>
+#include <nlohmann/json.hpp>
 #include "market_data.h"
+#include "l2_order_book.h"
+#include "tick_journal.h"
 #include "order_manager.h"
+#include "bitmex_rest_client.h"
+#include "rest_connection_pool.h"
+#include "bitmex_ws_client.h"
+#include "bitmex_frame_parser.h"
+#include "rate_limiter.h"
+#include "execution_reconciler.h"
+#include "snapshot_ring.h"
+#include "order_id_map.h"
+#include "order_template.h"
 
-namespace py = pybind11;
+// Order actions produced within one tick, sent as at most one request per
+// action kind (bulk endpoints cannot mix places, amends and cancels)
+struct OrderBatch {
+    std::vector<Order> places;
+    std::vector<Order> amends;
+    std::vector<int64_t> cancels;
+
+    bool empty() const { return places.empty() && amends.empty() && cancels.empty(); }
+    void clear() {
+        places.clear();
+        amends.clear();
+        cancels.clear();
+    }
+};
+
+// What send_batch got accepted, per stage; each is true when its stage was
+// empty. The stages are independent, so any mix can fail.
+struct BatchResult {
+    bool cancels{false};
+    bool amends{false};
+    bool places{false};
+
+    bool ok() const { return cancels && amends && places; }
+};
 
 class BitMEXConnector {
 public:
@@ -18,20 +52,89 @@ public:
         bool should_ws_auth = true;
         bool post_only = false;
         int timeout = 7;
+        std::string ws_url;       // Empty: derived from base_url
+        double tick_size = 0.5;   // Instrument increments, for the fixed-point book
+        double lot_size = 1.0;
+        RateLimiter::Config rate_limit;
+        size_t max_tracked_orders = 4096;  // Live orders whose exchange id is remembered
+        size_t rest_connections = 4;       // Keep-alive connections for parallel requests
     };
 
     explicit BitMEXConnector(const Config& config);
     ~BitMEXConnector();
 
+    const Config& config() const { return config_; }
+
     // Market data methods
     MarketDepth get_order_book();
     void subscribe_market_data(const std::function<void(const MarketDepth&)>& callback);
+    
+    // Book updated in place by the feed thread; read it via read_consistent()
+    std::shared_ptr<const MarketDepth> get_live_depth() const { return live_depth_; }
+    
+    // Full-depth ladder; feed thread only (e.g. from the market data callback)
+    const L2OrderBook& get_l2_book() const { return l2_book_; }
+    
+    // Records every published book update and public trade for later
+    // replay; set before subscribing
+    void set_journal(std::shared_ptr<TickJournalWriter> journal) {
+        journal_ = std::move(journal);
+        l2_book_.set_journal(journal_.get());
+    }
 
-    // Order management
-    bool place_order(const Order& order);
+    // Order management. `reply`, when given, receives the raw response so a
+    // caller can tell a refusal from a request that may have gone through;
+    // a request refused before sending reports unsent.
+    bool place_order(const Order& order, BitMEXRestClient::Response* reply = nullptr);
     bool cancel_order(int64_t order_id);
     bool amend_order(const Order& order);
     
+    // Bulk variants: one request for the whole array, no request when empty
+    bool place_orders(const Order* orders, size_t count,
+                      BitMEXRestClient::Response* reply = nullptr);
+    bool amend_orders(const Order* orders, size_t count,
+                      BitMEXRestClient::Response* reply = nullptr);
+    bool cancel_orders(const int64_t* order_ids, size_t count,
+                       BitMEXRestClient::Response* reply = nullptr);
+    
+    // Whether the exchange knows an order by this id's clOrdID, in any
+    // state; settles a place whose outcome a timeout left unknown. nullopt
+    // if the query itself failed.
+    std::optional<bool> has_order(int64_t order_id);
+    
+    // Cancels, amends and places go out together, one bulk request each on
+    // separate pooled connections, and this returns once all three answered.
+    // A place or amend refused for margin a concurrent cancel was about to
+    // free is simply undone by QuoteManager::settle and retried next tick.
+    BatchResult send_batch(const OrderBatch& batch);
+    
+    // Non-blocking variants: the request goes out on the least-loaded pooled
+    // connection (cancels ahead of queued places and amends) and `done`
+    // runs with the reply on that connection's thread, or straight away
+    // with an unsent reply if the request was refused locally. Independent
+    // orders sent this way are in flight together, so a refresh costs about
+    // one round trip.
+    using Completion = std::function<void(const BitMEXRestClient::Response& reply)>;
+    void place_order_async(const Order& order, Completion done);
+    void amend_order_async(const Order& order, Completion done);
+    void cancel_order_async(int64_t order_id, Completion done);
+    // has_order() without waiting; `done` gets what has_order would return
+    void has_order_async(int64_t order_id, std::function<void(std::optional<bool>)> done);
+    size_t requests_in_flight() const { return rest_.in_flight(); }
+    
+    // Every open order of the account, all symbols, in one request
+    bool cancel_all_orders();
+    // Exchange-side dead man's switch: unless called again within `timeout`,
+    // the exchange cancels every open order. Zero disarms it.
+    bool cancel_all_after(std::chrono::milliseconds timeout);
+    
+    // While halted, places and amends fail without a request; cancels still go
+    void halt_new_orders(bool halted) { orders_halted_.store(halted, std::memory_order_release); }
+    bool new_orders_halted() const { return orders_halted_.load(std::memory_order_acquire); }
+    
+    // Shared REST budget; requests it refuses fail fast with status 429
+    const RateLimiter& rate_limiter() const { return rate_limiter_; }
+    
     struct ExecutionUpdate {
         int64_t order_id;
         std::string exec_id;
@@ -41,60 +144,78 @@ public:
         std::chrono::system_clock::time_point timestamp;
     };
 
+    // The callback runs on the feed thread and must not block; order and
+    // position state are reconciled through attach_reconciler instead
     void subscribe_executions(const std::function<void(const ExecutionUpdate&)>& callback);
     std::vector<ExecutionUpdate> get_recent_executions(size_t n = 100);
+    
+    // Every execution row is queued to the reconciler; the feed thread never
+    // waits on it. Attach before subscribing.
+    void attach_reconciler(std::shared_ptr<ExecutionReconciler> reconciler) {
+        reconciler_ = std::move(reconciler);
+    }
 
 private:
     Config config_;
-    py::object bitmex_instance_;
-    py::object ws_thread_;
-    
-    void init_python();
-    void convert_order_to_dict(const Order& order, py::dict& order_dict);
-    Order convert_dict_to_order(const py::dict& order_dict);
-
-    struct ConnectionState {
-        std::atomic<bool> is_connected{false};
-        std::atomic<int> retry_count{0};
-        std::chrono::steady_clock::time_point last_heartbeat;
-        static constexpr int MAX_RETRIES = 3;
-        static constexpr auto RETRY_DELAY = std::chrono::seconds(5);
-    };
+    RestConnectionPool rest_;
+    std::unique_ptr<BitMEXWebSocketClient> ws_;
     
-    ConnectionState connection_state_;
+    std::shared_ptr<MarketDepth> live_depth_ = std::make_shared<MarketDepth>();
+    L2OrderBook l2_book_;
+    OrderIdMap order_ids_;  // Feed thread only
+    std::shared_ptr<TickJournalWriter> journal_;
+    std::vector<L2OrderBook::Entry> l2_entries_;
+    std::function<void(const MarketDepth&)> market_data_callback_;
+    ExecutionUpdate execution_scratch_;  // Reused so steady-state frames do not allocate
+    ExecutionReport report_scratch_;
     
-    bool ensure_connection();
-    void handle_connection_error();
-    void reset_connection();
-
-    struct PositionState {
-        std::atomic<double> current_position{0.0};
-        std::atomic<double> avg_entry_price{0.0};
-        std::atomic<double> unrealized_pnl{0.0};
-        std::mutex update_mutex;
-    };
-    
-    PositionState position_state_;
-    
-    void update_position(const py::dict& position_data);
-    double get_current_position() const { 
-        return position_state_.current_position.load(); 
+    // Feed thread entry point: one realtime frame, decoded in place
+    void handle_ws_message(std::string_view text);
+    void ensure_ws(const std::string& topic);
+    bool apply_orderbook_l2(const bitmex_frame::Frame& frame, MarketDepth& depth);
+    void apply_execution(const bitmex_frame::ExecutionRow& row);
+    std::string client_order_id(int64_t order_id) const {
+        return config_.order_id_prefix + std::to_string(order_id);
     }
+    // New-order bodies for our symbol, serialized once; renders fall back to
+    // convert_order_to_json for values that do not fit a slot
+    OrderTemplate buy_template_;
+    OrderTemplate sell_template_;
+    // Appends the body of one new order to `body`
+    void append_order_body(const Order& order, std::string& body) const;
+    // Bodies of the bulk place/amend/cancel requests
+    std::string place_orders_body(const Order* orders, size_t count) const;
+    std::string amend_orders_body(const Order* orders, size_t count) const;
+    std::string cancel_orders_body(const int64_t* order_ids, size_t count) const;
+    nlohmann::json convert_order_to_json(const Order& order) const;
+    nlohmann::json convert_amend_to_json(const Order& order) const;
+    Order convert_json_to_order(const nlohmann::json& order_json) const;
 
-    struct RateLimiter {
-        static constexpr int MAX_REQUESTS_PER_MINUTE = 300;
-        static constexpr int MAX_REQUESTS_PER_SECOND = 30;
-        
-        std::mutex mutex;
-        std::deque<std::chrono::steady_clock::time_point> request_times;
-        
-        bool should_throttle();
-        void add_request();
-    };
-    
     RateLimiter rate_limiter_;
+    std::atomic<bool> orders_halted_{false};
+    
+    // Every REST call goes through here: budget first, then resync from the
+    // response's rate-limit headers. A single-order request passes its id so
+    // the pool keeps it on that order's connection.
+    BitMEXRestClient::Response send(RateLimiter::Priority priority, std::string_view verb,
+                                    std::string_view endpoint, std::string_view query,
+                                    std::string_view body, int64_t order_id = 0);
+    void send_async(RateLimiter::Priority priority, std::string_view verb,
+                    std::string_view endpoint, std::string_view query, std::string body,
+                    Completion done, int64_t order_id = 0);
+    void sync_rate_limit(const BitMEXRestClient::Response& response);
+    // ok() of `response`, handed on to the caller's `reply` if it wants it
+    static bool keep(BitMEXRestClient::Response&& response, BitMEXRestClient::Response* reply);
+    static bool refuse_halted(BitMEXRestClient::Response* reply);
+    static void refuse_halted(const Completion& done);
+    // Query and reading of the GET /order reply behind has_order
+    std::string order_filter(int64_t order_id) const;
+    std::optional<bool> find_order(const BitMEXRestClient::Response& response,
+                                   int64_t order_id) const;
 
-    std::deque<ExecutionUpdate> execution_history_;
-    std::mutex execution_mutex_;
+    // Written by the feed thread only; readers copy out without a lock
+    static constexpr size_t EXECUTION_HISTORY_SIZE = 1024;
+    SnapshotRing<ExecutionReport> execution_history_{EXECUTION_HISTORY_SIZE};
+    std::shared_ptr<ExecutionReconciler> reconciler_;
     std::function<void(const ExecutionUpdate&)> execution_callback_;
 }; 
\ No newline at end of file
@@ -2,52 +2,145 @@
 
 #include "bitmex_connector.h"
 #include "order_manager.h"
+#include "timer_wheel.h"
+#include <condition_variable>
+#include <future>
+#include <random>
+#include <thread>
 #include <unordered_map>
 #include <shared_mutex>
 
 class BitMEXExecutionManager {
 public:
     struct ExecutionConfig {
-        int max_retry_attempts = 3;
+        int max_retry_attempts = 3;            // Async submissions only
         std::chrono::milliseconds retry_delay{500};
         double max_position_value = 100000.0;  // Maximum position value in USD
         double max_order_value = 10000.0;      // Maximum single order value in USD
-        double max_leverage = 5.0;             // Maximum allowed leverage
+        std::chrono::milliseconds max_retry_delay{8000};  // Backoff cap
+        double retry_jitter = 0.5;             // Randomised fraction of each delay
+        size_t max_pending_retries = 4096;     // Timer wheel capacity
+
+        // Delay before retry `attempt` (1-based): retry_delay doubled per
+        // attempt up to max_retry_delay, with its last retry_jitter fraction
+        // scaled by `unit` in [0, 1)
+        std::chrono::nanoseconds retry_backoff(int attempt, double unit) const {
+            const auto cap = std::chrono::duration_cast<std::chrono::nanoseconds>(max_retry_delay);
+            auto delay = std::chrono::duration_cast<std::chrono::nanoseconds>(retry_delay);
+            for (int i = 1; i < attempt && delay < cap; ++i) {
+                delay *= 2;
+            }
+            delay = std::min(delay, cap);
+            const int64_t spread = static_cast<int64_t>(delay.count() * retry_jitter);
+            return delay - std::chrono::nanoseconds(spread) +
+                   std::chrono::nanoseconds(static_cast<int64_t>(spread * unit));
+        }
     };
 
-    explicit BitMEXExecutionManager(
-        std::shared_ptr<BitMEXConnector> connector,
-        ExecutionConfig config = ExecutionConfig{})
-        : connector_(connector)
-        , config_(config) {}
+    // The position limit is checked against order_manager's position, which
+    // the execution reconciler keeps in step with the exchange's fills
+    BitMEXExecutionManager(std::shared_ptr<BitMEXConnector> connector,
+                           std::shared_ptr<OrderManager> order_manager);
+    BitMEXExecutionManager(std::shared_ptr<BitMEXConnector> connector,
+                           std::shared_ptr<OrderManager> order_manager,
+                           ExecutionConfig config);
+    ~BitMEXExecutionManager();
 
-    // Order execution methods
+    // Order execution methods. These fail fast: one request, no retries,
+    // so a caller on the tick path never sleeps out a backoff. Anything
+    // unsent or unanswered is the next tick's to send again, and the
+    // execution feed settles whether a timed-out place went through.
+    // submit_order_async is the one that retries.
     bool submit_order(Order& order);
     bool cancel_order(int64_t order_id);
     bool amend_order(const Order& order);
     
-    // Order tracking
+    // Bulk execution. submit_orders marks orders failing the risk checks
+    // REJECTED and sends the rest in one request; returns false if nothing
+    // was accepted
+    bool submit_orders(Order* orders, size_t count);
+    bool cancel_orders(const int64_t* order_ids, size_t count);
+    bool amend_orders(const Order* orders, size_t count);
+    
+    // Sends one tick's worth of actions. The batch is left as it was, with
+    // places refused by the risk checks marked REJECTED; the caller clears it.
+    bool execute(OrderBatch& batch);
+    
+    // Non-blocking submission. Risk checks run on the caller and every
+    // attempt goes out through the connector's pooled connections
+    // (place_order_async), so a slow reply holds up only its own order.
+    // Failed attempts wait on the manager's timer wheel with jittered
+    // exponential backoff instead of sleeping. A refusal (4xx) is final.
+    // After a timeout or 5xx the order may be live, so the next attempt
+    // first asks the exchange for its clOrdID and only places it again if it
+    // is not there. Callbacks run on a pool thread, or on the caller if the
+    // order is refused before anything is sent; submissions still open when
+    // the manager is destroyed are reported failed.
+    using SubmitCallback = std::function<void(const Order& order, bool accepted)>;
+    void submit_order_async(const Order& order, SubmitCallback on_done);
+    std::future<bool> submit_order_async(const Order& order);
+    
+    // Order tracking: orders this manager got accepted and has not seen
+    // cancelled, as last sent or as reported through update_order_status
     std::optional<Order> get_order_status(int64_t order_id);
     std::vector<Order> get_active_orders();
+    // Records a status or fill from the execution feed; terminal orders
+    // stop being tracked
+    void update_order_status(const Order& order);
     
     // Risk management
     bool check_risk_limits(const Order& order);
-    double get_current_leverage();
 
 private:
     std::shared_ptr<BitMEXConnector> connector_;
+    std::shared_ptr<OrderManager> order_manager_;
     ExecutionConfig config_;
     
     // Order tracking
     mutable std::shared_mutex orders_mutex_;
     std::unordered_map<int64_t, Order> active_orders_;
+    std::vector<Order> accepted_;  // Risk-checked subset of a bulk submit, reused
     
     // Execution helpers
-    bool retry_order_submission(Order& order, int attempts = 0);
-    void update_order_status(const Order& order);
+    // send() -> accepted, with a request that failed to build counted as refused
+    template <class Send>
+    bool send_once(Send&& send);
+    
+    // Asynchronous submission. Attempts run on pool threads; the submission
+    // thread only parks retries on the wheel and hands them back when due.
+    struct PendingSubmit {
+        Order order{};
+        int attempts{0};
+        bool in_doubt{false};  // Last place may have reached the exchange
+        SubmitCallback on_done;
+    };
+    struct ParkedRetry {
+        int64_t deadline_ns;
+        PendingSubmit pending;
+    };
+    static constexpr size_t RETRY_WHEEL_SLOTS = 512;
+    static constexpr int64_t RETRY_WHEEL_TICK_NS = 10'000'000;  // 10ms, ~5s per revolution
+    
+    std::mutex submit_mutex_;
+    std::condition_variable submit_cv_;
+    std::condition_variable idle_cv_;
+    std::vector<ParkedRetry> incoming_;      // Retries waiting to be put on the wheel
+    size_t requests_in_flight_{0};           // Attempts whose reply is still to come
+    bool stopping_{false};
+    TimerWheel<PendingSubmit> retry_wheel_;  // Submission thread only
+    std::mt19937_64 jitter_rng_;             // Under submit_mutex_
+    std::thread submit_thread_;
+    
+    void run_submissions();
+    void attempt_submission(PendingSubmit&& pending);
+    void place_submission(PendingSubmit&& pending);
+    void retry_submission(PendingSubmit&& pending);
+    void finish_submission(PendingSubmit&& pending, bool accepted);
+    // Bracket each async request so the destructor can wait for its reply
+    void begin_request();
+    void end_request();
     
     // Risk checks
     bool validate_order_size(const Order& order);
     bool validate_position_value(const Order& order);
-    bool validate_leverage(const Order& order);
 }; 
\ No newline at end of file
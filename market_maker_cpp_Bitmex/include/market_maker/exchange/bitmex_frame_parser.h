@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "l2_order_book.h"
+
+// Single-pass decoder for BitMEX realtime frames.
+//
+// Works directly on the received text: no DOM is built, strings come back as
+// views into the frame and rows are written into caller-owned, reused storage,
+// so steady-state decoding does not allocate. Only the fields the feed handler
+// needs are extracted; everything else is skipped structurally.
+//
+// String views are the raw JSON contents; escape sequences are not expanded
+// (none of the extracted BitMEX fields use them).
+namespace bitmex_frame {
+
+enum class Table { NONE, ORDER_BOOK_L2, EXECUTION, TRADE, OTHER };
+
+struct Frame {
+    Table table{Table::NONE};
+    std::string_view table_name;
+    L2OrderBook::Action action{L2OrderBook::Action::UPDATE};
+    std::string_view data;  // Raw `data` array, including brackets
+};
+
+struct ExecutionRow {
+    std::string_view order_id;      // Exchange UUID
+    std::string_view cl_ord_id;
+    std::string_view exec_id;
+    std::string_view exec_type;
+    std::string_view symbol;
+    std::string_view side;
+    std::string_view ord_status;
+    double last_px{0.0};
+    double last_qty{0.0};
+    double price{0.0};              // Order price
+    double cum_qty{0.0};
+    double leaves_qty{0.0};
+    bool has_leaves_qty{false};     // Missing and null say nothing about what is left
+};
+
+struct TradeRow {
+    std::string_view symbol;
+    std::string_view side;          // Aggressor: "Buy" or "Sell"
+    double price{0.0};
+    double size{0.0};
+};
+
+// Finds table, action and data in a top-level object regardless of key order.
+// False for malformed text; control frames (subscribe acks, info, pong) parse
+// with table == NONE.
+bool parse_frame(std::string_view text, Frame& frame);
+
+// Appends one entry per row of an orderBookL2 data array; price and size
+// are converted to the book's ticks and lots. Missing fields read as zero.
+bool parse_l2(std::string_view data, const L2OrderBook& book,
+              std::vector<L2OrderBook::Entry>& out);
+
+// Calls fn(const ExecutionRow&) for each row of an execution data array. The
+// row is reset between calls and its views are valid only inside fn.
+template <class F>
+bool for_each_execution(std::string_view data, F&& fn);
+
+// Same for a public trade data array
+template <class F>
+bool for_each_trade(std::string_view data, F&& fn);
+
+namespace detail {
+
+class Cursor {
+public:
+    explicit Cursor(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+    bool done() { skip_ws(); return p_ == end_; }
+    bool consume(char c) {
+        skip_ws();
+        if (p_ != end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+    bool peek(char c) { skip_ws(); return p_ != end_ && *p_ == c; }
+
+    bool string(std::string_view& out);
+    bool number(double& out);
+    bool integer(int64_t& out);
+    bool skip_value();
+    // Raw text of the next value
+    bool value_span(std::string_view& out);
+    // Consumes a null; false, consuming nothing, for any other value
+    bool null();
+    // Number or null (which reads as 0)
+    bool number_or_null(double& out);
+
+    const char* position() const { return p_; }
+
+private:
+    void skip_ws() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+// Iterates `{ "key": value, ... }`, calling fn(key, cursor) with the cursor
+// positioned at the value; fn must consume it
+template <class F>
+bool for_each_member(Cursor& cursor, F&& fn) {
+    if (!cursor.consume('{')) {
+        return false;
+    }
+    if (cursor.consume('}')) {
+        return true;
+    }
+    do {
+        std::string_view key;
+        if (!cursor.string(key) || !cursor.consume(':') || !fn(key, cursor)) {
+            return false;
+        }
+    } while (cursor.consume(','));
+    return cursor.consume('}');
+}
+
+// Iterates `[ elem, ... ]`, calling fn(cursor) per element
+template <class F>
+bool for_each_element(Cursor& cursor, F&& fn) {
+    if (!cursor.consume('[')) {
+        return false;
+    }
+    if (cursor.consume(']')) {
+        return true;
+    }
+    do {
+        if (!fn(cursor)) {
+            return false;
+        }
+    } while (cursor.consume(','));
+    return cursor.consume(']');
+}
+
+}  // namespace detail
+
+template <class F>
+bool for_each_execution(std::string_view data, F&& fn) {
+    detail::Cursor cursor(data);
+    ExecutionRow row;
+    return detail::for_each_element(cursor, [&](detail::Cursor& c) {
+        row = ExecutionRow{};
+        const bool ok = detail::for_each_member(c, [&](std::string_view key, detail::Cursor& v) {
+            if (key == "orderID") return v.string(row.order_id);
+            if (key == "clOrdID") return v.string(row.cl_ord_id);
+            if (key == "execID") return v.string(row.exec_id);
+            if (key == "execType") return v.string(row.exec_type);
+            if (key == "symbol") return v.string(row.symbol);
+            if (key == "side") return v.string(row.side);
+            if (key == "ordStatus") return v.string(row.ord_status);
+            if (key == "lastPx") return v.number_or_null(row.last_px);
+            if (key == "lastQty") return v.number_or_null(row.last_qty);
+            if (key == "price") return v.number_or_null(row.price);
+            if (key == "cumQty") return v.number_or_null(row.cum_qty);
+            if (key == "leavesQty") {
+                if (v.null()) return true;
+                row.has_leaves_qty = true;
+                return v.number(row.leaves_qty);
+            }
+            return v.skip_value();
+        });
+        if (ok) {
+            fn(static_cast<const ExecutionRow&>(row));
+        }
+        return ok;
+    });
+}
+
+template <class F>
+bool for_each_trade(std::string_view data, F&& fn) {
+    detail::Cursor cursor(data);
+    TradeRow row;
+    return detail::for_each_element(cursor, [&](detail::Cursor& c) {
+        row = TradeRow{};
+        const bool ok = detail::for_each_member(c, [&](std::string_view key, detail::Cursor& v) {
+            if (key == "symbol") return v.string(row.symbol);
+            if (key == "side") return v.string(row.side);
+            if (key == "price") return v.number_or_null(row.price);
+            if (key == "size") return v.number_or_null(row.size);
+            return v.skip_value();
+        });
+        if (ok) {
+            fn(static_cast<const TradeRow&>(row));
+        }
+        return ok;
+    });
+}
+
+}  // namespace bitmex_frame
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <curl/curl.h>
+#include <openssl/evp.h>
+
+namespace bitmex_auth {
+
+// Lower-case hex HMAC-SHA256 of verb + path + expires + body, as BitMEX expects
+// in the api-signature header. `path` includes the /api/v1 prefix and query.
+std::string sign(std::string_view secret, std::string_view verb,
+                 std::string_view path, int64_t expires, std::string_view body);
+
+// sign() for a fixed verb and path. The key pads and the verb + path prefix
+// are hashed once at construction; each signature then hashes only expires
+// and the body, and writes into the caller's buffer. Not thread-safe.
+class PrefixSigner {
+public:
+    static constexpr size_t SIGNATURE_SIZE = 64;  // Hex chars
+
+    PrefixSigner(std::string_view secret, std::string_view verb, std::string_view path);
+    ~PrefixSigner();
+
+    PrefixSigner(const PrefixSigner&) = delete;
+    PrefixSigner& operator=(const PrefixSigner&) = delete;
+
+    bool matches(std::string_view verb, std::string_view path) const {
+        return verb == verb_ && path == path_;
+    }
+
+    // Writes SIGNATURE_SIZE chars to `out`
+    void sign(int64_t expires, std::string_view body, char* out);
+
+private:
+    std::string verb_;
+    std::string path_;
+    EVP_MD_CTX* inner_;    // SHA-256 over key ^ ipad, verb, path
+    EVP_MD_CTX* outer_;    // SHA-256 over key ^ opad
+    EVP_MD_CTX* scratch_;
+};
+
+}  // namespace bitmex_auth
+
+// Blocking BitMEX REST client over a single persistent libcurl handle.
+//
+// The handle is reused for every request so the TCP/TLS session stays open
+// between calls (HTTP keep-alive); each request is signed with api-expires.
+// Requests are serialised on an internal mutex.
+class BitMEXRestClient {
+public:
+    struct Config {
+        std::string base_url;        // e.g. https://testnet.bitmex.com/api/v1
+        std::string api_key;
+        std::string api_secret;
+        int timeout = 7;             // Seconds
+        int expires_window = 5;      // Seconds each signature stays valid
+    };
+
+    struct Response {
+        long status{0};              // 0 on transport failure
+        std::string body;
+        std::string error;           // libcurl message on transport failure
+        bool unsent{false};          // Failed before any of it reached the exchange
+
+        // Rate-limit headers, -1 when the response did not carry them
+        int64_t ratelimit_remaining{-1};     // x-ratelimit-remaining (minute window)
+        int64_t ratelimit_remaining_1s{-1};  // x-ratelimit-remaining-1s
+        int64_t ratelimit_reset{-1};         // x-ratelimit-reset, Unix seconds
+        int64_t retry_after{-1};             // Retry-After seconds, on 429/503
+
+        bool ok() const { return status >= 200 && status < 300; }
+        // The exchange certainly did not act on it: never sent, rate limited,
+        // or a 503, which BitMEX documents as not processed. Anything else
+        // that failed (a timeout, other 5xx) may have gone through.
+        bool retry_safe() const { return unsent || status == 429 || status == 503; }
+    };
+
+    explicit BitMEXRestClient(Config config);
+    ~BitMEXRestClient();
+
+    BitMEXRestClient(const BitMEXRestClient&) = delete;
+    BitMEXRestClient& operator=(const BitMEXRestClient&) = delete;
+
+    // `endpoint` is relative to base_url, e.g. "/order"
+    Response get(std::string_view endpoint, std::string_view query = {});
+    Response post(std::string_view endpoint, std::string_view body);
+    Response put(std::string_view endpoint, std::string_view body);
+    Response del(std::string_view endpoint, std::string_view body);
+
+    Response request(std::string_view verb, std::string_view endpoint,
+                     std::string_view query, std::string_view body);
+
+private:
+    Config config_;
+    std::string origin_;     // scheme://host[:port]
+    std::string base_path_;  // Path part of base_url, signed with every request
+
+    std::mutex mutex_;
+    CURL* curl_{nullptr};
+    std::string path_;       // Reused per request
+    std::string url_;
+
+    // Signers for the query-less endpoints seen so far (order entry), so
+    // their verb + path prefix is hashed once
+    static constexpr size_t MAX_SIGNERS = 16;
+    std::vector<std::unique_ptr<bitmex_auth::PrefixSigner>> signers_;
+    bitmex_auth::PrefixSigner* signer_for(std::string_view verb);
+
+    static size_t write_body(char* data, size_t size, size_t count, void* user);
+    static size_t read_header(char* data, size_t size, size_t count, void* user);
+};
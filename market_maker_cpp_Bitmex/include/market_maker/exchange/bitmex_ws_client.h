@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Native BitMEX realtime client (ws:// or wss://) running on its own I/O thread.
+//
+// Each text frame is handed to the message handler as a view into the receive
+// buffer, which is reused across frames; the view is valid only for the
+// duration of the call. On connect the client authenticates (when a key is
+// configured) and sends every subscription; after a drop it reconnects and
+// does both again, so the handler will see fresh partials.
+//
+// A connection that goes quiet is pinged after half of idle_timeout and
+// dropped if nothing, pong included, arrives within idle_timeout. A handler
+// that throws is reported to on_error and the session is dropped too: the
+// state it was building from the stream can no longer be trusted, and a
+// reconnect replaces it with fresh partials.
+//
+// Over wss:// the server certificate must chain to a trusted root and name
+// the host in the URL; anything else fails the handshake and is retried like
+// any other connect failure.
+class BitMEXWebSocketClient {
+public:
+    struct Config {
+        std::string url;                       // e.g. wss://testnet.bitmex.com/realtime
+        std::string api_key;
+        std::string api_secret;
+        std::vector<std::string> subscriptions;  // e.g. "orderBookL2:XBTUSD"
+        std::chrono::milliseconds reconnect_delay{1000};
+        std::chrono::milliseconds idle_timeout{10000};  // Ping at half, drop at full
+        int expires_window = 5;                // Seconds the auth signature stays valid
+        std::string ca_pem;                    // Extra trust anchors (PEM) beside the system store
+        // Optional; gets what a throwing handler said, on the I/O thread,
+        // just before the reconnect
+        std::function<void(const std::string& error)> on_error;
+    };
+
+    using MessageHandler = std::function<void(std::string_view)>;
+
+    BitMEXWebSocketClient(Config config, MessageHandler handler);
+    ~BitMEXWebSocketClient();
+
+    BitMEXWebSocketClient(const BitMEXWebSocketClient&) = delete;
+    BitMEXWebSocketClient& operator=(const BitMEXWebSocketClient&) = delete;
+
+    void start();
+    void stop();
+
+    // Adds topics; sent immediately when connected and on every reconnect
+    void subscribe(const std::vector<std::string>& topics);
+
+    bool is_connected() const { return connected_.load(std::memory_order_acquire); }
+
+    // Derives the realtime endpoint from a REST base URL
+    // (https://host/api/v1 -> wss://host/realtime)
+    static std::string realtime_url(const std::string& rest_base_url);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+    std::atomic<bool> connected_{false};
+};
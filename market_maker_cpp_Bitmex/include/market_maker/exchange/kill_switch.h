@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bitmex_connector.h"
+#include "order_manager.h"
+#include "risk_manager.h"
+
+// Pulls every quote when something goes wrong, on our side or theirs.
+//
+// trip() halts new places and amends on the connector straight away and has
+// the kill switch thread send one DELETE /order/all, which cancels the
+// account's open orders on every symbol; a refused request is retried every
+// retry_delay until it succeeds. The halt holds until reset(), which also
+// drops a cancel-all not yet accepted. Once one is accepted, the attached
+// OrderManager is emptied and the cancel listeners run, so local state does
+// not wait on the execution feed to learn the quotes are gone.
+//
+// The same thread keeps the exchange's dead man's switch armed: every
+// heartbeat_interval it sends POST /order/cancelAllAfter with
+// dead_man_timeout, so if this process hangs or dies the exchange cancels
+// everything itself within dead_man_timeout of the last heartbeat. stop()
+// disarms it.
+//
+// Both the cancel-all and the exchange timer cover the whole account, so an
+// account should have exactly one kill switch, shared by every strategy
+// trading on it (StrategyManager keeps one per account). Each user calls
+// acquire() and release(); the switch starts with the first and only stops,
+// disarming the timer, when the last one lets go.
+class KillSwitch {
+public:
+    struct Config {
+        std::chrono::milliseconds heartbeat_interval{15000};
+        std::chrono::milliseconds dead_man_timeout{60000};  // Must exceed the interval
+        std::chrono::milliseconds retry_delay{250};         // After a failed request
+    };
+
+    KillSwitch(std::shared_ptr<BitMEXConnector> connector, Config config);
+    explicit KillSwitch(std::shared_ptr<BitMEXConnector> connector);
+    ~KillSwitch();
+
+    KillSwitch(const KillSwitch&) = delete;
+    KillSwitch& operator=(const KillSwitch&) = delete;
+
+    // Any time, any thread. Every attached OrderManager is emptied after
+    // each cancel-all the exchange accepted, and then the listeners run, on
+    // the kill switch thread and under a lock: a listener must not add or
+    // remove listeners. A further connector on the same account is halted
+    // and resumed along with the one given to the constructor.
+    void attach(std::shared_ptr<OrderManager> order_manager);
+    void detach(const std::shared_ptr<OrderManager>& order_manager);
+    void attach(std::shared_ptr<BitMEXConnector> connector);
+    using ListenerId = uint64_t;
+    ListenerId add_cancel_listener(std::function<void()> listener);
+    // Once this returns the listener is not running and never runs again
+    void remove_cancel_listener(ListenerId id);
+
+    void start();
+    void stop();
+
+    // Reference-counted start()/stop() for shared use
+    void acquire();
+    void release();
+
+    // Any thread; never waits on the network. A trip before start() is
+    // acted on once started.
+    void trip(const std::string& reason);
+    // Lets new orders through again. A cancel-all still waiting or being
+    // retried is dropped; one already on the wire stands at the exchange but
+    // is not applied locally.
+    void reset();
+
+    bool tripped() const { return tripped_.load(std::memory_order_acquire); }
+    std::string reason() const;
+
+    // Trips on every RiskManager circuit breaker
+    void subscribe(RiskManager& risk) {
+        risk.add_breaker_listener([this](const std::string& reason) { trip(reason); });
+    }
+
+    uint64_t heartbeats() const { return heartbeats_.load(std::memory_order_relaxed); }
+    uint64_t heartbeat_failures() const { return heartbeat_failures_.load(std::memory_order_relaxed); }
+    uint64_t cancel_alls() const { return cancel_alls_.load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<BitMEXConnector> connector_;
+    Config config_;
+
+    // What a cancel-all and a halt reach, beside connector_
+    std::mutex attached_mutex_;
+    std::vector<std::shared_ptr<BitMEXConnector>> connectors_;
+    std::vector<std::shared_ptr<OrderManager>> order_managers_;
+    std::vector<std::pair<ListenerId, std::function<void()>>> cancel_listeners_;
+    ListenerId next_listener_{1};
+
+    std::mutex users_mutex_;
+    size_t users_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_{false};
+    bool cancel_pending_{false};
+    uint64_t generation_{0};  // Bumped by reset(); stale cancel-alls are ignored
+    std::string reason_;
+    std::thread thread_;
+
+    std::atomic<bool> tripped_{false};
+    std::atomic<uint64_t> heartbeats_{0};
+    std::atomic<uint64_t> heartbeat_failures_{0};
+    std::atomic<uint64_t> cancel_alls_{0};
+
+    void run();
+    void cancelled_all();
+    void halt_new_orders(bool halted);
+};
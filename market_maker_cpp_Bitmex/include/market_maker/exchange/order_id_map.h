@@ -0,0 +1,241 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "order_index.h"
+#include "slot_pool.h"
+
+// Exchange order id (UUID) in its 16-byte binary form
+struct ExchangeOrderId {
+    uint8_t bytes[16]{};
+
+    static constexpr size_t TEXT_SIZE = 36;  // 8-4-4-4-12 hex digits
+
+    // False unless `text` is a canonical hyphenated UUID
+    static bool parse(std::string_view text, ExchangeOrderId& out) {
+        if (text.size() != TEXT_SIZE) {
+            return false;
+        }
+        size_t byte = 0;
+        for (size_t i = 0; i < TEXT_SIZE;) {
+            if (i == 8 || i == 13 || i == 18 || i == 23) {
+                if (text[i++] != '-') {
+                    return false;
+                }
+                continue;
+            }
+            const int hi = hex_value(text[i]);
+            const int lo = hex_value(text[i + 1]);
+            if (hi < 0 || lo < 0) {
+                return false;
+            }
+            out.bytes[byte++] = static_cast<uint8_t>(hi << 4 | lo);
+            i += 2;
+        }
+        return true;
+    }
+
+    // Writes the lowercase hyphenated form; `out` holds TEXT_SIZE chars
+    void format(char* out) const {
+        static constexpr char DIGITS[] = "0123456789abcdef";
+        for (size_t i = 0; i < 16; ++i) {
+            if (i == 4 || i == 6 || i == 8 || i == 10) {
+                *out++ = '-';
+            }
+            *out++ = DIGITS[bytes[i] >> 4];
+            *out++ = DIGITS[bytes[i] & 0xf];
+        }
+    }
+
+    bool empty() const {
+        static constexpr uint8_t ZERO[16]{};
+        return std::memcmp(bytes, ZERO, sizeof(bytes)) == 0;
+    }
+
+    bool operator==(const ExchangeOrderId& other) const {
+        return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+    }
+
+    // The exchange generates these randomly, so folding the two halves is
+    // already a good hash
+    uint64_t hash() const {
+        uint64_t a;
+        uint64_t b;
+        std::memcpy(&a, bytes, 8);
+        std::memcpy(&b, bytes + 8, 8);
+        return (a ^ b) * 0x9E3779B97F4A7C15ull;
+    }
+
+private:
+    static int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+};
+
+// Bidirectional map between our int64 order ids, their clOrdIDs and the
+// exchange's order UUIDs.
+//
+// clOrdID is always `prefix` followed by the decimal id, so it converts both
+// ways arithmetically and is never stored. The UUID is learnt from the first
+// execution that carries both, and is kept in 16-byte binary form: one
+// SlotPool entry per live order, reached through an OrderIndex by internal id
+// and through an open-addressing table keyed on the UUID itself, so a fill
+// that carries only the orderID resolves with one parse and one probe, with
+// no string hashing. Sized at construction; nothing allocates afterwards.
+// Not thread-safe: the feed thread owns it. The clOrdID conversions only
+// read the prefix and may be used from any thread.
+class OrderIdMap {
+public:
+    static constexpr size_t MAX_CL_ORD_ID = 36;  // BitMEX limit
+
+    OrderIdMap(std::string_view prefix, size_t max_orders)
+        : prefix_(prefix)
+        , entries_(max_orders)
+        , by_internal_(max_orders)
+        , mask_(round_up_pow2(max_orders * 2) - 1)
+        , by_exchange_(mask_ + 1) {}
+
+    // clOrdID for an internal id, written into `out` (MAX_CL_ORD_ID chars);
+    // returns its length, 0 if it would be too long
+    size_t format_cl_ord_id(int64_t internal_id, char* out) const {
+        if (prefix_.size() >= MAX_CL_ORD_ID) {
+            return 0;
+        }
+        std::memcpy(out, prefix_.data(), prefix_.size());
+        const auto result = std::to_chars(out + prefix_.size(), out + MAX_CL_ORD_ID, internal_id);
+        return result.ec == std::errc() ? static_cast<size_t>(result.ptr - out) : 0;
+    }
+
+    // 0 unless the clOrdID is one of ours
+    int64_t parse_cl_ord_id(std::string_view cl_ord_id) const {
+        if (cl_ord_id.size() <= prefix_.size() || cl_ord_id.compare(0, prefix_.size(), prefix_) != 0) {
+            return 0;
+        }
+        int64_t id = 0;
+        const char* end = cl_ord_id.data() + cl_ord_id.size();
+        const auto result = std::from_chars(cl_ord_id.data() + prefix_.size(), end, id);
+        return result.ec == std::errc() && result.ptr == end ? id : 0;
+    }
+
+    // Associates an exchange UUID with an internal id. False if either side
+    // is already bound to something else or the map is full.
+    bool bind(int64_t internal_id, const ExchangeOrderId& exchange_id) {
+        if (exchange_id.empty()) {
+            return false;
+        }
+        const uint64_t existing = by_internal_.find(internal_id);
+        if (existing != OrderIndex::NPOS) {
+            return entries_.get(PoolHandle::unpack(existing))->exchange_id == exchange_id;
+        }
+        if (probe(exchange_id) != NOT_FOUND) {
+            return false;
+        }
+
+        const PoolHandle handle = entries_.acquire();
+        if (!handle.valid()) {
+            return false;
+        }
+        *entries_.get(handle) = {internal_id, exchange_id};
+        by_internal_.insert(internal_id, handle.pack());
+
+        size_t i = exchange_id.hash() & mask_;
+        while (!by_exchange_[i].key.empty()) {
+            i = (i + 1) & mask_;
+        }
+        by_exchange_[i] = {exchange_id, handle.pack()};
+        return true;
+    }
+
+    bool bind(int64_t internal_id, std::string_view exchange_id) {
+        ExchangeOrderId parsed;
+        return ExchangeOrderId::parse(exchange_id, parsed) && bind(internal_id, parsed);
+    }
+
+    // Internal id bound to an exchange UUID, 0 if none
+    int64_t find(const ExchangeOrderId& exchange_id) const {
+        const size_t i = probe(exchange_id);
+        return i == NOT_FOUND ? 0 : entries_.get(PoolHandle::unpack(by_exchange_[i].value))->internal_id;
+    }
+
+    int64_t find(std::string_view exchange_id) const {
+        ExchangeOrderId parsed;
+        return ExchangeOrderId::parse(exchange_id, parsed) ? find(parsed) : 0;
+    }
+
+    // Exchange UUID of an internal id, nullptr if not yet known
+    const ExchangeOrderId* exchange_id(int64_t internal_id) const {
+        const uint64_t packed = by_internal_.find(internal_id);
+        return packed == OrderIndex::NPOS ? nullptr : &entries_.get(PoolHandle::unpack(packed))->exchange_id;
+    }
+
+    // Forgets an order once it can no longer trade
+    bool erase(int64_t internal_id) {
+        const uint64_t packed = by_internal_.find(internal_id);
+        if (packed == OrderIndex::NPOS) {
+            return false;
+        }
+        const PoolHandle handle = PoolHandle::unpack(packed);
+        erase_exchange(probe(entries_.get(handle)->exchange_id));
+        by_internal_.erase(internal_id);
+        entries_.release(handle);
+        return true;
+    }
+
+    size_t size() const { return by_internal_.size(); }
+    std::string_view prefix() const { return prefix_; }
+
+private:
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    struct Entry {
+        int64_t internal_id{0};
+        ExchangeOrderId exchange_id;
+    };
+
+    struct Bucket {
+        ExchangeOrderId key;  // All zero when empty; the exchange never issues it
+        uint64_t value{0};
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t cap = 2;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    size_t probe(const ExchangeOrderId& key) const {
+        for (size_t i = key.hash() & mask_; !by_exchange_[i].key.empty(); i = (i + 1) & mask_) {
+            if (by_exchange_[i].key == key) {
+                return i;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    // Backward-shift deletion, as in OrderIndex
+    void erase_exchange(size_t i) {
+        for (size_t j = (i + 1) & mask_; !by_exchange_[j].key.empty(); j = (j + 1) & mask_) {
+            const size_t h = by_exchange_[j].key.hash() & mask_;
+            const bool movable = i <= j ? (h <= i || h > j) : (h <= i && h > j);
+            if (movable) {
+                by_exchange_[i] = by_exchange_[j];
+                i = j;
+            }
+        }
+        by_exchange_[i] = Bucket{};
+    }
+
+    std::string_view prefix_;  // Not owned
+    SlotPool<Entry> entries_;
+    OrderIndex by_internal_;
+    size_t mask_;
+    std::vector<Bucket> by_exchange_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "order_manager.h"
+
+// Pre-serialized POST /order body for one symbol and side.
+//
+// The constant part (symbol, side, ordType, execInst) is serialized once;
+// clOrdID, orderQty and price each own a fixed-width slot at a fixed offset
+// and are written straight into a copy of the template, padded with JSON
+// whitespace, so every body has the same size and rendering is one memcpy
+// plus three short integer formats. Prices and quantities are printed as
+// exact decimals with as many places as the tick and lot sizes need.
+// Immutable after construction, so renders may run on any thread.
+class OrderTemplate {
+public:
+    static constexpr size_t CL_ORD_ID_WIDTH = 36;  // BitMEX limit
+    static constexpr size_t QTY_WIDTH = 20;
+    static constexpr size_t PRICE_WIDTH = 24;
+
+    OrderTemplate(std::string_view symbol, OrderSide side, bool post_only,
+                  double tick_size, double lot_size);
+
+    size_t size() const { return body_.size(); }
+
+    // Writes size() bytes to `out`. False, with `out` unspecified, if a value
+    // does not fit its slot (or is not finite); callers fall back to the
+    // general serializer.
+    bool render(std::string_view cl_ord_id, double price, double quantity, char* out) const;
+
+private:
+    std::string body_;
+    size_t cl_ord_id_offset_{0};
+    size_t qty_offset_{0};
+    size_t price_offset_{0};
+    int price_decimals_{0};
+    int qty_decimals_{0};
+    int64_t price_scale_{1};
+    int64_t qty_scale_{1};
+};
+
+namespace order_format {
+
+// Decimal places needed to print multiples of `increment` exactly (at most 8)
+int decimals_for(double increment);
+
+// Writes `value` rounded to `decimals` places into `out` (at most `width`
+// chars) and returns the length, or 0 if it does not fit
+size_t write_decimal(double value, int decimals, int64_t scale, char* out, size_t width);
+
+}  // namespace order_format
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Lock-free request budget for the BitMEX REST API: a per-second and a
+// per-minute token bucket, both of which must admit a request.
+//
+// Each bucket is a single word holding its theoretical arrival time (GCRA):
+// the instant the bucket would be full again. Taking n tokens moves it to
+// max(tat, now) + n * interval and succeeds while the debt tat - now stays
+// within the burst, so refill is plain arithmetic on one CAS and no thread
+// ever sweeps expired timestamps.
+//
+// The last `cancel_reserve` tokens of each bucket are only handed to CANCEL
+// requests, so pulling quotes still works when new orders are being refused.
+// The budget is resynced from the exchange's own count after each response
+// (x-ratelimit-* headers) whenever the server has less left than we think;
+// a sync never gives tokens back.
+//
+// Times are steady-clock nanoseconds; every call has an overload taking `now`.
+class RateLimiter {
+public:
+    enum class Priority { NORMAL, CANCEL };
+
+    struct Config {
+        int64_t per_second = 30;
+        int64_t per_minute = 300;
+        int64_t cancel_reserve_second = 5;   // Tokens held back for cancels
+        int64_t cancel_reserve_minute = 30;
+    };
+
+    RateLimiter() : RateLimiter(Config{}) {}
+
+    explicit RateLimiter(const Config& config)
+        : second_(1'000'000'000, config.per_second, config.cancel_reserve_second)
+        , minute_(60'000'000'000, config.per_minute, config.cancel_reserve_minute) {}
+
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Takes `cost` tokens from both buckets or neither
+    bool try_acquire(Priority priority, int64_t now, int64_t cost = 1) {
+        if (!second_.take(now, cost, priority)) {
+            return false;
+        }
+        if (!minute_.take(now, cost, priority)) {
+            second_.give_back(cost);
+            return false;
+        }
+        return true;
+    }
+
+    bool try_acquire(Priority priority = Priority::NORMAL) {
+        return try_acquire(priority, now_ns());
+    }
+
+    // Tokens a request of this priority could take right now
+    int64_t available(Priority priority, int64_t now) const {
+        return std::min(second_.available(now, priority), minute_.available(now, priority));
+    }
+
+    int64_t available(Priority priority = Priority::NORMAL) const {
+        return available(priority, now_ns());
+    }
+
+    // Adopts the server's minute budget: `remaining` requests left and
+    // `reset_in_ns` until its window resets (x-ratelimit-reset)
+    void sync_minute(int64_t remaining, int64_t reset_in_ns, int64_t now) {
+        minute_.sync(remaining, reset_in_ns, now);
+    }
+
+    void sync_second(int64_t remaining, int64_t now) {
+        second_.sync(remaining, 0, now);
+    }
+
+    // Refuses everything for `duration_ns` (429/503 Retry-After)
+    void hold_off(int64_t duration_ns, int64_t now) {
+        second_.hold_off(now + duration_ns);
+        minute_.hold_off(now + duration_ns);
+    }
+
+private:
+    class Bucket {
+    public:
+        Bucket(int64_t window_ns, int64_t capacity, int64_t reserve)
+            : interval_(window_ns / std::max<int64_t>(capacity, 1))
+            , capacity_(capacity)
+            , burst_(interval_ * capacity)
+            , reserve_(interval_ * std::clamp<int64_t>(reserve, 0, capacity)) {}
+
+        bool take(int64_t now, int64_t tokens, Priority priority) {
+            const int64_t limit = priority == Priority::CANCEL ? burst_ : burst_ - reserve_;
+            const int64_t cost = tokens * interval_;
+            int64_t tat = tat_.load(std::memory_order_acquire);
+            while (true) {
+                const int64_t next = std::max(tat, now) + cost;
+                if (next - now > limit) {
+                    return false;
+                }
+                if (tat_.compare_exchange_weak(tat, next, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+                    return true;
+                }
+            }
+        }
+
+        void give_back(int64_t tokens) {
+            tat_.fetch_sub(tokens * interval_, std::memory_order_acq_rel);
+        }
+
+        int64_t available(int64_t now, Priority priority) const {
+            const int64_t limit = priority == Priority::CANCEL ? burst_ : burst_ - reserve_;
+            const int64_t debt = std::max<int64_t>(tat_.load(std::memory_order_acquire) - now, 0);
+            return std::max<int64_t>(limit - debt, 0) / interval_;
+        }
+
+        // The server's count only ever tightens the bucket. With several
+        // connections, responses come back out of order and an older, more
+        // generous count would hand back tokens already spent on requests the
+        // server has not counted yet. An exhausted window stays empty until
+        // the server's reset time.
+        void sync(int64_t remaining, int64_t reset_in_ns, int64_t now) {
+            if (remaining <= 0 && reset_in_ns > 0) {
+                advance_to(now + reset_in_ns + burst_);
+                return;
+            }
+            const int64_t spent = capacity_ - std::clamp<int64_t>(remaining, 0, capacity_);
+            advance_to(now + spent * interval_);
+        }
+
+        // Empty until `until`, then refilling as usual
+        void hold_off(int64_t until) {
+            advance_to(until + burst_);
+        }
+
+    private:
+        void advance_to(int64_t target) {
+            int64_t tat = tat_.load(std::memory_order_acquire);
+            while (tat < target &&
+                   !tat_.compare_exchange_weak(tat, target, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {}
+        }
+
+        alignas(64) std::atomic<int64_t> tat_{0};
+        int64_t interval_;   // ns per token
+        int64_t capacity_;
+        int64_t burst_;      // capacity * interval
+        int64_t reserve_;    // cancel_reserve * interval
+    };
+
+    Bucket second_;
+    Bucket minute_;
+};
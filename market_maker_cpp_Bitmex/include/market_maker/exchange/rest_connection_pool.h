@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "bitmex_rest_client.h"
+
+// N keep-alive BitMEX REST connections with requests in flight in parallel.
+//
+// Each connection is a BitMEXRestClient with its own thread, so a slow
+// request holds up only the connection it is on. submit() queues a request
+// on the connection with the fewest queued plus running requests and returns
+// at once; the completion runs on that connection's thread. Requests on the
+// PRIORITY lane (cancels) go ahead of everything still queued on their
+// connection.
+//
+// Requests that name an order are pinned to the connection picked from its
+// id, so an amend or cancel can never overtake that order's place on another
+// connection; a cancel that jumps the queue takes the order's own queued
+// requests ahead with it. Bulk requests name no order and are not pinned.
+//
+// All threads and curl handles are created by the constructor; only the TCP
+// and TLS session of a connection waits for its first request.
+//
+// Completions must not wait on the pool themselves. stop() lets running
+// requests finish and fails the queued ones with status 0.
+class RestConnectionPool {
+public:
+    enum class Lane { NORMAL, PRIORITY };
+
+    using Completion = std::function<void(const BitMEXRestClient::Response&)>;
+
+    RestConnectionPool(const BitMEXRestClient::Config& client, size_t connections);
+    ~RestConnectionPool();
+
+    RestConnectionPool(const RestConnectionPool&) = delete;
+    RestConnectionPool& operator=(const RestConnectionPool&) = delete;
+
+    // order_id 0: not about a single order, any connection will do
+    void submit(Lane lane, std::string_view verb, std::string_view endpoint,
+                std::string_view query, std::string body, Completion done,
+                int64_t order_id = 0);
+
+    // Blocking convenience over submit()
+    BitMEXRestClient::Response request(Lane lane, std::string_view verb, std::string_view endpoint,
+                                       std::string_view query, std::string_view body,
+                                       int64_t order_id = 0);
+
+    void stop();
+
+    size_t connections() const { return connections_.size(); }
+    // Queued plus running, over all connections
+    size_t in_flight() const;
+
+private:
+    struct Request {
+        std::string verb;
+        std::string endpoint;
+        std::string query;
+        std::string body;
+        Completion done;
+        int64_t order_id;
+    };
+
+    struct Connection {
+        explicit Connection(const BitMEXRestClient::Config& config) : client(config) {}
+
+        BitMEXRestClient client;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Request> priority;
+        std::deque<Request> normal;
+        bool stopping{false};
+        std::atomic<size_t> load{0};
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    Connection& least_loaded();
+    Connection& connection_for(int64_t order_id);
+    static void run(Connection& connection);
+};
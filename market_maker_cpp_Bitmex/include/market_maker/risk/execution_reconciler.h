@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "order_manager.h"
+#include "order_index.h"
+#include "mpsc_queue.h"
+
+enum class ExecType : uint8_t { NEW, TRADE, CANCELED, REJECTED, REPLACED, OTHER };
+
+// One execution row as the feed thread saw it. Plain data with a fixed-size
+// execID so it can cross the queue without allocating.
+struct ExecutionReport {
+    static constexpr size_t MAX_EXEC_ID = 36;  // Textual UUID
+
+    int64_t order_id{0};  // Internal id parsed from our clOrdID, 0 if not ours
+    ExecType exec_type{ExecType::OTHER};
+    OrderSide side{OrderSide::BUY};
+    double last_px{0.0};
+    double last_qty{0.0};
+    double cum_qty{0.0};
+    double leaves_qty{0.0};
+    bool has_leaves_qty{true};  // False when the row did not carry leavesQty
+    int64_t timestamp{0};
+    uint8_t exec_id_len{0};
+    char exec_id[MAX_EXEC_ID]{};
+
+    void set_exec_id(std::string_view id) {
+        exec_id_len = static_cast<uint8_t>(std::min(id.size(), MAX_EXEC_ID));
+        std::memcpy(exec_id, id.data(), exec_id_len);
+    }
+    std::string_view exec_id_view() const { return {exec_id, exec_id_len}; }
+
+    static ExecType parse_exec_type(std::string_view type) {
+        if (type == "Trade") return ExecType::TRADE;
+        if (type == "New") return ExecType::NEW;
+        if (type == "Canceled") return ExecType::CANCELED;
+        if (type == "Rejected") return ExecType::REJECTED;
+        if (type == "Replaced") return ExecType::REPLACED;
+        return ExecType::OTHER;
+    }
+};
+
+// Signed change in position caused by one fill
+struct PositionDelta {
+    int64_t order_id;
+    OrderSide side;
+    double quantity;   // > 0 bought, < 0 sold
+    double price;
+    double position;   // OrderManager position after the fill
+    int64_t timestamp;
+};
+
+// Applies exchange executions to OrderManager off the feed thread.
+//
+// The feed thread only copies each execution into a bounded MPSC queue and
+// never touches a lock; a full queue drops the report and counts it rather
+// than stall the socket. The consumer, either the thread started by start()
+// or whoever calls poll(), de-duplicates on execID (BitMEX replays recent
+// executions after a reconnect), applies partial and complete fills, cancels
+// and rejects to the order store and position, and hands a PositionDelta for
+// every fill to the listeners. A fill on one of our orders that was already
+// cancelled locally (the cancel raced it on the wire) still counts: it is
+// booked to position from the row's side, lastQty and lastPx.
+//
+// execIDs are remembered as 64-bit hashes over a sliding window of the most
+// recent dedup_window executions, so the check is one index probe and nothing
+// allocates after construction.
+class ExecutionReconciler {
+public:
+    struct Config {
+        size_t queue_capacity = 4096;
+        size_t dedup_window = 65536;
+    };
+
+    using DeltaListener = std::function<void(const PositionDelta&)>;
+
+    ExecutionReconciler(std::shared_ptr<OrderManager> order_manager, Config config);
+    explicit ExecutionReconciler(std::shared_ptr<OrderManager> order_manager);
+    ~ExecutionReconciler();
+
+    // Feed thread; never blocks. False if the report was dropped.
+    bool enqueue(const ExecutionReport& report) {
+        if (queue_.try_push(report)) {
+            return true;
+        }
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Listeners run on the consumer thread. Add them before start().
+    void add_listener(DeltaListener listener) { listeners_.push_back(std::move(listener)); }
+
+    // Drains the queue on the calling thread. Only one consumer at a time:
+    // do not mix with start(). Returns the number of reports taken.
+    size_t poll();
+
+    // Runs poll() on a dedicated thread until stop(); stop() drains whatever
+    // is still queued before returning
+    void start();
+    void stop();
+
+    uint64_t applied() const { return applied_.load(std::memory_order_relaxed); }
+    uint64_t duplicates() const { return duplicates_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    // Fills that are not ours and were left alone
+    uint64_t unmatched() const { return unmatched_.load(std::memory_order_relaxed); }
+    // Fills on our own orders after they had been cancelled locally; booked
+    // to position without a reservation
+    uint64_t untracked() const { return untracked_.load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<OrderManager> order_manager_;
+    MpscQueue<ExecutionReport> queue_;
+    std::vector<DeltaListener> listeners_;
+
+    // Consumer-owned dedup window: the index answers "seen?", the ring
+    // remembers insertion order so the oldest hash can be evicted
+    OrderIndex seen_;
+    std::vector<int64_t> recent_;
+    size_t recent_next_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    std::atomic<uint64_t> applied_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> unmatched_{0};
+    std::atomic<uint64_t> untracked_{0};
+
+    void apply(const ExecutionReport& report);
+    void notify(const ExecutionReport& report, OrderSide side, double filled);
+    bool remember(std::string_view exec_id);
+    void run();
+};
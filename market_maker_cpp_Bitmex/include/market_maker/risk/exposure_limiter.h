@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "cache_line.h"
+
+// Lock-free pre-trade headroom for position and notional.
+//
+// An order reserves its worst case before it is sent and the reservation is
+// later converted by fills or handed back on cancel. Each limit is enforced on
+// a single word that already includes outstanding reservations:
+//
+//   long_exposure  =  position + reserved buys   <= max_position
+//   short_exposure = -position + reserved sells  <= max_position
+//   notional       =  open position cost + reserved notional <= max_notional
+//
+// so a reservation is one CAS on the word it is bounded by, and two threads can
+// never both pass against the same headroom. Fills move lots from "reserved"
+// to "position" without changing the word the side was reserved against, so
+// the realised position never exceeds what was reserved.
+//
+// Notional follows the net position rather than traded volume: a fill that
+// adds to the position turns its reservation into position cost, and one that
+// reduces it hands back both its reservation and the closed lots' share of the
+// cost, so a flat book holds no notional beyond its resting orders. fill()
+// serialises on a small mutex to keep the position and its cost in step;
+// reserve() and release() stay lock-free, and fill() never raises notional.
+//
+// Lots are signed (> 0 buys, < 0 sells) and notional is in ticks x lots.
+class ExposureLimiter {
+public:
+    ExposureLimiter(int64_t max_position, int64_t max_notional)
+        : max_position_(max_position)
+        , max_notional_(max_notional) {}
+
+    // Claims headroom for an order of `lots` at `price_ticks`. All or nothing.
+    bool reserve(int64_t lots, int64_t price_ticks) {
+        if (lots == 0) {
+            return true;
+        }
+        std::atomic<int64_t>& side = lots > 0 ? long_exposure_ : short_exposure_;
+        const int64_t size = lots > 0 ? lots : -lots;
+        const int64_t notional = price_ticks * size;
+
+        if (!try_add(side, size, max_position_)) {
+            return false;
+        }
+        if (!try_add(notional_, notional, max_notional_)) {
+            side.fetch_sub(size, std::memory_order_acq_rel);
+            return false;
+        }
+        return true;
+    }
+
+    // Converts part of a reservation made at `price_ticks` into position
+    void fill(int64_t lots, int64_t price_ticks) {
+        if (lots == 0) {
+            return;
+        }
+        const int64_t size = lots > 0 ? lots : -lots;
+
+        std::lock_guard<std::mutex> lock(fill_mutex_);
+        const int64_t old_position = position_.load(std::memory_order_relaxed);
+        const int64_t new_position = old_position + lots;
+        const int64_t old_size = old_position > 0 ? old_position : -old_position;
+
+        // Lots that close existing position keep none of their cost; any
+        // excess opens the other way at this fill's price
+        const int64_t closed = (old_position > 0) == (lots > 0) ? 0 : std::min(size, old_size);
+        int64_t cost = position_cost_;
+        if (closed == old_size) {
+            cost = 0;
+        } else if (closed > 0) {
+            cost -= static_cast<int64_t>(static_cast<double>(cost) * closed / old_size);
+        }
+        cost += (size - closed) * price_ticks;
+
+        // Reservation consumed, position cost adjusted: never a net increase
+        notional_.fetch_add(cost - position_cost_ - size * price_ticks, std::memory_order_acq_rel);
+        position_cost_ = cost;
+
+        if (lots > 0) {
+            short_exposure_.fetch_sub(lots, std::memory_order_acq_rel);
+        } else {
+            long_exposure_.fetch_add(lots, std::memory_order_acq_rel);
+        }
+        position_.store(new_position, std::memory_order_release);
+    }
+
+    // Books headroom for something the exchange already holds, e.g. an order
+    // whose amend it never accepted, so it may take the words past the limits
+    void reserve_unchecked(int64_t lots, int64_t price_ticks) {
+        if (lots == 0) {
+            return;
+        }
+        std::atomic<int64_t>& side = lots > 0 ? long_exposure_ : short_exposure_;
+        const int64_t size = lots > 0 ? lots : -lots;
+        side.fetch_add(size, std::memory_order_acq_rel);
+        notional_.fetch_add(price_ticks * size, std::memory_order_acq_rel);
+    }
+
+    // A fill with no reservation behind it, e.g. one that raced our cancel
+    void fill_unreserved(int64_t lots, int64_t price_ticks) {
+        reserve_unchecked(lots, price_ticks);
+        fill(lots, price_ticks);
+    }
+
+    // Returns the unfilled remainder of a reservation
+    void release(int64_t lots, int64_t price_ticks) {
+        if (lots == 0) {
+            return;
+        }
+        std::atomic<int64_t>& side = lots > 0 ? long_exposure_ : short_exposure_;
+        const int64_t size = lots > 0 ? lots : -lots;
+        side.fetch_sub(size, std::memory_order_acq_rel);
+        notional_.fetch_sub(price_ticks * size, std::memory_order_acq_rel);
+    }
+
+    // Read-only probe; a later reserve() may still fail under contention
+    bool would_fit(int64_t lots, int64_t price_ticks) const {
+        const int64_t size = lots > 0 ? lots : -lots;
+        const std::atomic<int64_t>& side = lots > 0 ? long_exposure_ : short_exposure_;
+        return side.load(std::memory_order_acquire) + size <= max_position_ &&
+               notional_.load(std::memory_order_acquire) + price_ticks * size <= max_notional_;
+    }
+
+    int64_t position() const { return position_.load(std::memory_order_acquire); }
+    int64_t notional() const { return notional_.load(std::memory_order_acquire); }
+    int64_t long_exposure() const { return long_exposure_.load(std::memory_order_acquire); }
+    int64_t short_exposure() const { return short_exposure_.load(std::memory_order_acquire); }
+
+private:
+    static bool try_add(std::atomic<int64_t>& word, int64_t amount, int64_t limit) {
+        int64_t current = word.load(std::memory_order_acquire);
+        do {
+            if (current + amount > limit) {
+                return false;
+            }
+        } while (!word.compare_exchange_weak(current, current + amount,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire));
+        return true;
+    }
+
+    const int64_t max_position_;
+    const int64_t max_notional_;
+
+    // Separate lines: buy and sell reservations come from different threads
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> long_exposure_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> short_exposure_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> notional_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> position_{0};
+    int64_t position_cost_{0};  // Ticks x lots of the open position; fill_mutex_
+    std::mutex fill_mutex_;
+};
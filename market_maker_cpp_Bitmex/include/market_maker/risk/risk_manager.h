@@ -2,8 +2,14 @@
 
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
 #include "market_data.h"
 #include "order_manager.h"
+#include "stable_ring.h"
+#include "market_data_hub.h"
+#include "execution_reconciler.h"
 
 class RiskManager {
 public:
@@ -23,7 +29,30 @@ public:
         , start_time_(std::chrono::system_clock::now()) {}
     
     bool check_order_risk(const Order& order, const MarketDepth& depth);
+    
+    // Checks against the book shared with the strategies, if attached. The
+    // book is either a live seqlocked MarketDepth or the latest hub snapshot.
+    void attach_market_depth(std::shared_ptr<const MarketDepth> depth) {
+        std::atomic_store(&live_depth_, std::move(depth));
+    }
+    MarketDataHub::SubscriptionId subscribe(MarketDataHub& hub, const std::string& symbol) {
+        return hub.subscribe(symbol,
+            [this](const std::string&, const MarketDataHub::Snapshot& snapshot) {
+                attach_market_depth(snapshot);
+            });
+    }
+    bool check_order_risk(const Order& order) {
+        auto depth = std::atomic_load(&live_depth_);
+        return depth && check_order_risk(order, *depth);
+    }
     bool check_position_risk(const std::string& symbol, double position, double price);
+    
+    // Fills reconciled from the execution feed. Runs on the reconciler
+    // thread, so taking metrics_mutex_ here never stalls the socket.
+    void on_position_delta(const PositionDelta& delta);
+    void subscribe(ExecutionReconciler& reconciler) {
+        reconciler.add_listener([this](const PositionDelta& delta) { on_position_delta(delta); });
+    }
     void update_metrics(const Order& order, const MarketDepth& depth);
     void calculate_var(const stable_vector<double>& returns, double confidence = 0.99);
     
@@ -33,6 +62,7 @@ public:
         std::atomic<double> daily_pnl{0.0};
         std::atomic<double> max_drawdown{0.0};
         std::atomic<int> message_count{0};
+        std::atomic<double> position{0.0};
         std::atomic<double> adverse_selection_cost{0.0};
         std::chrono::system_clock::time_point last_reset;
     };
@@ -49,6 +79,13 @@ public:
         std::chrono::steady_clock::time_point trigger_time;
     };
 
+    // Called on every trip, on the tripping thread with the risk lock held,
+    // so listeners must only hand the event off. Add them before trading.
+    using BreakerListener = std::function<void(const std::string& reason)>;
+    void add_breaker_listener(BreakerListener listener) {
+        breaker_listeners_.push_back(std::move(listener));
+    }
+
     void check_circuit_breakers() {
         std::lock_guard<std::mutex> lock(metrics_mutex_);
         
@@ -63,22 +100,27 @@ private:
     RiskLimits limits_;
     RiskMetrics metrics_;
     std::chrono::system_clock::time_point start_time_;
+    std::shared_ptr<const MarketDepth> live_depth_;
     
     // Thread-safe metric updates
     std::mutex metrics_mutex_;
-    stable_vector<double> price_history_;
+    static constexpr size_t PRICE_HISTORY_SIZE = 1001;
+    stable_ring<double> price_history_{PRICE_HISTORY_SIZE};
     stable_vector<double> pnl_history_;
     
     // Risk calculation helpers
-    double calculate_adverse_selection(const Order& order, const MarketDepth& depth);
+    double calculate_adverse_selection(const Order& order, double mid_price);
     double calculate_position_concentration(const std::string& symbol);
     bool run_stress_test(double var, double position_value);
     
     CircuitBreaker circuit_breaker_;
+    std::vector<BreakerListener> breaker_listeners_;
     
     void trigger_circuit_breaker(const std::string& reason) {
         circuit_breaker_.is_triggered = true;
         circuit_breaker_.trigger_time = std::chrono::steady_clock::now();
-        // Notify strategy manager to stop trading
+        for (const auto& listener : breaker_listeners_) {
+            listener(reason);
+        }
     }
 }; 
\ No newline at end of file
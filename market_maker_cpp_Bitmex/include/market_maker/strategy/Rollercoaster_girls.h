@@ -6,6 +6,7 @@
 #include <chrono>
 #include <string_view>
 #include "stable_vector.h"
+#include "feature_window.h"
 #include <torch/torch.h>
 #include "model/losses.h"
 #include "model/ssm_layer.h"
@@ -111,12 +112,25 @@ public:
             bool use_tensorrt{false};
             bool use_dynamic_batching{true};
             int inference_batch_size{64};
+            bool use_cuda{false};
         } inference;
+        
+        struct Preprocessing {
+            bool normalize{true};
+        } preprocessing;
     };
 
     explicit MarketPredictor(Config config);
     ~MarketPredictor();
 
+    // Runs the model on a consistent copy of the window's current contents,
+    // taken into per-thread input storage allocated on the first call; the
+    // window must be [num_channels x seq_len] as configured. Safe to call
+    // from several threads while the feed keeps committing to the window.
+    torch::Tensor predict(const FeatureWindow& window);
+    
+    const Config& config() const { return config_; }
+
     // ... previous declarations ...
 
 private:
@@ -163,5 +177,5 @@ private:
     double training_progress_{1.0};
     
     // Add helper method
-    torch::Tensor preprocess_features(const stable_vector<float>& features);
+    torch::Tensor preprocess_features(const FeatureWindow& window);
 }; 
\ No newline at end of file
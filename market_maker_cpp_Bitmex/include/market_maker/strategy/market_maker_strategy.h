@@ -3,7 +3,13 @@
 #include "market_data.h"
 #include "order_manager.h"
 #include "stable_vector.h"
+#include "stable_ring.h"
 #include "bitmex_connector.h"
+#include "kill_switch.h"
+#include "risk_manager.h"
+#include "book_kernels.h"
+#include "feature_window.h"
+#include "Rollercoaster_girls.h"
 #include <memory>
 #include <mutex>
 #include <atomic>
@@ -24,15 +30,26 @@ public:
         std::shared_ptr<MarketPredictor> predictor,
         std::shared_ptr<OrderManager> order_manager,
         std::shared_ptr<BitMEXConnector> bitmex_connector,
-        const Config& config)
+        const Config& config,
+        std::shared_ptr<RiskManager> risk_manager = nullptr)
         : predictor_(predictor)
         , order_manager_(order_manager)
         , bitmex_connector_(bitmex_connector)
+        , risk_manager_(risk_manager)
         , config_(config)
         , is_running_(false)
-        , active_orders_(256)  // Pre-allocate space for active orders
-        , market_data_history_(1024)  // Pre-allocate space for market data history
-    {}
+        , market_data_history_(MAX_HISTORY)
+        , error_history_(MAX_ERROR_HISTORY)
+    {
+        if (predictor_) {
+            const auto& model = predictor_->config().model_args;
+            if (static_cast<size_t>(model.num_channels) < book_kernels::NUM_BOOK_FEATURES) {
+                throw std::runtime_error("Predictor has fewer channels than the book features");
+            }
+            features_ = std::make_unique<FeatureWindow>(
+                static_cast<size_t>(model.seq_len), static_cast<size_t>(model.num_channels));
+        }
+    }
     
     virtual ~MarketMakingStrategy() {
         stop();
@@ -42,11 +59,12 @@ public:
         std::lock_guard<std::mutex> lock(strategy_mutex_);
         is_running_ = true;
         active_orders_.reserve(256);  // Reserve space for typical usage
-        market_data_history_.reserve(1024);  // Reserve space for market data history
+        start_kill_switch();
         return true;
     }
     
     virtual void stop() {
+        release_kill_switch();  // May send the last requests; not under our lock
         std::lock_guard<std::mutex> lock(strategy_mutex_);
         is_running_ = false;
         active_orders_.clear();
@@ -55,20 +73,45 @@ public:
 
     virtual void on_market_data(const MarketDepth& depth) = 0;
     
+    // The account's kill switch, shared with every other strategy on it;
+    // set before initialize(). Without one the strategy makes its own.
+    void use_kill_switch(std::shared_ptr<KillSwitch> kill_switch) {
+        kill_switch_ = std::move(kill_switch);
+    }
+    const std::shared_ptr<BitMEXConnector>& connector() const { return bitmex_connector_; }
+    
+    // Appends the book's features to the predictor's window, updated in
+    // place. StrategyManager calls this on the hub's publishing thread for
+    // every snapshot, which makes that thread the window's only writer;
+    // strategies read it with predictor_->predict(*features_).
+    void record_features(const MarketDepth& depth) {
+        if (features_) {
+            book_kernels::push_features(depth, *features_);
+        }
+    }
+    
     virtual void handle_error(const std::string& error_msg) {
         std::lock_guard<std::mutex> lock(strategy_mutex_);
-        error_history_.push_back(error_msg);
-        if (error_history_.size() > 1000) {  // Keep last 1000 errors
-            error_history_.erase(error_history_.begin());
-        }
+        error_history_.push_back(error_msg);  // Keeps the last MAX_ERROR_HISTORY errors
     }
 
 protected:
     std::shared_ptr<MarketPredictor> predictor_;
+    std::unique_ptr<FeatureWindow> features_;  // Null without a predictor
     std::shared_ptr<OrderManager> order_manager_;
     std::shared_ptr<BitMEXConnector> bitmex_connector_;
+    std::shared_ptr<RiskManager> risk_manager_;  // Optional; its breakers trip the kill switch
     Config config_;
     
+    // Held from initialize() to stop() whenever the strategy has a
+    // connector. After a cancel-all it empties OrderManager itself and
+    // raises quotes_cancelled_ for the strategy to drop its own record of
+    // resting quotes.
+    std::shared_ptr<KillSwitch> kill_switch_;
+    std::atomic<bool> quotes_cancelled_{false};
+    bool kill_switch_held_{false};
+    KillSwitch::ListenerId cancel_listener_{0};
+    
     // Strategy state
     std::atomic<bool> is_running_;
     std::mutex strategy_mutex_;
@@ -76,13 +119,51 @@ protected:
     // Use stable_vector for active orders to maintain pointer stability
     stable_vector<Order> active_orders_;
     
-    // Use stable_vector for market data history
-    stable_vector<MarketDepth> market_data_history_;
-    
-    // Use stable_vector for error history to avoid reallocation
-    stable_vector<std::string> error_history_;
+    // Rolling windows: bounded, O(1) eviction of the oldest entry
+    static constexpr size_t MAX_HISTORY = 1000;
+    static constexpr size_t MAX_ERROR_HISTORY = 1000;
+    stable_ring<MarketDepth> market_data_history_;
+    stable_ring<std::string> error_history_;
     
     bool is_running() const { return is_running_; }
+    bool trading_halted() const { return kill_switch_ && kill_switch_->tripped(); }
+    
+    void start_kill_switch() {
+        if (!bitmex_connector_ || kill_switch_held_) {
+            return;
+        }
+        if (!kill_switch_) {
+            kill_switch_ = std::make_shared<KillSwitch>(bitmex_connector_);
+        }
+        kill_switch_->attach(bitmex_connector_);
+        kill_switch_->attach(order_manager_);
+        cancel_listener_ = kill_switch_->add_cancel_listener([this] {
+            quotes_cancelled_.store(true, std::memory_order_release);
+        });
+        if (risk_manager_) {
+            // The risk manager may outlive us; a late breaker is a no-op
+            risk_manager_->add_breaker_listener(
+                [kill_switch = std::weak_ptr<KillSwitch>(kill_switch_)](const std::string& reason) {
+                    if (auto live = kill_switch.lock()) {
+                        live->trip(reason);
+                    }
+                });
+        }
+        kill_switch_->acquire();
+        kill_switch_held_ = true;
+    }
+    
+    // Only the last strategy to let go stops the switch and disarms the
+    // exchange timer for the account
+    void release_kill_switch() {
+        if (!kill_switch_held_) {
+            return;
+        }
+        kill_switch_held_ = false;
+        kill_switch_->remove_cancel_listener(cancel_listener_);
+        kill_switch_->detach(order_manager_);
+        kill_switch_->release();
+    }
     
     virtual bool validate_market_data(const MarketDepth& depth) const {
         return depth.is_valid();
@@ -91,14 +172,7 @@ protected:
     // Helper method to maintain market data history
     void update_market_history(const MarketDepth& depth) {
         std::lock_guard<std::mutex> lock(strategy_mutex_);
-        market_data_history_.push_back(depth);
-        
-        // Keep a fixed window of history
-        static constexpr size_t MAX_HISTORY = 1000;
-        if (market_data_history_.size() > MAX_HISTORY) {
-            // Remove oldest entries
-            market_data_history_.erase(market_data_history_.begin());
-        }
+        market_data_history_.push_back(depth);  // Evicts the oldest once full
     }
     
     // Helper method to update active orders
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "order_manager.h"
+#include "bitmex_connector.h"
+#include "fixed_point.h"
+#include <memory>
+#include <vector>
+
+// Keeps resting quotes in line with the strategy's desired ladder using as
+// few exchange messages as possible.
+//
+// Each tick the desired levels of a side (best first) are matched by rank to
+// the orders already resting there. A matched level is left alone unless its
+// price moved by at least amend_ticks or its size by at least amend_lots, in
+// which case it is amended in place. Only levels that appear or disappear
+// produce a new order or a cancel. On a quiet market most ticks therefore
+// produce no messages at all.
+//
+// Places and amends are reserved in OrderManager and appended to an OrderBatch
+// for the caller to send; cancels stay in OrderManager until the exchange has
+// accepted them. Once the batch is sent, settle() applies what was accepted
+// and undoes the rest, so local state never runs ahead of the exchange. Not
+// thread-safe: the owner serialises update() through settle(), e.g. under a
+// per-strategy mutex when ticks run on a pool.
+class QuoteManager {
+public:
+    struct Config {
+        int max_levels = 3;         // Per side
+        int64_t amend_ticks = 1;    // Smallest price move worth an amend
+        int64_t amend_lots = 1;     // Smallest size change worth an amend
+        double tick_size = 0.5;
+        double lot_size = 1.0;
+    };
+
+    struct Quote {
+        double price;
+        double quantity;
+    };
+
+    QuoteManager(std::shared_ptr<OrderManager> order_manager, Config config);
+
+    // Diffs both sides and appends the resulting actions to `batch`. Levels
+    // beyond max_levels are ignored; an empty side cancels everything there.
+    void update(const Quote* bids, size_t bid_count,
+                const Quote* asks, size_t ask_count,
+                OrderBatch& batch);
+
+    // Cancels every resting quote
+    void cancel_all(OrderBatch& batch);
+
+    // Call after sending the batch of update() or cancel_all(). Accepted
+    // cancels leave OrderManager. Refused places are cancelled locally,
+    // refused amends go back to the price and size still resting, and levels
+    // whose cancel was refused are resting again.
+    void settle(const OrderBatch& batch, const BatchResult& result);
+
+    // settle() for a batch the exchange accepted none of
+    void rollback(const OrderBatch& batch) { settle(batch, BatchResult{}); }
+
+    // Forgets every resting level without sending anything, for after a
+    // cancel-all the exchange accepted. Leaves OrderManager alone; whoever
+    // sent the cancel-all clears it.
+    void forget();
+
+    size_t resting(OrderSide side) const { return side_of(side).size(); }
+
+private:
+    struct Resting {
+        int64_t order_id;
+        Price price;
+        Qty quantity;
+    };
+
+    std::shared_ptr<OrderManager> order_manager_;
+    Config config_;
+    TickSize tick_size_;
+    TickSize lot_size_;
+    std::vector<Resting> bids_;  // Best first, at most max_levels
+    std::vector<Resting> asks_;
+
+    // Levels as they rested before this batch touched them, until settle()
+    struct Pending {
+        OrderSide side;
+        Resting resting;
+    };
+    std::vector<Pending> amended_;
+    std::vector<Pending> cancelled_;
+
+    std::vector<Resting>& side_of(OrderSide side) { return side == OrderSide::BUY ? bids_ : asks_; }
+    const std::vector<Resting>& side_of(OrderSide side) const {
+        return side == OrderSide::BUY ? bids_ : asks_;
+    }
+
+    void update_side(OrderSide side, const Quote* quotes, size_t count, OrderBatch& batch);
+    void cancel(OrderSide side, const Resting& resting, OrderBatch& batch);
+    void restore(const Pending& pending);
+    static const Pending* find(const std::vector<Pending>& pending, int64_t order_id);
+};
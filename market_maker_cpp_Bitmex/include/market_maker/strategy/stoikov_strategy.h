@@ -1,6 +1,8 @@
 #pragma once
 
 #include "market_maker_strategy.h"
+#include "quote_manager.h"
+#include "stable_ring.h"
 #include <cmath>
 #include <ctime>
 
@@ -15,6 +17,7 @@ public:
         double drift{0.1};                // Price drift term
         double min_intensity{0.01};       // Minimum order intensity threshold
         double position_limit{10.0};      // Maximum position size
+        QuoteManager::Config quoting;     // Amend thresholds and instrument increments
     };
     
     explicit StoikovStrategy(
@@ -23,8 +26,10 @@ public:
         StoikovConfig config)
         : MarketMakingStrategy(predictor, order_manager, config)
         , config_(config)
-        , volatility_estimator_(config.volatility_window)
-        , start_time_(std::time(nullptr)) {}
+        , start_time_(std::time(nullptr))
+        , volatility_estimator_(static_cast<size_t>(config.volatility_window))
+        , price_history_(static_cast<size_t>(config.volatility_window))
+        , quote_manager_(order_manager, config.quoting) {}
     
 private:
     StoikovConfig config_;
@@ -33,17 +38,12 @@ private:
     class VolatilityEstimator {
     public:
         explicit VolatilityEstimator(size_t window_size)
-            : window_size_(window_size) {
-            returns_.reserve(window_size);
-        }
+            : returns_(window_size) {}
         
         void update(double price) {
             if (last_price_ > 0) {
-                double ret = std::log(price / last_price_);
-                if (returns_.size() >= window_size_) {
-                    returns_.erase(returns_.begin());
-                }
-                returns_.push_back(ret);
+                // Oldest return is evicted once the window is full
+                returns_.push_back(std::log(price / last_price_));
             }
             last_price_ = price;
         }
@@ -67,9 +67,8 @@ private:
         }
         
     private:
-        const size_t window_size_;
         double last_price_{0.0};
-        std::vector<double> returns_;
+        stable_ring<double> returns_;
     };
     
     VolatilityEstimator volatility_estimator_;
@@ -77,7 +76,13 @@ private:
     // Thread-safe price/volatility updates
     std::mutex market_data_mutex_;
     std::condition_variable market_data_cv_;
-    stable_vector<double> price_history_;
+    stable_ring<double> price_history_;
+    
+    // Resting quotes and the order actions of the current tick, flushed
+    // together. Both belong to whichever tick holds quote_mutex_.
+    std::mutex quote_mutex_;
+    QuoteManager quote_manager_;
+    OrderBatch order_batch_;
     
     // Stoikov-specific calculations
     double calculate_optimal_spread(double volatility, double inventory);
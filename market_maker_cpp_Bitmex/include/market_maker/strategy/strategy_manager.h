@@ -1,6 +1,7 @@
 #pragma once
 
 #include "stoikov_strategy.h"
+#include "market_data_hub.h"
 #include "thread_pool.h"
 #include <unordered_map>
 #include <chrono>
@@ -17,19 +18,43 @@ public:
     explicit StrategyManager(size_t num_threads = std::thread::hardware_concurrency())
         : thread_pool_(num_threads) {}
     
+    // Before the strategy's initialize(): every strategy trading on one
+    // account is given that account's single kill switch
     void add_strategy(
         const std::string& symbol,
         std::shared_ptr<MarketMakingStrategy> strategy) {
         std::lock_guard<std::mutex> lock(strategies_mutex_);
+        if (const auto& connector = strategy->connector()) {
+            const auto& account = connector->config();
+            auto& kill_switch = kill_switches_[account.base_url + " " + account.api_key];
+            if (!kill_switch) {
+                kill_switch = std::make_shared<KillSwitch>(connector);
+            }
+            strategy->use_kill_switch(kill_switch);
+        }
         strategies_[symbol] = strategy;
     }
     
-    void on_market_data(const std::string& symbol, const MarketDepth& depth) {
+    // Feeds every snapshot the hub publishes for symbol into on_market_data
+    MarketDataHub::SubscriptionId subscribe(MarketDataHub& hub, const std::string& symbol) {
+        return hub.subscribe(symbol,
+            [this](const std::string& sym, const MarketDataHub::Snapshot& snapshot) {
+                on_market_data(sym, snapshot);
+            });
+    }
+    
+    // The book is shared, not copied, and the feed may keep updating it in
+    // place while a task runs. Strategies must take one read_consistent()
+    // view per callback (get_mid_price() and friends are such reads) and
+    // never read its fields directly.
+    void on_market_data(const std::string& symbol, std::shared_ptr<const MarketDepth> depth) {
         auto strategy = get_strategy(symbol);
         if (strategy && is_strategy_healthy(symbol)) {
-            thread_pool_.enqueue([this, strategy, symbol, depth] {
+            // Inline, in publish order; the predictor's window has one writer
+            strategy->record_features(*depth);
+            thread_pool_.enqueue([this, strategy, symbol, depth = std::move(depth)] {
                 try {
-                    strategy->on_market_data(depth);
+                    strategy->on_market_data(*depth);
                 } catch (const ExchangeError& e) {
                     handle_exchange_error(symbol, e);
                 } catch (const std::exception& e) {
@@ -49,6 +74,9 @@ private:
     std::mutex strategies_mutex_;
     std::unordered_map<std::string, std::shared_ptr<MarketMakingStrategy>> strategies_;
     std::unordered_map<std::string, StrategyState> strategy_states_;
+    // By account (REST base URL and API key): cancel-all and the exchange's
+    // dead man's switch act on the whole account, not one symbol
+    std::unordered_map<std::string, std::shared_ptr<KillSwitch>> kill_switches_;
     
     std::shared_ptr<MarketMakingStrategy> get_strategy(const std::string& symbol) {
         std::lock_guard<std::mutex> lock(strategies_mutex_);
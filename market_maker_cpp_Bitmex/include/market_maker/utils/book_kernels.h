@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include "depth_soa.h"
+#include "feature_window.h"
+
+// Vectorised order book kernels over contiguous price/quantity arrays.
+// Compiled for AVX-512 or AVX2 when the library is configured with those
+// extensions (ENABLE_AVX2 / ENABLE_AVX512, both off by default), with a
+// scalar fallback otherwise. All kernels treat zero-quantity levels as empty.
+namespace book_kernels {
+
+struct SweepResult {
+    double filled{0.0};    // Quantity that the visible book could absorb
+    double notional{0.0};  // Sum of price * quantity taken
+};
+
+// Sum of qty[0..n)
+double cumulative_depth(const double* qty, size_t n);
+
+// Walks the levels best-first taking up to size
+SweepResult sweep(const double* px, const double* qty, size_t n, double size);
+
+// Average fill price for size; 0 when the side is empty
+double vwap_to_size(const double* px, const double* qty, size_t n, double size);
+
+// Absolute cost of sweeping size relative to reference_price
+double sweep_cost(const double* px, const double* qty, size_t n, double size, double reference_price);
+
+// (bid depth - ask depth) / (bid depth + ask depth) over the top n levels
+double imbalance(const double* bid_qty, const double* ask_qty, size_t n);
+
+// Fixed-width book features for the predictor, written to out[0..NUM_BOOK_FEATURES)
+inline constexpr size_t NUM_BOOK_FEATURES = 8;
+void extract_features(const DepthSoA& book, float* out);
+
+// Appends one sample to the predictor's window: the book features go into
+// its first NUM_BOOK_FEATURES channels, straight into the staging row, and
+// any further channels keep what the caller staged. Writer side of window.
+void push_features(const MarketDepth& depth, FeatureWindow& window);
+
+// "avx512", "avx2" or "scalar", for logging
+const char* simd_level();
+
+// DepthSoA conveniences
+inline double cumulative_depth(const DepthSoA& book, BookSide side, size_t levels = DepthSoA::LEVELS) {
+    return cumulative_depth(book.qty(side), levels);
+}
+
+inline double vwap_to_size(const DepthSoA& book, BookSide side, double size) {
+    return vwap_to_size(book.px(side), book.qty(side), book.levels(side), size);
+}
+
+inline double sweep_cost(const DepthSoA& book, BookSide side, double size, double reference_price) {
+    return sweep_cost(book.px(side), book.qty(side), book.levels(side), size, reference_price);
+}
+
+inline double imbalance(const DepthSoA& book, size_t levels) {
+    return imbalance(book.bid_qty, book.ask_qty, levels);
+}
+
+} // namespace book_kernels
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "cache_line.h"
+#include "spin_wait.h"
+
+// Rolling [num_channels x seq_len] feature window laid out for the predictor.
+//
+// Every channel owns a mirrored row of 2 * seq_len floats and each sample is
+// written twice, at i and i + seq_len. The last seq_len samples of a channel
+// are therefore always one contiguous run starting at offset(), so the whole
+// window can be handed to the model as a strided view of the buffer without
+// copying or unrolling. Rows are padded to a cache line and the buffer is
+// allocated once, 64-byte aligned.
+//
+// Running sum and sum of squares are kept per channel for normalisation and
+// recomputed exactly once per wrap so float drift cannot build up.
+//
+// One writer (staging()/commit()/push()/clear()) and any number of readers.
+// The accessors below read in place and are only safe on the writer's
+// thread; other threads take a copy with snapshot(), which is seqlocked
+// against commit() like MarketDepth::read_consistent().
+class FeatureWindow {
+public:
+    FeatureWindow(size_t seq_len, size_t num_channels)
+        : seq_len_(seq_len)
+        , num_channels_(num_channels)
+        , row_stride_(round_up(2 * seq_len, CACHE_LINE_SIZE / sizeof(float)))
+        , data_(allocate(row_stride_ * num_channels))
+        , staging_(num_channels, 0.0f)
+        , sum_(num_channels, 0.0)
+        , sum_sq_(num_channels, 0.0) {
+        if (seq_len == 0 || num_channels == 0) {
+            throw std::runtime_error("FeatureWindow requires non-empty dimensions");
+        }
+        std::memset(data_.get(), 0, row_stride_ * num_channels_ * sizeof(float));
+    }
+
+    FeatureWindow(const FeatureWindow&) = delete;
+    FeatureWindow& operator=(const FeatureWindow&) = delete;
+
+    // Scratch row for the next sample, one value per channel. Fill it (e.g.
+    // with book_kernels::extract_features) and then call commit().
+    float* staging() { return staging_.data(); }
+
+    void commit() {
+        begin_write();
+        const size_t slot = next_;
+        for (size_t c = 0; c < num_channels_; ++c) {
+            float* row = data_.get() + c * row_stride_;
+            const double evicted = row[slot];
+            const double value = staging_[c];
+            sum_[c] += value - evicted;
+            sum_sq_[c] += value * value - evicted * evicted;
+            row[slot] = staging_[c];
+            row[slot + seq_len_] = staging_[c];
+        }
+
+        if (count_ < seq_len_) {
+            ++count_;
+        }
+        if (++next_ == seq_len_) {
+            next_ = 0;
+            recompute_moments();
+        }
+        end_write();
+    }
+
+    void push(const float* features) {
+        std::memcpy(staging_.data(), features, num_channels_ * sizeof(float));
+        commit();
+    }
+
+    void clear() {
+        begin_write();
+        std::memset(data_.get(), 0, row_stride_ * num_channels_ * sizeof(float));
+        next_ = 0;
+        count_ = 0;
+        std::fill(sum_.begin(), sum_.end(), 0.0);
+        std::fill(sum_sq_.begin(), sum_sq_.end(), 0.0);
+        end_write();
+    }
+
+    // Consistent copy from any thread: out receives [num_channels x seq_len]
+    // floats, oldest first per channel, and mean/stddev (if given) the
+    // per-channel moments of that same version of the window
+    void snapshot(float* out, double* mean = nullptr, double* stddev = nullptr) const {
+        for (;;) {
+            const uint64_t seq = sequence_.load(std::memory_order_acquire);
+            if (seq & 1) {
+                cpu_relax();
+                continue;
+            }
+            const size_t start = next_;
+            for (size_t c = 0; c < num_channels_; ++c) {
+                std::memcpy(out + c * seq_len_, data_.get() + c * row_stride_ + start,
+                            seq_len_ * sizeof(float));
+                if (mean) mean[c] = channel_mean(c);
+                if (stddev) stddev[c] = channel_stddev(c);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == seq) {
+                return;
+            }
+        }
+    }
+
+    // Oldest-to-newest samples of channel c, seq_len() contiguous floats.
+    // Slots not yet written read as zero.
+    const float* channel(size_t c) const { return data_.get() + c * row_stride_ + next_; }
+
+    // Raw layout for building a strided view: element (c, t) lives at
+    // data()[c * row_stride() + offset() + t]
+    const float* data() const { return data_.get(); }
+    size_t offset() const { return next_; }
+    size_t row_stride() const { return row_stride_; }
+
+    size_t seq_len() const { return seq_len_; }
+    size_t num_channels() const { return num_channels_; }
+    size_t size() const { return count_; }
+    bool full() const { return count_ == seq_len_; }
+
+    // Moments of channel c over its seq_len values (unfilled slots count as
+    // zero), matching tensor.mean() / tensor.std() on that channel's row.
+    // Channels carry different units, so they are never pooled.
+    double mean(size_t c) const { return channel_mean(c); }
+    double stddev(size_t c) const { return channel_stddev(c); }
+
+private:
+    struct AlignedDelete {
+        void operator()(float* p) const {
+            ::operator delete[](p, std::align_val_t(CACHE_LINE_SIZE));
+        }
+    };
+
+    static std::unique_ptr<float[], AlignedDelete> allocate(size_t n) {
+        return std::unique_ptr<float[], AlignedDelete>(static_cast<float*>(
+            ::operator new[](n * sizeof(float), std::align_val_t(CACHE_LINE_SIZE))));
+    }
+
+    static size_t round_up(size_t n, size_t multiple) {
+        return (n + multiple - 1) / multiple * multiple;
+    }
+
+    double channel_mean(size_t c) const { return sum_[c] / static_cast<double>(seq_len_); }
+    double channel_stddev(size_t c) const {
+        const double n = static_cast<double>(seq_len_);
+        if (n < 2.0) {
+            return 0.0;
+        }
+        const double var = (sum_sq_[c] - sum_[c] * sum_[c] / n) / (n - 1.0);
+        return var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+
+    void begin_write() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void end_write() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void recompute_moments() {
+        for (size_t c = 0; c < num_channels_; ++c) {
+            const float* row = channel(c);
+            double sum = 0.0;
+            double sum_sq = 0.0;
+            for (size_t t = 0; t < seq_len_; ++t) {
+                sum += row[t];
+                sum_sq += static_cast<double>(row[t]) * row[t];
+            }
+            sum_[c] = sum;
+            sum_sq_[c] = sum_sq;
+        }
+    }
+
+    size_t seq_len_;
+    size_t num_channels_;
+    size_t row_stride_;
+    std::unique_ptr<float[], AlignedDelete> data_;
+    std::vector<float> staging_;
+
+    std::vector<double> sum_;     // Per channel
+    std::vector<double> sum_sq_;
+
+    size_t next_{0};   // Slot the next sample goes to; also the window start
+    size_t count_{0};
+    std::atomic<uint64_t> sequence_{0};  // Odd while commit()/clear() is writing
+};
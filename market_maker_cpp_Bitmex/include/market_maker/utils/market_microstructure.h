@@ -40,6 +40,7 @@ public:
         std::vector<BookLevel> bids;
         std::vector<BookLevel> asks;
         std::chrono::nanoseconds timestamp;
+        double imbalance{0.0};  // Top IMBALANCE_LEVELS, from the book kernels
         
         double get_weighted_midprice(size_t levels = 5) const;
         double calculate_imbalance(size_t levels = 5) const;
@@ -53,6 +54,7 @@ public:
     
 private:
     static constexpr size_t HISTORY_SIZE = 1000;
+    static constexpr size_t IMBALANCE_LEVELS = 5;
     std::deque<OrderBookSnapshot> book_history_;
     std::unordered_map<int64_t, std::chrono::nanoseconds> order_timestamps_;
     
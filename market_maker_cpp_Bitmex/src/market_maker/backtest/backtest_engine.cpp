@@ -1,8 +1,10 @@
 #include "backtest_engine.h"
+#include "book_kernels.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <execution>
+#include <limits>
 
 BacktestEngine::BacktestResults BacktestEngine::run() {
     BacktestResults results;
@@ -11,23 +13,23 @@ BacktestEngine::BacktestResults BacktestEngine::run() {
     // Load market data
     load_market_data();
     
-    // Initialize result containers
-    results.equity_curve.reserve(market_data_.size());
-    results.drawdown_curve.reserve(market_data_.size());
-    results.position_history.reserve(market_data_.size());
-    
     double high_water_mark = current_capital_;
     double max_drawdown = 0.0;
     
-    // Warm-up period
-    for (size_t i = 0; i < config_.warm_up_bars && i < market_data_.size(); ++i) {
-        strategy_->on_market_data(market_data_[i]);
-    }
+    // Books are rebuilt in place straight from the mapped journal
+    TickJournalReplay replay(market_data_);
+    MarketDepth depth;
+    size_t step = 0;
     
     // Main backtest loop
-    #pragma omp parallel for if(market_data_.size() > 10000)
-    for (size_t i = config_.warm_up_bars; i < market_data_.size(); ++i) {
-        const auto& depth = market_data_[i];
+    while (replay.next(depth)) {
+        benchmark_prices_.push_back(depth.get_mid_price());
+        
+        // Warm-up period
+        if (step++ < config_.warm_up_bars) {
+            strategy_->on_market_data(depth);
+            continue;
+        }
         
         // Strategy execution
         strategy_->on_market_data(depth);
@@ -90,6 +92,23 @@ BacktestEngine::BacktestResults BacktestEngine::run() {
     return results;
 }
 
+void BacktestEngine::load_market_data() {
+    journal_ = std::make_unique<TickJournalReader>(config_.data_path);
+    
+    auto to_ns = [](std::chrono::system_clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            t.time_since_epoch()).count();
+    };
+    
+    const int64_t start_ns = to_ns(config_.start_time);
+    const int64_t end_ns = config_.end_time.time_since_epoch().count() > 0
+        ? to_ns(config_.end_time)
+        : std::numeric_limits<int64_t>::max();
+    
+    market_data_ = journal_->range(start_ns, end_ns);
+    benchmark_prices_ = stable_vector<double>();
+}
+
 void BacktestEngine::analyze_results() {
     // Calculate advanced metrics
     auto calculate_returns = [](const stable_vector<double>& prices) {
@@ -105,13 +124,8 @@ void BacktestEngine::analyze_results() {
     // Calculate strategy returns
     auto strategy_returns = calculate_returns(results.equity_curve);
     
-    // Calculate benchmark returns (assuming market_data_ contains benchmark prices)
-    stable_vector<double> benchmark_prices;
-    std::transform(market_data_.begin(), market_data_.end(),
-                  std::back_inserter(benchmark_prices),
-                  [](const MarketDepth& depth) { return depth.get_mid_price(); });
-    
-    auto benchmark_returns = calculate_returns(benchmark_prices);
+    // Calculate benchmark returns from the mid prices seen during replay
+    auto benchmark_returns = calculate_returns(benchmark_prices_);
     
     // Update performance metrics
     performance_monitor_.calculate_performance_metrics(
@@ -131,28 +145,12 @@ double BacktestEngine::calculate_slippage(
     double base_slippage = order.price * (config_.slippage_bps / 10000.0);
     
     // Add market impact based on order size relative to available liquidity
-    double market_impact = 0.0;
-    if (order.side == OrderSide::BUY) {
-        double available_liquidity = std::accumulate(
-            depth.asks.begin(),
-            depth.asks.end(),
-            0.0,
-            [](double sum, const MarketDepth::Level& level) {
-                return sum + level.quantity;
-            }
-        );
-        market_impact = base_slippage * (order.quantity / available_liquidity);
-    } else {
-        double available_liquidity = std::accumulate(
-            depth.bids.begin(),
-            depth.bids.end(),
-            0.0,
-            [](double sum, const MarketDepth::Level& level) {
-                return sum + level.quantity;
-            }
-        );
-        market_impact = base_slippage * (order.quantity / available_liquidity);
-    }
+    const DepthSoA book(depth);
+    const BookSide side = order.side == OrderSide::BUY ? BookSide::ASK : BookSide::BID;
+    double available_liquidity = book_kernels::cumulative_depth(book, side);
+    double market_impact = available_liquidity > 0.0
+        ? base_slippage * (order.quantity / available_liquidity)
+        : 0.0;
     
     return base_slippage + market_impact;
 } 
\ No newline at end of file
@@ -0,0 +1,1114 @@
+#include "local_bitmex_exchange.h"
+#include "order_book_simulator.h"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <future>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+using json = nlohmann::json;
+
+namespace {
+
+// orderBookL2 level ids count down from here, one per tick, as on BitMEX
+constexpr int64_t LEVEL_ID_BASE = 8'800'000'000;
+
+// Answered as {"error":{"message","name"}} with the given status
+struct RequestError : std::runtime_error {
+    RequestError(int status, const std::string& message, std::string name = "HTTPError")
+        : std::runtime_error(message), status(status), name(std::move(name)) {}
+    int status;
+    std::string name;
+};
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t epoch_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string timestamp(std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) {
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count() % 1000;
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                  utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
+                  utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(millis));
+    return buf;
+}
+
+const char* side_name(OrderSide side) { return side == OrderSide::BUY ? "Buy" : "Sell"; }
+
+std::string url_decode(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '+') {
+            out += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size() &&
+                   std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+                   std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            out += static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else {
+            out += text[i];
+        }
+    }
+    return out;
+}
+
+// key=value pairs of a query string, decoded
+std::map<std::string, std::string> parse_query(const std::string& query) {
+    std::map<std::string, std::string> params;
+    size_t start = 0;
+    while (start < query.size()) {
+        size_t end = query.find('&', start);
+        if (end == std::string::npos) {
+            end = query.size();
+        }
+        const std::string pair = query.substr(start, end - start);
+        const size_t eq = pair.find('=');
+        if (!pair.empty()) {
+            params[url_decode(pair.substr(0, eq))] =
+                eq == std::string::npos ? "" : url_decode(pair.substr(eq + 1));
+        }
+        start = end + 1;
+    }
+    return params;
+}
+
+}  // namespace
+
+struct LocalBitMEXExchange::Impl {
+    struct LiveOrder {
+        int64_t id;              // Simulator id
+        std::string order_id;    // Exchange UUID
+        std::string cl_ord_id;
+        OrderSide side;
+        double price;
+        double order_qty;
+        double cum_qty{0.0};
+        double avg_px{0.0};
+        bool post_only{false};
+        std::string status;
+        std::string text;
+    };
+
+    class WsSession;
+    class HttpSession;
+
+    Config config;
+    net::io_context ioc;
+    net::executor_work_guard<net::io_context::executor_type> work{ioc.get_executor()};
+    tcp::acceptor acceptor;
+    std::thread thread;
+    std::mt19937_64 rng{std::random_device{}()};
+
+    // Everything below is touched only on the I/O thread
+    OrderBookSimulator book;
+    int64_t next_id{1};
+    std::unordered_map<int64_t, LiveOrder> orders;  // Client orders still open
+    // Closed client orders, kept for the session so GET /order still finds
+    // them and their clOrdIDs stay taken
+    std::unordered_map<int64_t, LiveOrder> done;
+    net::steady_timer dead_man_switch{ioc};          // Armed by POST /order/cancelAllAfter
+    std::unordered_map<std::string, int64_t> by_cl_ord_id;  // Open and closed orders
+    std::unordered_map<std::string, int64_t> by_order_id;
+    std::map<std::pair<OrderSide, int64_t>, int64_t> background;  // (side, ticks) -> id
+    std::unordered_map<int64_t, std::pair<OrderSide, int64_t>> background_ids;
+    std::map<int64_t, double> published[2];  // Ticks -> size last sent on orderBookL2
+    std::vector<OrderBookSimulator::BookLevel> levels_scratch;
+    double net_position{0.0};
+
+    std::vector<std::weak_ptr<WsSession>> sessions;
+
+    int64_t window_start{0};
+    int window_used{0};
+    int forced_429{0};
+    int forced_retry_after{1};
+    int forced_503{0};
+    uint64_t request_count{0};
+    RequestListener listener;
+
+    explicit Impl(Config cfg)
+        : config(std::move(cfg))
+        , acceptor(ioc)
+        , book(OrderBookSimulator::SimConfig{
+              .base_tick_size = config.tick_size,
+              .base_lot_size = config.lot_size,
+              .simulate_latency = false}) {
+        const tcp::endpoint endpoint(net::ip::make_address("127.0.0.1"), config.port);
+        acceptor.open(endpoint.protocol());
+        acceptor.set_option(net::socket_base::reuse_address(true));
+        acceptor.bind(endpoint);
+        acceptor.listen();
+    }
+
+    // Runs fn on the I/O thread and waits for its result; inline before
+    // start(), when nothing else can be touching the state
+    template <class F>
+    auto call(F&& fn) -> decltype(fn()) {
+        if (!thread.joinable()) {
+            return fn();
+        }
+        std::packaged_task<decltype(fn())()> task(std::forward<F>(fn));
+        auto result = task.get_future();
+        net::post(ioc, [&task] { task(); });
+        return result.get();
+    }
+
+    std::chrono::nanoseconds delay(std::chrono::microseconds base) {
+        auto extra = std::chrono::microseconds(0);
+        if (config.latency_jitter.count() > 0) {
+            extra = std::chrono::microseconds(
+                std::uniform_int_distribution<int64_t>(0, config.latency_jitter.count())(rng));
+        }
+        return base + extra;
+    }
+
+    int64_t ticks(double price) const { return std::llround(price / config.tick_size); }
+
+    std::string uuid() {
+        const uint64_t hi = rng();
+        const uint64_t lo = rng();
+        char buf[37];
+        std::snprintf(buf, sizeof(buf), "%08x-%04x-%04x-%04x-%012llx",
+                      static_cast<unsigned>(hi >> 32), static_cast<unsigned>((hi >> 16) & 0xffff),
+                      static_cast<unsigned>(hi & 0xffff), static_cast<unsigned>(lo >> 48),
+                      static_cast<unsigned long long>(lo & 0xffffffffffffULL));
+        return buf;
+    }
+
+    void accept();
+    void broadcast(const std::string& table, const std::string& text);
+    void on_ws_message(WsSession& session, const std::string& text);
+
+    http::response<http::string_body> handle(const http::request<http::string_body>& request);
+    json route(http::verb verb, const std::string& path, const std::string& query, const json& body);
+
+    // Order entry
+    LiveOrder validate_place(const json& request) const;
+    json place(const json& request);
+    json place(LiveOrder order);
+    int64_t locate(const json& request) const;
+    int64_t open_id(int64_t id) const;
+    json amend(const json& request);
+    json cancel(int64_t id, const std::string& text);
+    json cancel_request(const json& request);
+    json cancel_all(const std::string& text);
+    json cancel_all_after(const json& request);
+    void settle();
+    void apply_fill(int64_t id, double price, double quantity);
+    void close(int64_t id);
+    const LiveOrder& lookup(int64_t id) const;
+    json list_orders(const std::string& query) const;
+
+    // Feed
+    json order_row(const LiveOrder& order) const;
+    void publish_execution(const LiveOrder& order, const char* exec_type,
+                           double last_px = 0.0, double last_qty = 0.0);
+    void publish_book();
+    json book_row(OrderSide side, int64_t level_ticks, double size, bool with_price) const;
+    std::string book_partial() const;
+
+    // Background liquidity
+    void set_level(OrderSide side, double price, double size);
+    void trade(OrderSide side, double price, double quantity);
+};
+
+class LocalBitMEXExchange::Impl::WsSession : public std::enable_shared_from_this<WsSession> {
+public:
+    WsSession(Impl& exchange, tcp::socket socket)
+        : exchange_(exchange)
+        , ws_(std::move(socket))
+        , timer_(exchange.ioc) {}
+
+    void accept(http::request<http::string_body> request) {
+        upgrade_ = std::move(request);
+        ws_.async_accept(upgrade_, [self = shared_from_this()](beast::error_code ec) {
+            if (ec) return self->close();
+            self->push(R"({"info":"Welcome to the BitMEX Realtime API.","version":"local"})");
+            self->read();
+        });
+    }
+
+    // Queued behind earlier frames; delivered once its injected delay passed
+    void push(std::string text) {
+        if (!open_) {
+            return;
+        }
+        auto due = std::chrono::steady_clock::now() + exchange_.delay(exchange_.config.ws_latency);
+        if (!outbox_.empty()) {
+            due = std::max(due, outbox_.back().due);
+        }
+        outbox_.push_back({due, std::move(text)});
+        flush();
+    }
+
+    bool subscribed(const std::string& table) const { return tables_.count(table) > 0; }
+    void subscribe(const std::string& table) { tables_.insert(table); }
+
+    void close() {
+        if (!open_) {
+            return;
+        }
+        open_ = false;
+        timer_.cancel();
+        beast::error_code ignored;
+        beast::get_lowest_layer(ws_).socket().close(ignored);
+    }
+
+private:
+    struct Outgoing {
+        std::chrono::steady_clock::time_point due;
+        std::string text;
+    };
+
+    void read() {
+        ws_.async_read(buffer_, [self = shared_from_this()](beast::error_code ec, size_t) {
+            if (ec) return self->close();
+            const std::string text = beast::buffers_to_string(self->buffer_.data());
+            self->buffer_.consume(self->buffer_.size());
+            self->exchange_.on_ws_message(*self, text);
+            self->read();
+        });
+    }
+
+    void flush() {
+        if (writing_ || waiting_ || outbox_.empty() || !open_) {
+            return;
+        }
+        if (outbox_.front().due > std::chrono::steady_clock::now()) {
+            waiting_ = true;
+            timer_.expires_at(outbox_.front().due);
+            timer_.async_wait([self = shared_from_this()](beast::error_code ec) {
+                self->waiting_ = false;
+                if (!ec) self->flush();
+            });
+            return;
+        }
+        writing_ = true;
+        ws_.text(true);
+        ws_.async_write(net::buffer(outbox_.front().text),
+            [self = shared_from_this()](beast::error_code ec, size_t) {
+                self->writing_ = false;
+                if (ec) return self->close();
+                self->outbox_.pop_front();
+                self->flush();
+            });
+    }
+
+    Impl& exchange_;
+    http::request<http::string_body> upgrade_;
+    websocket::stream<beast::tcp_stream> ws_;
+    beast::flat_buffer buffer_;
+    net::steady_timer timer_;
+    std::deque<Outgoing> outbox_;
+    std::set<std::string> tables_;
+    bool writing_{false};
+    bool waiting_{false};
+    bool open_{true};
+};
+
+class LocalBitMEXExchange::Impl::HttpSession : public std::enable_shared_from_this<HttpSession> {
+public:
+    HttpSession(Impl& exchange, tcp::socket socket)
+        : exchange_(exchange)
+        , stream_(std::move(socket))
+        , timer_(exchange.ioc) {}
+
+    void read() {
+        request_ = {};
+        http::async_read(stream_, buffer_, request_,
+            [self = shared_from_this()](beast::error_code ec, size_t) {
+                if (ec) return self->close();
+                self->on_request();
+            });
+    }
+
+private:
+    void on_request() {
+        // The realtime endpoint shares the port, as on the real exchange
+        if (websocket::is_upgrade(request_)) {
+            auto session = std::make_shared<WsSession>(exchange_, stream_.release_socket());
+            auto& sessions = exchange_.sessions;
+            sessions.erase(std::remove_if(sessions.begin(), sessions.end(),
+                [](const std::weak_ptr<WsSession>& s) { return s.expired(); }), sessions.end());
+            sessions.push_back(session);
+            session->accept(std::move(request_));
+            return;
+        }
+
+        response_ = exchange_.handle(request_);
+        const auto delay = exchange_.delay(exchange_.config.rest_latency);
+        if (delay.count() == 0) {
+            return write();
+        }
+        timer_.expires_after(delay);
+        timer_.async_wait([self = shared_from_this()](beast::error_code) { self->write(); });
+    }
+
+    void write() {
+        http::async_write(stream_, response_, [self = shared_from_this()](beast::error_code ec, size_t) {
+            if (ec || self->response_.need_eof()) return self->close();
+            self->read();
+        });
+    }
+
+    void close() {
+        beast::error_code ignored;
+        stream_.socket().shutdown(tcp::socket::shutdown_both, ignored);
+    }
+
+    Impl& exchange_;
+    beast::tcp_stream stream_;
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    http::response<http::string_body> response_;
+    net::steady_timer timer_;
+};
+
+void LocalBitMEXExchange::Impl::accept() {
+    acceptor.async_accept([this](beast::error_code ec, tcp::socket socket) {
+        if (ec) {
+            return;
+        }
+        socket.set_option(tcp::no_delay(true), ec);
+        std::make_shared<HttpSession>(*this, std::move(socket))->read();
+        accept();
+    });
+}
+
+void LocalBitMEXExchange::Impl::broadcast(const std::string& table, const std::string& text) {
+    for (const auto& weak : sessions) {
+        if (auto session = weak.lock(); session && session->subscribed(table)) {
+            session->push(text);
+        }
+    }
+}
+
+void LocalBitMEXExchange::Impl::on_ws_message(WsSession& session, const std::string& text) {
+    if (text == "ping") {
+        session.push("pong");
+        return;
+    }
+    const json message = json::parse(text, nullptr, false);
+    if (message.is_discarded() || !message.is_object()) {
+        session.push(json{{"status", 400}, {"error", "Unable to parse request"}}.dump());
+        return;
+    }
+
+    const std::string op = message.value("op", "");
+    if (op == "authKeyExpires") {
+        session.push(json{{"success", true}, {"request", message}}.dump());
+        return;
+    }
+    if (op != "subscribe") {
+        session.push(json{{"status", 400}, {"error", "Unknown or missing op"}, {"request", message}}.dump());
+        return;
+    }
+
+    json args = message.value("args", json::array());
+    if (!args.is_array()) {
+        args = json::array({args});
+    }
+    for (const auto& arg : args) {
+        const std::string topic = arg.is_string() ? arg.get<std::string>() : "";
+        const std::string table = topic.substr(0, topic.find(':'));
+        if (table != "orderBookL2" && table != "execution") {
+            session.push(json{{"status", 400}, {"error", "Unknown table: " + table},
+                              {"request", message}}.dump());
+            continue;
+        }
+        session.subscribe(table);
+        session.push(json{{"success", true}, {"subscribe", topic}, {"request", message}}.dump());
+        if (table == "orderBookL2") {
+            session.push(book_partial());
+        } else {
+            session.push(json{{"table", "execution"}, {"action", "partial"},
+                              {"keys", {"execID"}}, {"data", json::array()}}.dump());
+        }
+    }
+}
+
+http::response<http::string_body> LocalBitMEXExchange::Impl::handle(
+    const http::request<http::string_body>& request) {
+
+    ++request_count;
+    const std::string target(request.target());
+    const size_t query_start = target.find('?');
+    std::string path = target.substr(0, query_start);
+    const std::string query = query_start == std::string::npos ? "" : target.substr(query_start + 1);
+    if (listener) {
+        listener(std::string(request.method_string()), path, steady_ns());
+    }
+
+    http::response<http::string_body> response{http::status::ok, request.version()};
+    response.keep_alive(request.keep_alive());
+    response.set(http::field::content_type, "application/json");
+
+    // Per-minute budget, reported the way BitMEX does
+    const int64_t now = epoch_seconds();
+    if (now >= window_start + 60) {
+        window_start = now;
+        window_used = 0;
+    }
+    const int limit = config.requests_per_minute;
+    const bool over_budget = limit > 0 && window_used >= limit;
+    if (!over_budget && forced_429 == 0 && forced_503 == 0) {
+        ++window_used;
+    }
+    if (limit > 0) {
+        response.set("x-ratelimit-limit", std::to_string(limit));
+        response.set("x-ratelimit-remaining", std::to_string(std::max(limit - window_used, 0)));
+        response.set("x-ratelimit-reset", std::to_string(window_start + 60));
+    }
+
+    try {
+        if (forced_503 > 0) {
+            --forced_503;
+            throw RequestError(503, "The system is currently overloaded. Please try again later.");
+        }
+        if (forced_429 > 0 || over_budget) {
+            const int retry_after = forced_429 > 0
+                ? forced_retry_after : static_cast<int>(std::max<int64_t>(window_start + 60 - now, 1));
+            if (forced_429 > 0) {
+                --forced_429;
+            }
+            response.set(http::field::retry_after, std::to_string(retry_after));
+            throw RequestError(429, "Rate limit exceeded, retry in " + std::to_string(retry_after) +
+                               " seconds.", "RateLimitError");
+        }
+
+        const std::string prefix = "/api/v1";
+        if (path.compare(0, prefix.size(), prefix) != 0) {
+            throw RequestError(404, "Not Found");
+        }
+        path.erase(0, prefix.size());
+
+        json body = json::object();
+        if (!request.body().empty()) {
+            body = json::parse(request.body(), nullptr, false);
+            if (body.is_discarded()) {
+                throw RequestError(400, "Unable to parse request body", "ValidationError");
+            }
+        }
+        response.body() = route(request.method(), path, query, body).dump();
+    }
+    catch (const RequestError& e) {
+        response.result(e.status);
+        response.body() = json{{"error", {{"message", e.what()}, {"name", e.name}}}}.dump();
+    }
+    catch (const json::exception& e) {
+        // A field of the wrong type, e.g. a string price
+        response.result(http::status::bad_request);
+        response.body() = json{{"error", {{"message", e.what()}, {"name", "ValidationError"}}}}.dump();
+    }
+    catch (const std::exception& e) {
+        // Anything else is our bug; answer it instead of dropping the session
+        response.result(http::status::internal_server_error);
+        response.body() = json{{"error", {{"message", e.what()}, {"name", "HTTPError"}}}}.dump();
+    }
+    response.prepare_payload();
+    return response;
+}
+
+json LocalBitMEXExchange::Impl::route(
+    http::verb verb, const std::string& path, const std::string& query, const json& body) {
+
+    if (path == "/order") {
+        switch (verb) {
+        case http::verb::post: return place(body);
+        case http::verb::put: return amend(body);
+        case http::verb::delete_: return cancel_request(body);
+        case http::verb::get: return list_orders(query);
+        default: break;
+        }
+    }
+    if (path == "/order/bulk" && (verb == http::verb::post || verb == http::verb::put)) {
+        const json& list = body.contains("orders") ? body["orders"] : json::array();
+        if (!list.is_array()) {
+            throw RequestError(400, "orders must be an array", "ValidationError");
+        }
+        json rows = json::array();
+        if (verb == http::verb::post) {
+            // All or nothing: every order is checked before any is placed
+            std::vector<LiveOrder> checked;
+            for (const auto& item : list) {
+                checked.push_back(validate_place(item));
+            }
+            for (auto& order : checked) {
+                rows.push_back(place(std::move(order)));
+            }
+        } else {
+            for (const auto& item : list) {
+                locate(item);
+            }
+            for (const auto& item : list) {
+                rows.push_back(amend(item));
+            }
+        }
+        return rows;
+    }
+    if (path == "/order/all" && verb == http::verb::delete_) {
+        return cancel_all("Canceled: Cancel from www.bitmex.com");
+    }
+    if (path == "/order/cancelAllAfter" && verb == http::verb::post) {
+        return cancel_all_after(body);
+    }
+    if (path == "/position" && verb == http::verb::get) {
+        return json::array({{{"symbol", config.symbol}, {"currentQty", net_position}}});
+    }
+    if (path == "/instrument" && verb == http::verb::get) {
+        return json::array({{{"symbol", config.symbol}, {"state", "Open"},
+                             {"tickSize", config.tick_size}, {"lotSize", config.lot_size}}});
+    }
+    throw RequestError(404, "Not Found");
+}
+
+LocalBitMEXExchange::Impl::LiveOrder LocalBitMEXExchange::Impl::validate_place(const json& request) const {
+    if (!request.is_object()) {
+        throw RequestError(400, "Invalid order", "ValidationError");
+    }
+    if (request.value("symbol", config.symbol) != config.symbol) {
+        throw RequestError(400, "Unknown symbol", "ValidationError");
+    }
+    if (request.value("ordType", "Limit") != "Limit") {
+        throw RequestError(400, "Only Limit orders are supported", "ValidationError");
+    }
+    const std::string side = request.value("side", "");
+    if (side != "Buy" && side != "Sell") {
+        throw RequestError(400, "Invalid side", "ValidationError");
+    }
+    const double quantity = request.value("orderQty", 0.0);
+    const double price = request.value("price", 0.0);
+    if (quantity <= 0.0) {
+        throw RequestError(400, "Invalid orderQty", "ValidationError");
+    }
+    if (price <= 0.0) {
+        throw RequestError(400, "Invalid price", "ValidationError");
+    }
+    const std::string cl_ord_id = request.value("clOrdID", "");
+    if (!cl_ord_id.empty() && by_cl_ord_id.count(cl_ord_id)) {
+        throw RequestError(400, "Duplicate clOrdID", "ValidationError");
+    }
+
+    LiveOrder order;
+    order.cl_ord_id = cl_ord_id;
+    order.side = side == "Buy" ? OrderSide::BUY : OrderSide::SELL;
+    order.price = price;
+    order.order_qty = quantity;
+    order.post_only = request.value("execInst", "").find("ParticipateDoNotInitiate") != std::string::npos;
+    return order;
+}
+
+json LocalBitMEXExchange::Impl::place(const json& request) {
+    return place(validate_place(request));
+}
+
+json LocalBitMEXExchange::Impl::place(LiveOrder order) {
+    order.id = next_id++;
+    order.order_id = uuid();
+
+    const int64_t id = order.id;
+    by_order_id[order.order_id] = id;
+    if (!order.cl_ord_id.empty()) {
+        by_cl_ord_id[order.cl_ord_id] = id;
+    }
+
+    if (order.post_only && book.would_cross(order.side, order.price)) {
+        order.status = "Canceled";
+        order.text = "Canceled: Order had execInst of ParticipateDoNotInitiate";
+        publish_execution(order, "Canceled");
+        return order_row(done.emplace(id, std::move(order)).first->second);
+    }
+
+    order.status = "New";
+    Order entry{};
+    entry.order_id = id;
+    entry.side = order.side;
+    entry.price = order.price;
+    entry.quantity = order.order_qty;
+    auto& stored = orders.emplace(id, std::move(order)).first->second;
+    publish_execution(stored, "New");
+
+    book.add_order(entry);
+    settle();
+    return order_row(lookup(id));
+}
+
+int64_t LocalBitMEXExchange::Impl::locate(const json& request) const {
+    if (!request.is_object()) {
+        throw RequestError(400, "Invalid order", "ValidationError");
+    }
+    for (const char* key : {"origClOrdID", "clOrdID"}) {
+        if (request.contains(key) && request[key].is_string()) {
+            auto it = by_cl_ord_id.find(request[key].get<std::string>());
+            if (it == by_cl_ord_id.end()) {
+                throw RequestError(400, "Invalid origClOrdID", "ValidationError");
+            }
+            return open_id(it->second);
+        }
+    }
+    if (request.contains("orderID") && request["orderID"].is_string()) {
+        auto it = by_order_id.find(request["orderID"].get<std::string>());
+        if (it == by_order_id.end()) {
+            throw RequestError(400, "Invalid orderID", "ValidationError");
+        }
+        return open_id(it->second);
+    }
+    throw RequestError(400, "Must specify orderID or origClOrdID", "ValidationError");
+}
+
+int64_t LocalBitMEXExchange::Impl::open_id(int64_t id) const {
+    if (!orders.count(id)) {
+        throw RequestError(400, "Invalid ordStatus: order is " + done.at(id).status, "ValidationError");
+    }
+    return id;
+}
+
+json LocalBitMEXExchange::Impl::amend(const json& request) {
+    const int64_t id = locate(request);
+    LiveOrder& order = orders.at(id);
+
+    double quantity = order.order_qty;
+    if (request.contains("orderQty")) {
+        quantity = request["orderQty"].get<double>();
+    } else if (request.contains("leavesQty")) {
+        quantity = order.cum_qty + request["leavesQty"].get<double>();
+    }
+    if (quantity <= order.cum_qty) {
+        throw RequestError(400, "Invalid orderQty", "ValidationError");
+    }
+    const double price = request.value("price", order.price);
+
+    if (order.post_only && book.would_cross(order.side, price) && price != order.price) {
+        return cancel(id, "Canceled: Order had execInst of ParticipateDoNotInitiate");
+    }
+
+    order.price = price;
+    order.order_qty = quantity;
+    publish_execution(order, "Replaced");
+    Order entry{};
+    entry.order_id = id;
+    entry.side = order.side;
+    entry.price = price;
+    entry.quantity = quantity;
+    entry.filled_quantity = order.cum_qty;
+    book.modify_order(entry);
+    settle();
+    return order_row(lookup(id));
+}
+
+json LocalBitMEXExchange::Impl::cancel(int64_t id, const std::string& text) {
+    LiveOrder& order = orders.at(id);
+    book.cancel_order(id);
+    order.status = "Canceled";
+    order.text = text;
+    publish_execution(order, "Canceled");
+    close(id);
+    publish_book();
+    return order_row(lookup(id));
+}
+
+json LocalBitMEXExchange::Impl::cancel_all(const std::string& text) {
+    json rows = json::array();
+    std::vector<int64_t> ids;
+    for (const auto& [id, order] : orders) {
+        ids.push_back(id);
+    }
+    for (int64_t id : ids) {
+        rows.push_back(cancel(id, text));
+    }
+    return rows;
+}
+
+json LocalBitMEXExchange::Impl::cancel_all_after(const json& request) {
+    const json& timeout = request.contains("timeout") ? request["timeout"] : json();
+    if (!timeout.is_number()) {
+        throw RequestError(400, "timeout must be a number of milliseconds", "ValidationError");
+    }
+    // Each call replaces the previous deadline; 0 disarms
+    const int64_t timeout_ms = timeout.get<int64_t>();
+    dead_man_switch.cancel();
+    json result{{"now", timestamp()}};
+    if (timeout_ms <= 0) {
+        return result;
+    }
+    dead_man_switch.expires_after(std::chrono::milliseconds(timeout_ms));
+    dead_man_switch.async_wait([this](beast::error_code ec) {
+        if (ec) {
+            return;
+        }
+        cancel_all("Canceled: Cancel from cancelAllAfter");
+    });
+    result["cancelTime"] = timestamp(std::chrono::system_clock::now() +
+                                     std::chrono::milliseconds(timeout_ms));
+    return result;
+}
+
+json LocalBitMEXExchange::Impl::cancel_request(const json& request) {
+    // clOrdID / orderID may each be a single id or an array of them
+    std::vector<std::pair<const char*, std::string>> keys;
+    for (const char* key : {"clOrdID", "orderID"}) {
+        if (!request.contains(key)) {
+            continue;
+        }
+        const json& value = request[key];
+        for (const auto& item : value.is_array() ? value : json::array({value})) {
+            if (item.is_string()) {
+                keys.emplace_back(key, item.get<std::string>());
+            }
+        }
+    }
+    if (keys.empty()) {
+        throw RequestError(400, "Must specify orderID or clOrdID", "ValidationError");
+    }
+
+    json rows = json::array();
+    for (const auto& [key, value] : keys) {
+        const auto& index = std::string(key) == "clOrdID" ? by_cl_ord_id : by_order_id;
+        auto it = index.find(value);
+        if (it == index.end()) {
+            rows.push_back({{key, value}, {"error", "Not Found"}});
+            continue;
+        }
+        if (!orders.count(it->second)) {
+            json row = order_row(done.at(it->second));
+            row["error"] = "Unable to cancel order due to existing state: " +
+                           row["ordStatus"].get<std::string>();
+            rows.push_back(std::move(row));
+            continue;
+        }
+        rows.push_back(cancel(it->second, "Canceled: Canceled via API."));
+    }
+    return rows;
+}
+
+void LocalBitMEXExchange::Impl::settle() {
+    for (const auto& fill : book.take_fills()) {
+        apply_fill(fill.maker_order_id, fill.price, fill.quantity);
+        apply_fill(fill.taker_order_id, fill.price, fill.quantity);
+        // Consumed background liquidity
+        for (int64_t id : {fill.maker_order_id, fill.taker_order_id}) {
+            auto it = background_ids.find(id);
+            if (it != background_ids.end() && !book.has_order(id)) {
+                background.erase(it->second);
+                background_ids.erase(it);
+            }
+        }
+    }
+    publish_book();
+}
+
+void LocalBitMEXExchange::Impl::apply_fill(int64_t id, double price, double quantity) {
+    auto it = orders.find(id);
+    if (it == orders.end()) {
+        return;
+    }
+    LiveOrder& order = it->second;
+    order.avg_px = (order.avg_px * order.cum_qty + price * quantity) / (order.cum_qty + quantity);
+    order.cum_qty += quantity;
+    net_position += order.side == OrderSide::BUY ? quantity : -quantity;
+    const bool filled = order.cum_qty >= order.order_qty;
+    order.status = filled ? "Filled" : "PartiallyFilled";
+    publish_execution(order, "Trade", price, quantity);
+    if (filled) {
+        close(id);
+    }
+}
+
+void LocalBitMEXExchange::Impl::close(int64_t id) {
+    auto it = orders.find(id);
+    done[id] = std::move(it->second);
+    orders.erase(it);
+}
+
+const LocalBitMEXExchange::Impl::LiveOrder& LocalBitMEXExchange::Impl::lookup(int64_t id) const {
+    auto it = orders.find(id);
+    return it != orders.end() ? it->second : done.at(id);
+}
+
+json LocalBitMEXExchange::Impl::list_orders(const std::string& query) const {
+    const auto params = parse_query(query);
+    json filter = json::object();
+    if (auto it = params.find("filter"); it != params.end() && !it->second.empty()) {
+        filter = json::parse(it->second, nullptr, false);
+        if (!filter.is_object()) {
+            throw RequestError(400, "filter must be a JSON object", "ValidationError");
+        }
+    }
+    size_t count = 100;
+    if (auto it = params.find("count"); it != params.end()) {
+        const long long requested = std::atoll(it->second.c_str());
+        if (requested <= 0 || requested > 500) {
+            throw RequestError(400, "count must be between 1 and 500", "ValidationError");
+        }
+        count = static_cast<size_t>(requested);
+    }
+    const bool reverse = params.count("reverse") && params.at("reverse") == "true";
+
+    // Oldest first, as on BitMEX, open and closed alike
+    std::vector<const LiveOrder*> candidates;
+    for (const auto* table : {&orders, &done}) {
+        for (const auto& [id, order] : *table) {
+            candidates.push_back(&order);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [reverse](const LiveOrder* a, const LiveOrder* b) {
+        return reverse ? a->id > b->id : a->id < b->id;
+    });
+
+    json rows = json::array();
+    for (const LiveOrder* order : candidates) {
+        if (rows.size() == count) {
+            break;
+        }
+        json row = order_row(*order);
+        bool matched = true;
+        for (const auto& field : filter.items()) {
+            matched = matched && row.contains(field.key()) && row[field.key()] == field.value();
+        }
+        if (matched) {
+            rows.push_back(std::move(row));
+        }
+    }
+    return rows;
+}
+
+json LocalBitMEXExchange::Impl::order_row(const LiveOrder& order) const {
+    return {
+        {"orderID", order.order_id},
+        {"clOrdID", order.cl_ord_id},
+        {"symbol", config.symbol},
+        {"side", side_name(order.side)},
+        {"orderQty", order.order_qty},
+        {"price", order.price},
+        {"ordType", "Limit"},
+        {"execInst", order.post_only ? "ParticipateDoNotInitiate" : ""},
+        {"ordStatus", order.status},
+        {"leavesQty", order.status == "Canceled" ? 0.0 : order.order_qty - order.cum_qty},
+        {"cumQty", order.cum_qty},
+        {"avgPx", order.avg_px},
+        {"text", order.text},
+        {"timestamp", timestamp()}
+    };
+}
+
+void LocalBitMEXExchange::Impl::publish_execution(
+    const LiveOrder& order, const char* exec_type, double last_px, double last_qty) {
+
+    json row = order_row(order);
+    row["execID"] = uuid();
+    row["execType"] = exec_type;
+    row["lastPx"] = last_px;
+    row["lastQty"] = last_qty;
+    row["transactTime"] = row["timestamp"];
+    broadcast("execution", json{{"table", "execution"}, {"action", "insert"},
+                                {"data", json::array({std::move(row)})}}.dump());
+}
+
+json LocalBitMEXExchange::Impl::book_row(
+    OrderSide side, int64_t level_ticks, double size, bool with_price) const {
+
+    json row{{"symbol", config.symbol}, {"id", LEVEL_ID_BASE - level_ticks}, {"side", side_name(side)}};
+    if (with_price) {
+        row["size"] = size;
+        row["price"] = level_ticks * config.tick_size;
+    }
+    return row;
+}
+
+void LocalBitMEXExchange::Impl::publish_book() {
+    json deletes = json::array();
+    json updates = json::array();
+    json inserts = json::array();
+    for (OrderSide side : {OrderSide::BUY, OrderSide::SELL}) {
+        std::map<int64_t, double> current;
+        book.get_levels(side, config.book_depth, levels_scratch);
+        for (const auto& level : levels_scratch) {
+            current[ticks(level.price)] = level.size;
+        }
+
+        auto& last = published[side == OrderSide::BUY ? 0 : 1];
+        for (const auto& [level_ticks, size] : last) {
+            if (!current.count(level_ticks)) {
+                deletes.push_back(book_row(side, level_ticks, 0.0, false));
+            }
+        }
+        for (const auto& [level_ticks, size] : current) {
+            auto it = last.find(level_ticks);
+            if (it == last.end()) {
+                inserts.push_back(book_row(side, level_ticks, size, true));
+            } else if (it->second != size) {
+                updates.push_back(book_row(side, level_ticks, size, true));
+            }
+        }
+        last = std::move(current);
+    }
+
+    // Deletes first: a price can change sides within one step
+    for (auto* rows : {&deletes, &updates, &inserts}) {
+        if (rows->empty()) {
+            continue;
+        }
+        const char* action = rows == &deletes ? "delete" : rows == &updates ? "update" : "insert";
+        broadcast("orderBookL2", json{{"table", "orderBookL2"}, {"action", action},
+                                      {"data", std::move(*rows)}}.dump());
+    }
+}
+
+std::string LocalBitMEXExchange::Impl::book_partial() const {
+    json data = json::array();
+    for (OrderSide side : {OrderSide::SELL, OrderSide::BUY}) {
+        for (const auto& [level_ticks, size] : published[side == OrderSide::BUY ? 0 : 1]) {
+            data.push_back(book_row(side, level_ticks, size, true));
+        }
+    }
+    return json{{"table", "orderBookL2"}, {"action", "partial"},
+                {"keys", {"symbol", "id", "side"}}, {"data", std::move(data)}}.dump();
+}
+
+void LocalBitMEXExchange::Impl::set_level(OrderSide side, double price, double size) {
+    const auto key = std::make_pair(side, ticks(price));
+    auto it = background.find(key);
+    if (it != background.end()) {
+        book.cancel_order(it->second);
+        background_ids.erase(it->second);
+        background.erase(it);
+    }
+    if (size > 0.0) {
+        const int64_t id = next_id++;
+        Order entry{};
+        entry.order_id = id;
+        entry.side = side;
+        entry.price = price;
+        entry.quantity = size;
+        book.add_order(entry);
+        if (book.has_order(id)) {
+            background[key] = id;
+            background_ids[id] = key;
+        }
+    }
+    settle();
+}
+
+void LocalBitMEXExchange::Impl::trade(OrderSide side, double price, double quantity) {
+    const int64_t id = next_id++;
+    Order entry{};
+    entry.order_id = id;
+    entry.side = side;
+    entry.price = price;
+    entry.quantity = quantity;
+    book.add_order(entry);
+    // Immediate-or-cancel
+    book.cancel_order(id);
+    settle();
+}
+
+LocalBitMEXExchange::LocalBitMEXExchange(Config config)
+    : impl_(std::make_unique<Impl>(std::move(config))) {}
+
+LocalBitMEXExchange::~LocalBitMEXExchange() {
+    stop();
+}
+
+void LocalBitMEXExchange::start() {
+    if (impl_->thread.joinable()) {
+        return;
+    }
+    impl_->accept();
+    impl_->thread = std::thread([impl = impl_.get()] { impl->ioc.run(); });
+}
+
+void LocalBitMEXExchange::stop() {
+    if (!impl_->thread.joinable()) {
+        return;
+    }
+    net::post(impl_->ioc, [impl = impl_.get()] {
+        beast::error_code ignored;
+        impl->acceptor.close(ignored);
+        for (const auto& weak : impl->sessions) {
+            if (auto session = weak.lock()) {
+                session->close();
+            }
+        }
+        impl->work.reset();
+        impl->ioc.stop();
+    });
+    impl_->thread.join();
+}
+
+std::string LocalBitMEXExchange::rest_url() const {
+    return "http://127.0.0.1:" + std::to_string(port()) + "/api/v1";
+}
+
+std::string LocalBitMEXExchange::ws_url() const {
+    return "ws://127.0.0.1:" + std::to_string(port()) + "/realtime";
+}
+
+uint16_t LocalBitMEXExchange::port() const {
+    return impl_->acceptor.local_endpoint().port();
+}
+
+void LocalBitMEXExchange::set_level(OrderSide side, double price, double size) {
+    impl_->call([&] { impl_->set_level(side, price, size); });
+}
+
+void LocalBitMEXExchange::trade(OrderSide side, double price, double quantity) {
+    impl_->call([&] { impl_->trade(side, price, quantity); });
+}
+
+void LocalBitMEXExchange::inject_rate_limit(int count, int retry_after_seconds) {
+    impl_->call([&] {
+        impl_->forced_429 = count;
+        impl_->forced_retry_after = retry_after_seconds;
+    });
+}
+
+void LocalBitMEXExchange::inject_overload(int count) {
+    impl_->call([&] { impl_->forced_503 = count; });
+}
+
+void LocalBitMEXExchange::set_request_listener(RequestListener listener) {
+    impl_->call([&] { impl_->listener = std::move(listener); });
+}
+
+size_t LocalBitMEXExchange::open_orders() {
+    return impl_->call([&] { return impl_->orders.size(); });
+}
+
+double LocalBitMEXExchange::position() {
+    return impl_->call([&] { return impl_->net_position; });
+}
+
+uint64_t LocalBitMEXExchange::requests() {
+    return impl_->call([&] { return impl_->request_count; });
+}
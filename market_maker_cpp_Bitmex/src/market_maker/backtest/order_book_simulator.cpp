@@ -0,0 +1,184 @@
+#include "order_book_simulator.h"
+#include <algorithm>
+
+void OrderBookSimulator::add_order(const Order& order) {
+    const Price price = tick_size_.from_double<Price>(order.price);
+    Qty leaves = lot_size_.from_double<Qty>(order.quantity) -
+                 lot_size_.from_double<Qty>(order.filled_quantity);
+    if (leaves.raw() <= 0) {
+        return;
+    }
+
+    leaves = match_orders(order.order_id, order.side, price, leaves);
+    if (leaves.raw() > 0) {
+        rest(order.order_id, order.side, price, leaves);
+    }
+    update_book_state();
+}
+
+void OrderBookSimulator::cancel_order(int64_t order_id) {
+    auto it = locations_.find(order_id);
+    if (it == locations_.end()) {
+        return;
+    }
+    const Location location = it->second;
+    locations_.erase(it);
+
+    PriceLevel* level = find_level(location);
+    auto& queue = level->orders;
+    auto pos = std::find_if(queue.begin(), queue.end(), [order_id](const RestingOrder& r) {
+        return r.order_id == order_id;
+    });
+    level->total_volume -= pos->leaves;
+    queue.erase(pos);
+    if (queue.empty()) {
+        if (location.side == OrderSide::BUY) {
+            bid_levels_.erase(location.price);
+        } else {
+            ask_levels_.erase(location.price);
+        }
+    }
+    update_book_state();
+}
+
+void OrderBookSimulator::modify_order(const Order& order) {
+    auto it = locations_.find(order.order_id);
+    if (it == locations_.end()) {
+        return;
+    }
+    const Location location = it->second;
+    const Price price = tick_size_.from_double<Price>(order.price);
+    const Qty leaves = lot_size_.from_double<Qty>(order.quantity) -
+                       lot_size_.from_double<Qty>(order.filled_quantity);
+
+    PriceLevel* level = find_level(location);
+    auto pos = std::find_if(level->orders.begin(), level->orders.end(),
+        [&](const RestingOrder& r) { return r.order_id == order.order_id; });
+
+    // Size down in place: keeps its place in the queue
+    if (price == location.price && leaves.raw() > 0 && leaves <= pos->leaves) {
+        level->total_volume -= pos->leaves - leaves;
+        pos->leaves = leaves;
+        update_book_state();
+        return;
+    }
+
+    cancel_order(order.order_id);
+    add_order(order);
+}
+
+double OrderBookSimulator::leaves_quantity(int64_t order_id) const {
+    auto it = locations_.find(order_id);
+    if (it == locations_.end()) {
+        return 0.0;
+    }
+    const Location& location = it->second;
+    const PriceLevel& level = location.side == OrderSide::BUY
+        ? bid_levels_.at(location.price) : ask_levels_.at(location.price);
+    for (const auto& resting : level.orders) {
+        if (resting.order_id == order_id) {
+            return lot_size_.to_double(resting.leaves);
+        }
+    }
+    return 0.0;
+}
+
+bool OrderBookSimulator::would_cross(OrderSide side, double price) const {
+    const Price ticks = tick_size_.from_double<Price>(price);
+    if (side == OrderSide::BUY) {
+        return !ask_levels_.empty() && ask_levels_.begin()->first <= ticks;
+    }
+    return !bid_levels_.empty() && ticks <= bid_levels_.begin()->first;
+}
+
+size_t OrderBookSimulator::get_levels(OrderSide side, size_t n, std::vector<BookLevel>& out) const {
+    out.clear();
+    auto copy = [&](const auto& levels) {
+        for (const auto& [price, level] : levels) {
+            if (out.size() == n) {
+                break;
+            }
+            out.push_back({tick_size_.to_double(price), lot_size_.to_double(level.total_volume)});
+        }
+    };
+    if (side == OrderSide::BUY) {
+        copy(bid_levels_);
+    } else {
+        copy(ask_levels_);
+    }
+    return out.size();
+}
+
+Qty OrderBookSimulator::match_orders(int64_t taker_id, OrderSide side, Price limit, Qty leaves) {
+    return side == OrderSide::BUY
+        ? match_side(ask_levels_, taker_id, side, limit, leaves)
+        : match_side(bid_levels_, taker_id, side, limit, leaves);
+}
+
+template <class Levels>
+Qty OrderBookSimulator::match_side(
+    Levels& levels,
+    int64_t taker_id,
+    OrderSide side,
+    Price limit,
+    Qty leaves) {
+
+    while (leaves.raw() > 0 && !levels.empty()) {
+        auto best = levels.begin();
+        const bool crosses = side == OrderSide::BUY ? best->first <= limit : limit <= best->first;
+        if (!crosses) {
+            break;
+        }
+
+        PriceLevel& level = best->second;
+        while (leaves.raw() > 0 && !level.orders.empty()) {
+            RestingOrder& maker = level.orders.front();
+            const Qty traded = maker.leaves < leaves ? maker.leaves : leaves;
+            fills_.push_back({maker.order_id, taker_id, side,
+                              tick_size_.to_double(level.price), lot_size_.to_double(traded)});
+            maker.leaves -= traded;
+            level.total_volume -= traded;
+            leaves -= traded;
+            if (maker.leaves.raw() == 0) {
+                locations_.erase(maker.order_id);
+                level.orders.pop_front();
+            }
+        }
+        if (level.orders.empty()) {
+            levels.erase(best);
+        }
+    }
+    return leaves;
+}
+
+void OrderBookSimulator::rest(int64_t order_id, OrderSide side, Price price, Qty leaves) {
+    PriceLevel& level = side == OrderSide::BUY ? bid_levels_[price] : ask_levels_[price];
+    level.price = price;
+    level.total_volume += leaves;
+    level.orders.push_back({order_id, leaves});
+    locations_[order_id] = {side, price};
+}
+
+OrderBookSimulator::PriceLevel* OrderBookSimulator::find_level(const Location& location) {
+    if (location.side == OrderSide::BUY) {
+        return &bid_levels_.at(location.price);
+    }
+    return &ask_levels_.at(location.price);
+}
+
+void OrderBookSimulator::update_book_state() {
+    current_depth_.begin_update();
+    auto publish = [this](const auto& levels, auto update) {
+        size_t i = 0;
+        for (auto it = levels.begin(); it != levels.end() && i < MarketDepth::MAX_LEVELS; ++it, ++i) {
+            (current_depth_.*update)(i, tick_size_.to_double(it->first),
+                                     lot_size_.to_double(it->second.total_volume));
+        }
+        for (; i < MarketDepth::MAX_LEVELS; ++i) {
+            (current_depth_.*update)(i, 0.0, 0.0);
+        }
+    };
+    publish(bid_levels_, &MarketDepth::update_bid);
+    publish(ask_levels_, &MarketDepth::update_ask);
+    current_depth_.commit();
+}
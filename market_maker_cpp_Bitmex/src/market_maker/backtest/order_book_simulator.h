@@ -3,9 +3,16 @@
 #include "market_data.h"
 #include "order_manager.h"
 #include "stable_vector.h"
+#include "fixed_point.h"
+#include <atomic>
+#include <deque>
+#include <map>
 #include <queue>
 #include <random>
 #include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class ExchangeError : public std::runtime_error {
 public:
@@ -41,6 +48,8 @@ public:
     
     explicit OrderBookSimulator(SimConfig config)
         : config_(config)
+        , tick_size_(config.base_tick_size)
+        , lot_size_(config.base_lot_size)
         , rng_(std::random_device{}())
         , latency_dist_(
               config.mean_latency.count(),
@@ -72,10 +81,42 @@ public:
         }
     }
     
+    // One match between a resting (maker) and an incoming (taker) order, at
+    // the maker's price
+    struct Fill {
+        int64_t maker_order_id;
+        int64_t taker_order_id;
+        OrderSide taker_side;
+        double price;
+        double quantity;
+    };
+    
+    struct BookLevel {
+        double price;
+        double size;
+    };
+    
+    // Price-time priority matching, applied immediately. An incoming order
+    // first trades against the opposite side up to its limit price and the
+    // remainder rests. Order ids must be unique among resting orders.
     void add_order(const Order& order);
     void cancel_order(int64_t order_id);
+    // Quantity is the order total, as on the exchange. A pure size reduction
+    // keeps queue priority; any other change re-enters the order, which may
+    // then trade.
     void modify_order(const Order& order);
     
+    // Fills produced since the last call, in match order
+    std::vector<Fill> take_fills() { return std::exchange(fills_, {}); }
+    
+    bool has_order(int64_t order_id) const { return locations_.count(order_id) > 0; }
+    // Unfilled quantity of a resting order, 0 if it is not resting
+    double leaves_quantity(int64_t order_id) const;
+    // True if a limit order at `price` would trade on arrival
+    bool would_cross(OrderSide side, double price) const;
+    // Best-first aggregated levels of one side, at most n
+    size_t get_levels(OrderSide side, size_t n, std::vector<BookLevel>& out) const;
+    
     // Getters for simulation state
     const MarketDepth& get_current_depth() const { return current_depth_; }
     const stable_vector<SimulatedOrder>& get_processed_orders() const {
@@ -84,6 +125,8 @@ public:
     
 private:
     SimConfig config_;
+    TickSize tick_size_;  // Orders are converted to ticks/lots on entry
+    TickSize lot_size_;
     MarketDepth current_depth_;
     std::mt19937_64 rng_;
     std::normal_distribution<double> latency_dist_;
@@ -98,18 +141,37 @@ private:
     stable_vector<SimulatedOrder> processed_orders_;
     
     // Internal state
+    struct RestingOrder {
+        int64_t order_id;
+        Qty leaves;
+    };
+    
     struct PriceLevel {
-        double price;
-        double total_volume;
-        std::unordered_map<int64_t, Order> orders;
+        Price price;
+        Qty total_volume;
+        std::deque<RestingOrder> orders;  // Arrival order
+    };
+    
+    struct Location {
+        OrderSide side;
+        Price price;
     };
     
-    std::map<double, PriceLevel, std::greater<>> bid_levels_;
-    std::map<double, PriceLevel> ask_levels_;
+    // Integer-keyed: exact level matching and cheap comparisons
+    std::map<Price, PriceLevel, std::greater<>> bid_levels_;
+    std::map<Price, PriceLevel> ask_levels_;
+    std::unordered_map<int64_t, Location> locations_;
+    std::vector<Fill> fills_;
     
     // Helper methods
     void process_queue(std::chrono::nanoseconds current_time);
-    void match_orders();
+    // Trades `taker` against the opposite side up to `limit`; returns what is
+    // left of `leaves`
+    Qty match_orders(int64_t taker_id, OrderSide side, Price limit, Qty leaves);
+    template <class Levels>
+    Qty match_side(Levels& levels, int64_t taker_id, OrderSide side, Price limit, Qty leaves);
+    void rest(int64_t order_id, OrderSide side, Price price, Qty leaves);
+    PriceLevel* find_level(const Location& location);
     void update_book_state();
     void simulate_market_impact(const Order& order);
     std::chrono::nanoseconds simulate_latency();
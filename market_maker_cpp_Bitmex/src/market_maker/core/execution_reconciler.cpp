@@ -0,0 +1,162 @@
+#include "execution_reconciler.h"
+#include <chrono>
+#include <limits>
+#include "spin_wait.h"
+
+namespace {
+
+constexpr int64_t NO_HASH = std::numeric_limits<int64_t>::min();
+
+}  // namespace
+
+ExecutionReconciler::ExecutionReconciler(std::shared_ptr<OrderManager> order_manager, Config config)
+    : order_manager_(std::move(order_manager))
+    , queue_(config.queue_capacity)
+    , seen_(config.dedup_window)
+    , recent_(config.dedup_window, NO_HASH) {}
+
+ExecutionReconciler::ExecutionReconciler(std::shared_ptr<OrderManager> order_manager)
+    : ExecutionReconciler(std::move(order_manager), Config{}) {}
+
+ExecutionReconciler::~ExecutionReconciler() {
+    stop();
+}
+
+size_t ExecutionReconciler::poll() {
+    ExecutionReport report;
+    size_t taken = 0;
+    while (queue_.try_pop(report)) {
+        apply(report);
+        ++taken;
+    }
+    return taken;
+}
+
+void ExecutionReconciler::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+void ExecutionReconciler::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ExecutionReconciler::run() {
+    // Spin briefly after the last report, fills tend to arrive in bursts,
+    // then back off so an idle session does not burn a core
+    int idle = 0;
+    while (running_.load(std::memory_order_acquire)) {
+        if (poll() > 0) {
+            idle = 0;
+        } else if (++idle < 256) {
+            cpu_relax();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    poll();
+}
+
+void ExecutionReconciler::apply(const ExecutionReport& report) {
+    if (report.exec_id_len > 0 && !remember(report.exec_id_view())) {
+        duplicates_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (report.exec_type != ExecType::TRADE &&
+        report.exec_type != ExecType::CANCELED &&
+        report.exec_type != ExecType::REJECTED) {
+        return;
+    }
+
+    const auto current = order_manager_->get_order(report.order_id);
+    if (!current) {
+        if (report.exec_type != ExecType::TRADE) {
+            return;
+        }
+        if (report.order_id == 0 || report.last_qty <= 0.0) {
+            unmatched_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Ours, but cancelled locally before the exchange saw the cancel: the
+        // fill still happened, so it moves the position all the same
+        order_manager_->apply_untracked_fill(report.side, report.last_qty, report.last_px);
+        untracked_.fetch_add(1, std::memory_order_relaxed);
+        notify(report, report.side, report.last_qty);
+        return;
+    }
+
+    Order update = *current;
+    update.last_update_time = report.timestamp;
+    double filled = 0.0;
+    switch (report.exec_type) {
+    case ExecType::TRADE: {
+        // cumQty is authoritative and makes out-of-order rows harmless; sum
+        // lastQty only if the row did not carry it
+        const double cum = report.cum_qty > 0.0
+            ? report.cum_qty : current->filled_quantity + report.last_qty;
+        update.filled_quantity = std::min(cum, current->quantity);
+        filled = update.filled_quantity - current->filled_quantity;
+        if (filled <= 0.0) {
+            return;
+        }
+        // Without leavesQty only our own quantity says whether it is done
+        update.status = (!report.has_leaves_qty || report.leaves_qty > 0.0) &&
+                        update.filled_quantity < current->quantity
+            ? OrderStatus::PARTIALLY_FILLED : OrderStatus::FILLED;
+        break;
+    }
+    case ExecType::CANCELED:
+        update.status = OrderStatus::CANCELLED;
+        break;
+    default:
+        update.status = OrderStatus::REJECTED;
+        break;
+    }
+
+    order_manager_->update_order(update);
+    applied_.fetch_add(1, std::memory_order_relaxed);
+
+    if (filled > 0.0) {
+        notify(report, current->side, filled);
+    }
+}
+
+void ExecutionReconciler::notify(const ExecutionReport& report, OrderSide side, double filled) {
+    const PositionDelta delta{
+        .order_id = report.order_id,
+        .side = side,
+        .quantity = side == OrderSide::BUY ? filled : -filled,
+        .price = report.last_px,
+        .position = order_manager_->get_position(),
+        .timestamp = report.timestamp
+    };
+    for (const auto& listener : listeners_) {
+        listener(delta);
+    }
+}
+
+bool ExecutionReconciler::remember(std::string_view exec_id) {
+    int64_t hash = static_cast<int64_t>(std::hash<std::string_view>{}(exec_id));
+    if (hash == NO_HASH) {
+        hash = 0;
+    }
+    if (seen_.find(hash) != OrderIndex::NPOS) {
+        return false;
+    }
+
+    int64_t& slot = recent_[recent_next_];
+    if (slot != NO_HASH) {
+        seen_.erase(slot);
+    }
+    slot = hash;
+    seen_.insert(hash, 0);
+    recent_next_ = (recent_next_ + 1) % recent_.size();
+    return true;
+}
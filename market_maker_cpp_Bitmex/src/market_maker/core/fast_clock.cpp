@@ -0,0 +1,10 @@
+#include "fast_clock.h"
+
+namespace {
+
+// Pays for calibration while the library loads rather than on the first tick
+struct CalibrateAtLoad {
+    CalibrateAtLoad() { FastClock::now_ns(); }
+} calibrate_at_load;
+
+}  // namespace
@@ -0,0 +1,168 @@
+#include "l2_order_book.h"
+#include "tick_journal.h"
+#include <array>
+#include <stdexcept>
+
+L2OrderBook::Action L2OrderBook::parse_action(const std::string& action) {
+    if (action == "update") return Action::UPDATE;
+    if (action == "insert") return Action::INSERT;
+    if (action == "delete") return Action::DELETE;
+    if (action == "partial") return Action::PARTIAL;
+    throw std::invalid_argument("Unknown orderBookL2 action: " + action);
+}
+
+bool L2OrderBook::apply(
+    Action action,
+    const Entry* entries,
+    size_t count,
+    MarketDepth& depth) {
+    
+    bool dirty = false;
+    
+    switch (action) {
+        case Action::PARTIAL:
+            clear();
+            for (size_t i = 0; i < count; ++i) {
+                insert(entries[i], dirty);
+            }
+            dirty = true;
+            break;
+        case Action::INSERT:
+            for (size_t i = 0; i < count; ++i) {
+                insert(entries[i], dirty);
+            }
+            break;
+        case Action::UPDATE:
+            for (size_t i = 0; i < count; ++i) {
+                update(entries[i], dirty);
+            }
+            break;
+        case Action::DELETE:
+            for (size_t i = 0; i < count; ++i) {
+                erase(entries[i], dirty);
+            }
+            break;
+    }
+    
+    if (dirty) {
+        publish(depth);
+    }
+    return dirty;
+}
+
+void L2OrderBook::insert(const Entry& entry, bool& dirty) {
+    levels_by_id_[entry.id] = LevelRef{entry.side, entry.price};
+    
+    if (entry.side == BookSide::BID) {
+        bids_[entry.price] = entry.size;
+    } else {
+        asks_[entry.price] = entry.size;
+    }
+    dirty = dirty || touches_top(entry.side, entry.price);
+}
+
+void L2OrderBook::update(const Entry& entry, bool& dirty) {
+    auto it = levels_by_id_.find(entry.id);
+    if (it == levels_by_id_.end()) {
+        return;
+    }
+    
+    const LevelRef& ref = it->second;
+    if (ref.side == BookSide::BID) {
+        bids_[ref.price] = entry.size;
+    } else {
+        asks_[ref.price] = entry.size;
+    }
+    dirty = dirty || touches_top(ref.side, ref.price);
+}
+
+void L2OrderBook::erase(const Entry& entry, bool& dirty) {
+    auto it = levels_by_id_.find(entry.id);
+    if (it == levels_by_id_.end()) {
+        return;
+    }
+    
+    const LevelRef ref = it->second;
+    levels_by_id_.erase(it);
+    
+    if (ref.side == BookSide::BID) {
+        bids_.erase(ref.price);
+    } else {
+        asks_.erase(ref.price);
+    }
+    dirty = dirty || touches_top(ref.side, ref.price);
+}
+
+bool L2OrderBook::touches_top(BookSide side, Price price) const {
+    if (side == BookSide::BID) {
+        return !bids_full_ || price >= bid_boundary_;
+    }
+    return !asks_full_ || price <= ask_boundary_;
+}
+
+void L2OrderBook::publish(MarketDepth& depth) {
+    std::array<LevelUpdate, MarketDepth::MAX_LEVELS> bid_updates;
+    std::array<LevelUpdate, MarketDepth::MAX_LEVELS> ask_updates;
+    
+    auto bid_it = bids_.begin();
+    auto ask_it = asks_.begin();
+    for (size_t level = 0; level < MarketDepth::MAX_LEVELS; ++level) {
+        if (bid_it != bids_.end()) {
+            bid_updates[level] = {level, tick_size_.to_double(bid_it->first),
+                                  lot_size_.to_double(bid_it->second)};
+            bid_boundary_ = bid_it->first;
+            ++bid_it;
+        } else {
+            bid_updates[level] = {level, 0.0, 0.0};
+        }
+        
+        if (ask_it != asks_.end()) {
+            ask_updates[level] = {level, tick_size_.to_double(ask_it->first),
+                                  lot_size_.to_double(ask_it->second)};
+            ask_boundary_ = ask_it->first;
+            ++ask_it;
+        } else {
+            ask_updates[level] = {level, 0.0, 0.0};
+        }
+    }
+    
+    const int64_t now = FastClock::now_ns();
+    depth.begin_update();
+    depth.apply_levels(BookSide::BID, bid_updates.data(), bid_updates.size(), now);
+    depth.apply_levels(BookSide::ASK, ask_updates.data(), ask_updates.size(), now);
+    depth.commit();
+    
+    if (journal_) {
+        journal_->append_book(now, BookSide::BID, bid_updates.data(), bid_updates.size(), false);
+        journal_->append_book(now, BookSide::ASK, ask_updates.data(), ask_updates.size(), true);
+    }
+    
+    bids_full_ = bids_.size() >= MarketDepth::MAX_LEVELS;
+    asks_full_ = asks_.size() >= MarketDepth::MAX_LEVELS;
+}
+
+size_t L2OrderBook::get_levels(
+    BookSide side,
+    size_t n,
+    std::vector<PriceLevel>& out) const {
+    
+    out.clear();
+    if (side == BookSide::BID) {
+        for (auto it = bids_.begin(); it != bids_.end() && out.size() < n; ++it) {
+            out.push_back({tick_size_.to_double(it->first), lot_size_.to_double(it->second)});
+        }
+    } else {
+        for (auto it = asks_.begin(); it != asks_.end() && out.size() < n; ++it) {
+            out.push_back({tick_size_.to_double(it->first), lot_size_.to_double(it->second)});
+        }
+    }
+    return out.size();
+}
+
+void L2OrderBook::clear() {
+    levels_by_id_.clear();
+    bids_.clear();
+    asks_.clear();
+    bids_full_ = false;
+    asks_full_ = false;
+}
@@ -4,41 +4,56 @@
 void MarketDepth::update_ask(size_t level, double price, double qty) {
     if (level >= MAX_LEVELS) return;
     
+    const int64_t now = FastClock::now_ns();
     asks[level].price = price;
     asks[level].quantity = qty;
-    asks[level].update_time.store(
-        std::chrono::system_clock::now().time_since_epoch().count(),
-        std::memory_order_release
-    );
-    
-    last_update.store(
-        std::chrono::system_clock::now().time_since_epoch().count(),
-        std::memory_order_release
-    );
+    asks[level].update_time.store(now, std::memory_order_relaxed);
+    last_update.store(now, std::memory_order_release);
 }
 
 void MarketDepth::update_bid(size_t level, double price, double qty) {
     if (level >= MAX_LEVELS) return;
     
+    const int64_t now = FastClock::now_ns();
     bids[level].price = price;
     bids[level].quantity = qty;
-    bids[level].update_time.store(
-        std::chrono::system_clock::now().time_since_epoch().count(),
-        std::memory_order_release
-    );
+    bids[level].update_time.store(now, std::memory_order_relaxed);
+    last_update.store(now, std::memory_order_release);
+}
+
+void MarketDepth::apply_levels(
+    BookSide side,
+    const LevelUpdate* updates,
+    size_t count,
+    int64_t ts) {
+    
+    auto& levels = side == BookSide::BID ? bids : asks;
+    
+    // Visibility to readers comes from the enclosing commit(), so the
+    // per-level stores can stay relaxed
+    for (size_t i = 0; i < count; ++i) {
+        const LevelUpdate& update = updates[i];
+        if (update.level >= MAX_LEVELS) continue;
+        
+        Level& level = levels[update.level];
+        level.price = update.price;
+        level.quantity = update.quantity;
+        level.update_time.store(ts, std::memory_order_relaxed);
+    }
     
-    last_update.store(
-        std::chrono::system_clock::now().time_since_epoch().count(),
-        std::memory_order_release
-    );
+    last_update.store(ts, std::memory_order_release);
 }
 
 double MarketDepth::get_mid_price() const {
-    if (asks[0].price <= 0 || bids[0].price <= 0) return 0.0;
-    return (asks[0].price + bids[0].price) * 0.5;
+    return read_consistent([](const MarketDepth& book) {
+        if (book.asks[0].price <= 0 || book.bids[0].price <= 0) return 0.0;
+        return (book.asks[0].price + book.bids[0].price) * 0.5;
+    });
 }
 
 double MarketDepth::get_spread() const {
-    if (asks[0].price <= 0 || bids[0].price <= 0) return 0.0;
-    return asks[0].price - bids[0].price;
+    return read_consistent([](const MarketDepth& book) {
+        if (book.asks[0].price <= 0 || book.bids[0].price <= 0) return 0.0;
+        return book.asks[0].price - book.bids[0].price;
+    });
 }
@@ -0,0 +1,77 @@
+#include "market_data_hub.h"
+#include <algorithm>
+#include <mutex>
+
+MarketDataHub::Channel& MarketDataHub::channel(const std::string& symbol) {
+    {
+        std::shared_lock<std::shared_mutex> lock(channels_mutex_);
+        auto it = channels_.find(symbol);
+        if (it != channels_.end()) {
+            return *it->second;
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(channels_mutex_);
+    auto& slot = channels_[symbol];
+    if (!slot) {
+        slot = std::make_unique<Channel>(symbol);
+    }
+    return *slot;
+}
+
+MarketDataHub::SubscriptionId MarketDataHub::subscribe(
+    const std::string& symbol,
+    Subscriber subscriber) {
+    
+    Channel& ch = channel(symbol);
+    SubscriptionId id;
+    {
+        std::unique_lock<std::shared_mutex> lock(channels_mutex_);
+        id = next_subscription_id_++;
+        subscriptions_[id] = &ch;
+    }
+    
+    std::lock_guard<std::mutex> lock(ch.write_mutex_);
+    auto updated = std::make_shared<Channel::SubscriberList>(*std::atomic_load(&ch.subscribers_));
+    updated->emplace_back(id, std::move(subscriber));
+    std::atomic_store(&ch.subscribers_, std::shared_ptr<const Channel::SubscriberList>(std::move(updated)));
+    return id;
+}
+
+void MarketDataHub::unsubscribe(SubscriptionId id) {
+    Channel* ch = nullptr;
+    {
+        std::unique_lock<std::shared_mutex> lock(channels_mutex_);
+        auto it = subscriptions_.find(id);
+        if (it == subscriptions_.end()) {
+            return;
+        }
+        ch = it->second;
+        subscriptions_.erase(it);
+    }
+    
+    std::lock_guard<std::mutex> lock(ch->write_mutex_);
+    auto updated = std::make_shared<Channel::SubscriberList>(*std::atomic_load(&ch->subscribers_));
+    updated->erase(
+        std::remove_if(updated->begin(), updated->end(),
+                       [id](const auto& entry) { return entry.first == id; }),
+        updated->end());
+    std::atomic_store(&ch->subscribers_, std::shared_ptr<const Channel::SubscriberList>(std::move(updated)));
+}
+
+void MarketDataHub::publish(Channel& channel, const MarketDepth& depth) {
+    // One consistent copy per tick, shared by every subscriber
+    Snapshot snapshot = std::make_shared<const MarketDepth>(depth);
+    std::atomic_store(&channel.latest_, snapshot);
+    
+    auto subscribers = std::atomic_load(&channel.subscribers_);
+    for (const auto& [id, subscriber] : *subscribers) {
+        subscriber(channel.symbol_, snapshot);
+    }
+}
+
+MarketDataHub::Snapshot MarketDataHub::latest(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(channels_mutex_);
+    auto it = channels_.find(symbol);
+    return it != channels_.end() ? it->second->latest() : nullptr;
+}
@@ -7,17 +7,24 @@ std::optional<Order> OrderManager::place_order(
     double price, 
     double quantity) {
     
-    // Risk checks
-    if (!check_risk_limits(side, quantity, price)) {
+    const Price ticks = tick_size_.from_double<Price>(price);
+    const Qty lots = lot_size_.from_double<Qty>(quantity);
+    if (lots > max_order_size_) {
         return std::nullopt;
     }
     
-    // Create new order
+    // Claim headroom first so concurrent placers cannot both pass
+    const int64_t reserved = side == OrderSide::BUY ? lots.raw() : -lots.raw();
+    if (!exposure_.reserve(reserved, ticks.raw())) {
+        return std::nullopt;
+    }
+    
+    // Create new order, snapped to the instrument's tick and lot grid
     Order order{
         .order_id = generate_order_id(),
         .side = side,
-        .price = price,
-        .quantity = quantity,
+        .price = tick_size_.to_double(ticks),
+        .quantity = lot_size_.to_double(lots),
         .creation_time = std::chrono::system_clock::now().time_since_epoch().count(),
         .last_update_time = std::chrono::system_clock::now().time_since_epoch().count()
     };
@@ -27,64 +34,209 @@ std::optional<Order> OrderManager::place_order(
         std::unique_lock<std::shared_mutex> lock(orders_mutex_);
         
         // Check max active orders
-        if (std::count_if(active_orders_.begin(), active_orders_.end(),
-                         [](const Order& o) { return o.is_active(); }) 
-            >= config_.max_active_orders) {
+        const OrderHandle handle = order_pool_.acquire();
+        if (!handle.valid()) {
+            lock.unlock();
+            exposure_.release(reserved, ticks.raw());
             return std::nullopt;
         }
         
-        active_orders_.push_back(order);
+        *order_pool_.get(handle) = order;
+        order_index_.insert(order.order_id, handle.pack());
+        active_count_.fetch_add(1, std::memory_order_release);
     }
     
     return order;
 }
 
+std::optional<Order> OrderManager::amend_order(
+    int64_t order_id,
+    double price,
+    double quantity) {
+    
+    const Price ticks = tick_size_.from_double<Price>(price);
+    const Qty lots = lot_size_.from_double<Qty>(quantity);
+    if (lots > max_order_size_) {
+        return std::nullopt;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    
+    const uint64_t packed = order_index_.find(order_id);
+    if (packed == OrderIndex::NPOS) {
+        return std::nullopt;
+    }
+    Order& order = *order_pool_.get(PoolHandle::unpack(packed));
+    
+    // Quantity is the order total, as on the exchange; it cannot drop below
+    // what has already filled
+    const int64_t filled = signed_lots(order.side, order.filled_quantity);
+    const int64_t new_remaining = (order.side == OrderSide::BUY ? lots.raw() : -lots.raw()) - filled;
+    if ((order.side == OrderSide::BUY) ? new_remaining <= 0 : new_remaining >= 0) {
+        return std::nullopt;
+    }
+    
+    // Both remainders are briefly held, so an amend near the limit can be
+    // refused even though the order alone would fit
+    if (!exposure_.reserve(new_remaining, ticks.raw())) {
+        return std::nullopt;
+    }
+    exposure_.release(signed_lots(order.side, order.quantity) - filled,
+                      tick_size_.from_double<Price>(order.price).raw());
+    
+    order.price = tick_size_.to_double(ticks);
+    order.quantity = lot_size_.to_double(lots);
+    order.last_update_time = std::chrono::system_clock::now().time_since_epoch().count();
+    return order;
+}
+
+bool OrderManager::restore_order(
+    int64_t order_id,
+    double price,
+    double quantity) {
+    
+    const Price ticks = tick_size_.from_double<Price>(price);
+    
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    
+    const uint64_t packed = order_index_.find(order_id);
+    if (packed == OrderIndex::NPOS) {
+        return false;
+    }
+    Order& order = *order_pool_.get(PoolHandle::unpack(packed));
+    
+    // Fills since the amend still count against the restored total
+    const double restored = std::max(lot_size_.to_double(lot_size_.from_double<Qty>(quantity)),
+                                     order.filled_quantity);
+    const int64_t filled = signed_lots(order.side, order.filled_quantity);
+    exposure_.release(signed_lots(order.side, order.quantity) - filled,
+                      tick_size_.from_double<Price>(order.price).raw());
+    exposure_.reserve_unchecked(signed_lots(order.side, restored) - filled, ticks.raw());
+    
+    order.price = tick_size_.to_double(ticks);
+    order.quantity = restored;
+    order.last_update_time = std::chrono::system_clock::now().time_since_epoch().count();
+    return true;
+}
+
 bool OrderManager::check_risk_limits(
     OrderSide side, 
     double quantity, 
     double price) const {
     
-    if (quantity > config_.max_order_size) {
-        return false;
-    }
-    
-    double current_position = position_.load(std::memory_order_acquire);
-    double position_delta = side == OrderSide::BUY ? quantity : -quantity;
-    double new_position = current_position + position_delta;
+    const Qty lots = lot_size_.from_double<Qty>(quantity);
+    const Price ticks = tick_size_.from_double<Price>(price);
     
-    if (std::abs(new_position) > config_.max_position) {
+    if (lots > max_order_size_) {
         return false;
     }
     
-    double current_notional = notional_exposure_.load(std::memory_order_acquire);
-    double notional_delta = price * quantity;
+    return exposure_.would_fit(signed_lots(side, quantity), ticks.raw());
+}
+
+bool OrderManager::cancel_order(int64_t order_id) {
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
     
-    if (current_notional + notional_delta > config_.max_notional) {
+    const uint64_t packed = order_index_.find(order_id);
+    if (packed == OrderIndex::NPOS) {
         return false;
     }
+    return cancel_locked(PoolHandle::unpack(packed));
+}
+
+bool OrderManager::cancel_order(OrderHandle handle) {
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    return cancel_locked(handle);
+}
+
+size_t OrderManager::cancel_all_orders() {
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
     
-    return true;
+    size_t cancelled = 0;
+    order_pool_.for_each([&](OrderHandle handle) {
+        cancelled += cancel_locked(handle) ? 1 : 0;
+    });
+    return cancelled;
 }
 
 void OrderManager::update_order(const Order& order) {
     std::unique_lock<std::shared_mutex> lock(orders_mutex_);
     
-    auto it = std::find_if(active_orders_.begin(), active_orders_.end(),
-                          [&](const Order& o) { return o.order_id == order.order_id; });
+    const uint64_t packed = order_index_.find(order.order_id);
+    if (packed == OrderIndex::NPOS) {
+        return;
+    }
     
-    if (it != active_orders_.end()) {
-        double fill_delta = order.filled_quantity - it->filled_quantity;
-        
-        if (fill_delta > 0) {
-            // Update position
-            double position_delta = order.side == OrderSide::BUY ? fill_delta : -fill_delta;
-            position_.fetch_add(position_delta, std::memory_order_release);
-            
-            // Update notional exposure
-            double notional_delta = order.price * fill_delta;
-            notional_exposure_.fetch_add(notional_delta, std::memory_order_release);
-        }
-        
-        *it = order;
+    const OrderHandle handle = PoolHandle::unpack(packed);
+    Order& current = *order_pool_.get(handle);
+    
+    // Fills beyond the placed quantity were never reserved; clamp them
+    const double filled = std::min(order.filled_quantity, current.quantity);
+    const int64_t fill_delta = lot_size_.from_double<Qty>(filled).raw() -
+                               lot_size_.from_double<Qty>(current.filled_quantity).raw();
+    if (fill_delta > 0) {
+        exposure_.fill(current.side == OrderSide::BUY ? fill_delta : -fill_delta,
+                       tick_size_.from_double<Price>(current.price).raw());
+        current.filled_quantity = filled;
+    }
+    
+    current.status = order.status;
+    current.last_update_time = order.last_update_time;
+    if (!current.is_active()) {
+        release_locked(handle);
     }
 }
+
+void OrderManager::apply_untracked_fill(OrderSide side, double quantity, double price) {
+    exposure_.fill_unreserved(signed_lots(side, quantity),
+                              tick_size_.from_double<Price>(price).raw());
+}
+
+std::optional<Order> OrderManager::get_order(int64_t order_id) const {
+    std::shared_lock<std::shared_mutex> lock(orders_mutex_);
+    
+    const uint64_t packed = order_index_.find(order_id);
+    if (packed == OrderIndex::NPOS) {
+        return std::nullopt;
+    }
+    return *order_pool_.get(PoolHandle::unpack(packed));
+}
+
+std::optional<Order> OrderManager::get_order(OrderHandle handle) const {
+    std::shared_lock<std::shared_mutex> lock(orders_mutex_);
+    
+    const Order* order = order_pool_.get(handle);
+    if (order == nullptr) {
+        return std::nullopt;
+    }
+    return *order;
+}
+
+OrderManager::OrderHandle OrderManager::find_handle(int64_t order_id) const {
+    std::shared_lock<std::shared_mutex> lock(orders_mutex_);
+    
+    const uint64_t packed = order_index_.find(order_id);
+    return packed == OrderIndex::NPOS ? OrderHandle{} : PoolHandle::unpack(packed);
+}
+
+bool OrderManager::cancel_locked(OrderHandle handle) {
+    Order* order = order_pool_.get(handle);
+    if (order == nullptr) {
+        return false;
+    }
+    
+    order->status = OrderStatus::CANCELLED;
+    release_locked(handle);
+    return true;
+}
+
+void OrderManager::release_locked(OrderHandle handle) {
+    const Order& order = *order_pool_.get(handle);
+    exposure_.release(
+        signed_lots(order.side, order.quantity) - signed_lots(order.side, order.filled_quantity),
+        tick_size_.from_double<Price>(order.price).raw());
+    
+    order_index_.erase(order.order_id);
+    order_pool_.release(handle);
+    active_count_.fetch_sub(1, std::memory_order_release);
+}
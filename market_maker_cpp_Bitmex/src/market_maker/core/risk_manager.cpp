@@ -21,8 +21,8 @@ bool RiskManager::check_order_risk(const Order& order, const MarketDepth& depth)
         return false;
     }
     
-    // Check adverse selection
-    double adverse_selection = calculate_adverse_selection(order, depth);
+    // Check adverse selection against one consistent read of the book
+    double adverse_selection = calculate_adverse_selection(order, depth.get_mid_price());
     if (adverse_selection > limits_.max_adverse_selection) {
         return false;
     }
@@ -73,10 +73,7 @@ void RiskManager::update_metrics(const Order& order, const MarketDepth& depth) {
         }
     }
     
-    // Update price history for VaR calculation
-    if (price_history_.size() > 1000) {
-        price_history_.erase(price_history_.begin());
-    }
+    // Update price history for VaR calculation (evicts the oldest when full)
     price_history_.push_back(depth.get_mid_price());
     
     // Calculate returns and update VaR
@@ -96,9 +93,11 @@ void RiskManager::update_metrics(const Order& order, const MarketDepth& depth) {
 
 double RiskManager::calculate_adverse_selection(
     const Order& order,
-    const MarketDepth& depth) {
+    double mid_price) {
     
-    double mid_price = depth.get_mid_price();
+    if (mid_price <= 0.0) {
+        return 0.0;  // No two-sided book to measure against
+    }
     double execution_price = order.price;
     
     if (order.side == OrderSide::BUY) {
@@ -111,4 +110,16 @@ double RiskManager::calculate_adverse_selection(
 bool RiskManager::run_stress_test(double var, double position_value) {
     double stressed_var = var * limits_.stress_test_multiplier;
     return std::abs(position_value) * stressed_var <= limits_.var_limit;
-} 
\ No newline at end of file
+}
+
+void RiskManager::on_position_delta(const PositionDelta& delta) {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    
+    // OrderManager's position already includes the fill; take it rather than
+    // accumulate deltas so a dropped report cannot leave risk drifting
+    metrics_.position.store(delta.position, std::memory_order_release);
+    
+    if (std::abs(delta.position * delta.price) > limits_.max_position_value) {
+        trigger_circuit_breaker("Position limit exceeded");
+    }
+}
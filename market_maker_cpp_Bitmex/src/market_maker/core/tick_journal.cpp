@@ -0,0 +1,276 @@
+#include "tick_journal.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char JOURNAL_MAGIC[8] = {'M', 'M', 'T', 'I', 'C', 'K', 'J', '\0'};
+
+std::string index_path(const std::string& path) {
+    return path + ".idx";
+}
+
+[[noreturn]] void throw_io_error(const std::string& what, const std::string& path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+JournalFd::~JournalFd() {
+    reset();
+}
+
+void JournalFd::reset(int fd) {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+}
+
+void JournalMapping::reset(void* data, size_t size) {
+    if (data_) {
+        ::munmap(data_, size_);
+    }
+    data_ = static_cast<uint8_t*>(data);
+    size_ = size;
+}
+
+TickJournalWriter::TickJournalWriter(
+    const std::string& path,
+    const std::string& symbol,
+    double tick_size)
+    : path_(path) {
+    
+    fd_.reset(::open(path.c_str(), O_RDWR | O_CREAT, 0644));
+    if (fd_.get() < 0) {
+        throw_io_error("Could not open tick journal", path);
+    }
+    
+    struct stat st{};
+    ::fstat(fd_.get(), &st);
+    const bool existing = st.st_size > 0;
+    
+    // Anything already there must be one of our journals; check before the
+    // file is grown or mapped so a foreign file is left exactly as it was
+    if (existing) {
+        JournalHeader header{};
+        if (::pread(fd_.get(), &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+            header.schema_version != TICK_JOURNAL_SCHEMA_VERSION ||
+            header.record_size != sizeof(JournalRecord) ||
+            std::strncmp(header.symbol, symbol.c_str(), sizeof(header.symbol)) != 0) {
+            throw std::runtime_error("Tick journal header mismatch: " + path);
+        }
+    }
+    
+    grow(std::max<size_t>(st.st_size, GROW_BYTES));
+    
+    if (!existing) {
+        std::memset(header_, 0, sizeof(JournalHeader));
+        std::memcpy(header_->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header_->schema_version = TICK_JOURNAL_SCHEMA_VERSION;
+        header_->record_size = sizeof(JournalRecord);
+        std::strncpy(header_->symbol, symbol.c_str(), sizeof(header_->symbol) - 1);
+        header_->tick_size = tick_size;
+        header_->index_stride = INDEX_STRIDE;
+    }
+    
+    index_file_ = std::fopen(index_path(path).c_str(), existing ? "ab" : "wb");
+    if (!index_file_) {
+        throw_io_error("Could not open tick journal index", index_path(path));
+    }
+}
+
+TickJournalWriter::~TickJournalWriter() {
+    if (header_) {
+        const size_t used = sizeof(JournalHeader) + header_->record_count * sizeof(JournalRecord);
+        ::msync(mapping_.data(), used, MS_SYNC);
+        mapping_.reset();
+        // Drop the preallocated tail so readers see exactly the records
+        if (::ftruncate(fd_.get(), static_cast<off_t>(used)) != 0) {
+            // Nothing sensible to do from a destructor; readers trust record_count
+        }
+    }
+    if (index_file_) {
+        std::fclose(index_file_);
+    }
+}
+
+void TickJournalWriter::grow(size_t min_bytes) {
+    const size_t new_bytes = ((min_bytes + GROW_BYTES - 1) / GROW_BYTES) * GROW_BYTES;
+    if (::ftruncate(fd_.get(), static_cast<off_t>(new_bytes)) != 0) {
+        throw_io_error("Could not extend tick journal", path_);
+    }
+    
+    mapping_.reset();
+    header_ = nullptr;
+    void* mapping = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_.get(), 0);
+    if (mapping == MAP_FAILED) {
+        throw_io_error("Could not map tick journal", path_);
+    }
+    
+    mapping_.reset(mapping, new_bytes);
+    header_ = reinterpret_cast<JournalHeader*>(mapping_.data());
+}
+
+void TickJournalWriter::append(const JournalRecord& record) {
+    const uint64_t n = header_->record_count;
+    const size_t needed = sizeof(JournalHeader) + (n + 1) * sizeof(JournalRecord);
+    if (needed > mapping_.size()) {
+        grow(needed);
+    }
+    
+    records()[n] = record;
+    header_->record_count = n + 1;
+    
+    if (n % INDEX_STRIDE == 0) {
+        const JournalIndexEntry entry{record.timestamp_ns, n};
+        std::fwrite(&entry, sizeof(entry), 1, index_file_);
+    }
+}
+
+void TickJournalWriter::append_book(
+    int64_t ts,
+    BookSide side,
+    const LevelUpdate* updates,
+    size_t count,
+    bool end_of_update) {
+    
+    for (size_t i = 0; i < count; ++i) {
+        JournalRecord record{};
+        record.timestamp_ns = ts;
+        record.type = JournalRecord::BOOK_LEVEL;
+        record.side = static_cast<uint8_t>(side);
+        record.flags = end_of_update && i + 1 == count ? JournalRecord::END_OF_UPDATE
+                                                       : JournalRecord::NONE;
+        record.level = static_cast<uint32_t>(updates[i].level);
+        record.price = updates[i].price;
+        record.quantity = updates[i].quantity;
+        append(record);
+    }
+}
+
+void TickJournalWriter::append_trade(
+    int64_t ts,
+    BookSide aggressor,
+    double price,
+    double quantity) {
+    
+    JournalRecord record{};
+    record.timestamp_ns = ts;
+    record.type = JournalRecord::TRADE;
+    record.side = static_cast<uint8_t>(aggressor);
+    record.price = price;
+    record.quantity = quantity;
+    append(record);
+}
+
+void TickJournalWriter::flush() {
+    const size_t used = sizeof(JournalHeader) + header_->record_count * sizeof(JournalRecord);
+    ::msync(mapping_.data(), used, MS_ASYNC);
+    std::fflush(index_file_);
+}
+
+TickJournalReader::TickJournalReader(const std::string& path) {
+    fd_.reset(::open(path.c_str(), O_RDONLY));
+    if (fd_.get() < 0) {
+        throw_io_error("Could not open tick journal", path);
+    }
+    
+    struct stat st{};
+    ::fstat(fd_.get(), &st);
+    if (static_cast<size_t>(st.st_size) < sizeof(JournalHeader)) {
+        throw std::runtime_error("Tick journal too short: " + path);
+    }
+    
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd_.get(), 0);
+    if (mapping == MAP_FAILED) {
+        throw_io_error("Could not map tick journal", path);
+    }
+    mapping_.reset(mapping, bytes);
+    ::madvise(mapping, bytes, MADV_SEQUENTIAL);
+    
+    header_ = reinterpret_cast<const JournalHeader*>(mapping_.data());
+    if (std::memcmp(header_->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        header_->schema_version != TICK_JOURNAL_SCHEMA_VERSION ||
+        header_->record_size != sizeof(JournalRecord)) {
+        throw std::runtime_error("Unsupported tick journal: " + path);
+    }
+    
+    records_ = reinterpret_cast<const JournalRecord*>(mapping_.data() + sizeof(JournalHeader));
+    const size_t capacity = (bytes - sizeof(JournalHeader)) / sizeof(JournalRecord);
+    count_ = std::min<size_t>(header_->record_count, capacity);
+    
+    // The sparse index is optional; without it seek() bisects the records
+    index_fd_.reset(::open(index_path(path).c_str(), O_RDONLY));
+    if (index_fd_.get() >= 0) {
+        struct stat index_st{};
+        ::fstat(index_fd_.get(), &index_st);
+        const size_t index_bytes = static_cast<size_t>(index_st.st_size);
+        if (index_bytes >= sizeof(JournalIndexEntry)) {
+            void* index_mapping = ::mmap(nullptr, index_bytes, PROT_READ, MAP_SHARED, index_fd_.get(), 0);
+            if (index_mapping != MAP_FAILED) {
+                index_mapping_.reset(index_mapping, index_bytes);
+                index_ = reinterpret_cast<const JournalIndexEntry*>(index_mapping_.data());
+                index_count_ = index_bytes / sizeof(JournalIndexEntry);
+            }
+        }
+    }
+}
+
+size_t TickJournalReader::seek(int64_t ts) const {
+    size_t lo = 0;
+    size_t hi = count_;
+    
+    if (index_count_ > 0) {
+        // Last index entry strictly before ts bounds the search from below;
+        // the next one bounds it from above
+        auto it = std::lower_bound(index_, index_ + index_count_, ts,
+            [](const JournalIndexEntry& entry, int64_t t) { return entry.timestamp_ns < t; });
+        if (it != index_) {
+            lo = std::min<size_t>((it - 1)->record, count_);
+        }
+        if (it != index_ + index_count_) {
+            hi = std::min<size_t>(it->record + 1, count_);
+        }
+    }
+    
+    auto first = std::lower_bound(records_ + lo, records_ + hi, ts,
+        [](const JournalRecord& record, int64_t t) { return record.timestamp_ns < t; });
+    return static_cast<size_t>(first - records_);
+}
+
+TickJournalReader::Range TickJournalReader::range(int64_t from_ns, int64_t to_ns) const {
+    const size_t first = seek(from_ns);
+    const size_t last = std::max(first, seek(to_ns));
+    return {records_ + first, records_ + last};
+}
+
+bool TickJournalReplay::next(MarketDepth& depth) {
+    bool applied = false;
+    
+    depth.begin_update();
+    while (cursor_ != last_) {
+        const JournalRecord& record = *cursor_++;
+        if (record.type != JournalRecord::BOOK_LEVEL) {
+            continue;
+        }
+        
+        const LevelUpdate update{record.level, record.price, record.quantity};
+        depth.apply_levels(static_cast<BookSide>(record.side), &update, 1, record.timestamp_ns);
+        applied = true;
+        
+        if (record.flags & JournalRecord::END_OF_UPDATE) {
+            break;
+        }
+    }
+    depth.commit();
+    
+    return applied;
+}
@@ -1,154 +1,506 @@
 #include "bitmex_connector.h"
-#include <pybind11/embed.h>
-
-BitMEXConnector::BitMEXConnector(const Config& config) : config_(config) {
-    init_python();
-    
-    // Import BitMEX module and create instance
-    py::module bitmex = py::module::import("market_maker.auth.bitmex");
-    bitmex_instance_ = bitmex.attr("BitMEX")(
-        py::arg("base_url") = config.base_url,
-        py::arg("symbol") = config.symbol,
-        py::arg("apiKey") = config.api_key,
-        py::arg("apiSecret") = config.api_secret,
-        py::arg("orderIDPrefix") = config.order_id_prefix,
-        py::arg("shouldWSAuth") = config.should_ws_auth,
-        py::arg("postOnly") = config.post_only,
-        py::arg("timeout") = config.timeout
-    );
-}
-
-void BitMEXConnector::init_python() {
-    static pybind11::scoped_interpreter guard{};
-    
-    // Import required Python modules
-    py::module::import("market_maker.auth.APIKeyAuth");
-    py::module::import("market_maker.auth.APIKeyAuthWithExpires");
-}
-
-bool BitMEXConnector::place_order(const Order& order) {
-    try {
-        py::dict order_dict;
-        convert_order_to_dict(order, order_dict);
-        
-        py::object result = bitmex_instance_.attr("place_order")(order_dict);
-        return !result.is_none();
-    }
-    catch (const py::error_already_set& e) {
-        // Handle Python exceptions
+#include <condition_variable>
+#include <mutex>
+
+namespace {
+
+// Cancels jump the queue on their connection
+RestConnectionPool::Lane lane_for(RateLimiter::Priority priority) {
+    return priority == RateLimiter::Priority::CANCEL ? RestConnectionPool::Lane::PRIORITY
+                                                     : RestConnectionPool::Lane::NORMAL;
+}
+
+}  // namespace
+
+BitMEXConnector::BitMEXConnector(const Config& config)
+    : config_(config)
+    , rest_({config.base_url, config.api_key, config.api_secret, config.timeout},
+            config.rest_connections)
+    , l2_book_(TickSize(config.tick_size), TickSize(config.lot_size))
+    , order_ids_(config_.order_id_prefix, config.max_tracked_orders)
+    , buy_template_(config.symbol, OrderSide::BUY, config.post_only, config.tick_size, config.lot_size)
+    , sell_template_(config.symbol, OrderSide::SELL, config.post_only, config.tick_size, config.lot_size)
+    , rate_limiter_(config.rate_limit) {}
+
+BitMEXConnector::~BitMEXConnector() {
+    // Stop the feed thread and the pool's completions before the book,
+    // callbacks and rate limiter they use go away
+    ws_.reset();
+    rest_.stop();
+}
+
+MarketDepth BitMEXConnector::get_order_book() {
+    auto response = send(
+        RateLimiter::Priority::NORMAL, "GET", "/orderBook/L2",
+        "symbol=" + config_.symbol + "&depth=" + std::to_string(MarketDepth::MAX_LEVELS), {});
+    if (!response.ok()) {
+        throw std::runtime_error("orderBook/L2 request failed: " +
+                                 (response.error.empty() ? response.body : response.error));
+    }
+    
+    // Snapshot through a private ladder; l2_book_ belongs to the feed thread
+    L2OrderBook book(TickSize(config_.tick_size), TickSize(config_.lot_size));
+    std::vector<L2OrderBook::Entry> entries;
+    for (const auto& level : nlohmann::json::parse(response.body)) {
+        entries.push_back(book.make_entry(
+            level.at("id").get<int64_t>(),
+            level.at("side").get<std::string>() == "Buy" ? BookSide::BID : BookSide::ASK,
+            level.at("price").get<double>(),
+            level.at("size").get<double>()
+        ));
+    }
+    
+    MarketDepth depth;
+    book.apply(L2OrderBook::Action::PARTIAL, entries.data(), entries.size(), depth);
+    return depth;
+}
+
+bool BitMEXConnector::place_order(const Order& order, BitMEXRestClient::Response* reply) {
+    if (new_orders_halted()) {
+        return refuse_halted(reply);
+    }
+    std::string body;
+    append_order_body(order, body);
+    return keep(send(RateLimiter::Priority::NORMAL, "POST", "/order", {}, body, order.order_id),
+                reply);
+}
+
+bool BitMEXConnector::cancel_order(int64_t order_id) {
+    const std::string body = nlohmann::json{{"clOrdID", client_order_id(order_id)}}.dump();
+    return send(RateLimiter::Priority::CANCEL, "DELETE", "/order", {}, body, order_id).ok();
+}
+
+bool BitMEXConnector::amend_order(const Order& order) {
+    if (new_orders_halted()) {
         return false;
     }
+    return send(RateLimiter::Priority::NORMAL, "PUT", "/order", {},
+                convert_amend_to_json(order).dump(), order.order_id).ok();
 }
 
-MarketDepth BitMEXConnector::convert_orderbook_to_depth(const py::dict& orderbook) {
-    MarketDepth depth;
+bool BitMEXConnector::place_orders(const Order* orders, size_t count,
+                                   BitMEXRestClient::Response* reply) {
+    if (count == 0) {
+        return true;
+    }
+    if (new_orders_halted()) {
+        return refuse_halted(reply);
+    }
+    return keep(send(RateLimiter::Priority::NORMAL, "POST", "/order/bulk", {},
+                     place_orders_body(orders, count)), reply);
+}
+
+bool BitMEXConnector::amend_orders(const Order* orders, size_t count,
+                                   BitMEXRestClient::Response* reply) {
+    if (count == 0) {
+        return true;
+    }
+    if (new_orders_halted()) {
+        return refuse_halted(reply);
+    }
+    return keep(send(RateLimiter::Priority::NORMAL, "PUT", "/order/bulk", {},
+                     amend_orders_body(orders, count)), reply);
+}
+
+bool BitMEXConnector::cancel_orders(const int64_t* order_ids, size_t count,
+                                    BitMEXRestClient::Response* reply) {
+    if (count == 0) {
+        return true;
+    }
+    return keep(send(RateLimiter::Priority::CANCEL, "DELETE", "/order", {},
+                     cancel_orders_body(order_ids, count)), reply);
+}
+
+std::string BitMEXConnector::place_orders_body(const Order* orders, size_t count) const {
+    std::string body;
+    body.reserve(16 + count * (buy_template_.size() + 1));
+    body.append("{\"orders\":[");
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            body.push_back(',');
+        }
+        append_order_body(orders[i], body);
+    }
+    body.append("]}");
+    return body;
+}
+
+std::string BitMEXConnector::amend_orders_body(const Order* orders, size_t count) const {
+    nlohmann::json body{{"orders", nlohmann::json::array()}};
+    auto& list = body["orders"];
+    for (size_t i = 0; i < count; ++i) {
+        list.push_back(convert_amend_to_json(orders[i]));
+    }
+    return body.dump();
+}
+
+std::string BitMEXConnector::cancel_orders_body(const int64_t* order_ids, size_t count) const {
+    // DELETE /order takes an array of clOrdIDs
+    nlohmann::json ids = nlohmann::json::array();
+    for (size_t i = 0; i < count; ++i) {
+        ids.push_back(client_order_id(order_ids[i]));
+    }
+    return nlohmann::json{{"clOrdID", std::move(ids)}}.dump();
+}
+
+std::optional<bool> BitMEXConnector::has_order(int64_t order_id) {
+    return find_order(send(RateLimiter::Priority::NORMAL, "GET", "/order",
+                           order_filter(order_id), {}, order_id),
+                      order_id);
+}
+
+void BitMEXConnector::has_order_async(int64_t order_id,
+                                      std::function<void(std::optional<bool>)> done) {
+    send_async(RateLimiter::Priority::NORMAL, "GET", "/order", order_filter(order_id), {},
+               [this, order_id, done = std::move(done)](const BitMEXRestClient::Response& reply) {
+                   done(find_order(reply, order_id));
+               }, order_id);
+}
+
+std::string BitMEXConnector::order_filter(int64_t order_id) const {
+    // filter={"clOrdID":"..."}, URL-encoded; our ids need no escaping
+    return "filter=%7B%22clOrdID%22%3A%22" + client_order_id(order_id) + "%22%7D&count=1";
+}
+
+std::optional<bool> BitMEXConnector::find_order(const BitMEXRestClient::Response& response,
+                                                int64_t order_id) const {
+    if (!response.ok()) {
+        return std::nullopt;
+    }
+    const auto rows = nlohmann::json::parse(response.body, nullptr, false);
+    if (!rows.is_array()) {
+        return std::nullopt;
+    }
+    // Checked here too, in case the filter was not applied
+    const std::string cl_ord_id = client_order_id(order_id);
+    for (const auto& row : rows) {
+        if (row.is_object() && row.value("clOrdID", "") == cl_ord_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BitMEXConnector::place_order_async(const Order& order, Completion done) {
+    if (new_orders_halted()) {
+        refuse_halted(done);
+        return;
+    }
+    std::string body;
+    append_order_body(order, body);
+    send_async(RateLimiter::Priority::NORMAL, "POST", "/order", {}, std::move(body),
+               std::move(done), order.order_id);
+}
+
+void BitMEXConnector::amend_order_async(const Order& order, Completion done) {
+    if (new_orders_halted()) {
+        refuse_halted(done);
+        return;
+    }
+    send_async(RateLimiter::Priority::NORMAL, "PUT", "/order", {},
+               convert_amend_to_json(order).dump(), std::move(done), order.order_id);
+}
+
+void BitMEXConnector::cancel_order_async(int64_t order_id, Completion done) {
+    send_async(RateLimiter::Priority::CANCEL, "DELETE", "/order", {},
+               nlohmann::json{{"clOrdID", client_order_id(order_id)}}.dump(), std::move(done),
+               order_id);
+}
+
+bool BitMEXConnector::cancel_all_orders() {
+    // No symbol filter: the kill switch must reach every instrument
+    return send(RateLimiter::Priority::CANCEL, "DELETE", "/order/all", {}, {}).ok();
+}
+
+bool BitMEXConnector::cancel_all_after(std::chrono::milliseconds timeout) {
+    const std::string body = "{\"timeout\":" + std::to_string(timeout.count()) + "}";
+    return send(RateLimiter::Priority::CANCEL, "POST", "/order/cancelAllAfter", {}, body).ok();
+}
+
+BatchResult BitMEXConnector::send_batch(const OrderBatch& batch) {
+    // Stages touch disjoint orders, so each bulk request goes out at once on
+    // its own pooled connection and the batch costs one round trip
+    BatchResult result;
+    result.cancels = batch.cancels.empty();
+    result.amends = batch.amends.empty();
+    result.places = batch.places.empty();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int pending = !result.cancels + !result.amends + !result.places;
+    auto record = [&](bool& accepted) {
+        return [&](const BitMEXRestClient::Response& reply) {
+            std::lock_guard<std::mutex> lock(mutex);
+            accepted = reply.ok();
+            if (--pending == 0) {
+                cv.notify_one();
+            }
+        };
+    };
+
+    if (!result.cancels) {
+        send_async(RateLimiter::Priority::CANCEL, "DELETE", "/order", {},
+                   cancel_orders_body(batch.cancels.data(), batch.cancels.size()),
+                   record(result.cancels));
+    }
+    if (!result.amends) {
+        if (new_orders_halted()) {
+            refuse_halted(record(result.amends));
+        } else {
+            send_async(RateLimiter::Priority::NORMAL, "PUT", "/order/bulk", {},
+                       amend_orders_body(batch.amends.data(), batch.amends.size()),
+                       record(result.amends));
+        }
+    }
+    if (!result.places) {
+        if (new_orders_halted()) {
+            refuse_halted(record(result.places));
+        } else {
+            send_async(RateLimiter::Priority::NORMAL, "POST", "/order/bulk", {},
+                       place_orders_body(batch.places.data(), batch.places.size()),
+                       record(result.places));
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return pending == 0; });
+    return result;
+}
+
+BitMEXRestClient::Response BitMEXConnector::send(
+    RateLimiter::Priority priority,
+    std::string_view verb,
+    std::string_view endpoint,
+    std::string_view query,
+    std::string_view body,
+    int64_t order_id) {
     
-    // Convert asks
-    py::list asks = orderbook["asks"].cast<py::list>();
-    for (size_t i = 0; i < std::min(asks.size(), MarketDepth::MAX_LEVELS); ++i) {
-        py::dict level = asks[i].cast<py::dict>();
-        depth.update_ask(i,
-            level["price"].cast<double>(),
-            level["size"].cast<double>()
-        );
+    if (!rate_limiter_.try_acquire(priority)) {
+        BitMEXRestClient::Response throttled;
+        throttled.status = 429;
+        throttled.error = "Local rate limit";
+        throttled.unsent = true;
+        return throttled;
     }
+    auto response = rest_.request(lane_for(priority), verb, endpoint, query, body, order_id);
+    sync_rate_limit(response);
+    return response;
+}
+
+void BitMEXConnector::send_async(
+    RateLimiter::Priority priority,
+    std::string_view verb,
+    std::string_view endpoint,
+    std::string_view query,
+    std::string body,
+    Completion done,
+    int64_t order_id) {
     
-    // Convert bids
-    py::list bids = orderbook["bids"].cast<py::list>();
-    for (size_t i = 0; i < std::min(bids.size(), MarketDepth::MAX_LEVELS); ++i) {
-        py::dict level = bids[i].cast<py::dict>();
-        depth.update_bid(i,
-            level["price"].cast<double>(),
-            level["size"].cast<double>()
-        );
+    if (!rate_limiter_.try_acquire(priority)) {
+        if (done) {
+            BitMEXRestClient::Response throttled;
+            throttled.status = 429;
+            throttled.error = "Local rate limit";
+            throttled.unsent = true;
+            done(throttled);
+        }
+        return;
+    }
+    rest_.submit(lane_for(priority), verb, endpoint, query, std::move(body),
+                 [this, done = std::move(done)](const BitMEXRestClient::Response& response) {
+                     sync_rate_limit(response);
+                     if (done) {
+                         done(response);
+                     }
+                 }, order_id);
+}
+
+bool BitMEXConnector::refuse_halted(BitMEXRestClient::Response* reply) {
+    if (reply != nullptr) {
+        *reply = {};
+        reply->error = "New orders halted";
+        reply->unsent = true;
+    }
+    return false;
+}
+
+void BitMEXConnector::refuse_halted(const Completion& done) {
+    if (done) {
+        BitMEXRestClient::Response refused;
+        refuse_halted(&refused);
+        done(refused);
+    }
+}
+
+bool BitMEXConnector::keep(BitMEXRestClient::Response&& response, BitMEXRestClient::Response* reply) {
+    const bool ok = response.ok();
+    if (reply != nullptr) {
+        *reply = std::move(response);
+    }
+    return ok;
+}
+
+void BitMEXConnector::sync_rate_limit(const BitMEXRestClient::Response& response) {
+    const int64_t now = RateLimiter::now_ns();
+    if (response.retry_after >= 0 && (response.status == 429 || response.status == 503)) {
+        rate_limiter_.hold_off(response.retry_after * 1'000'000'000, now);
+        return;
+    }
+    if (response.ratelimit_remaining >= 0) {
+        // x-ratelimit-reset is wall-clock seconds
+        int64_t reset_in_ns = 0;
+        if (response.ratelimit_reset > 0) {
+            const int64_t wall_now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            reset_in_ns = std::max<int64_t>(response.ratelimit_reset * 1'000'000'000 - wall_now_ns, 0);
+        }
+        rate_limiter_.sync_minute(response.ratelimit_remaining, reset_in_ns, now);
+    }
+    if (response.ratelimit_remaining_1s >= 0) {
+        rate_limiter_.sync_second(response.ratelimit_remaining_1s, now);
     }
+}
+
+bool BitMEXConnector::apply_orderbook_l2(const bitmex_frame::Frame& frame, MarketDepth& depth) {
+    l2_entries_.clear();
+    if (!bitmex_frame::parse_l2(frame.data, l2_book_, l2_entries_)) {
+        return false;
+    }
+    return l2_book_.apply(frame.action, l2_entries_.data(), l2_entries_.size(), depth);
+}
+
+void BitMEXConnector::append_order_body(const Order& order, std::string& body) const {
+    const OrderTemplate& order_template = order.side == OrderSide::BUY ? buy_template_ : sell_template_;
+    char cl_ord_id[OrderIdMap::MAX_CL_ORD_ID];
+    const size_t cl_ord_id_len = order_ids_.format_cl_ord_id(order.order_id, cl_ord_id);
     
-    return depth;
+    const size_t start = body.size();
+    body.resize(start + order_template.size());
+    if (cl_ord_id_len == 0 ||
+        !order_template.render(std::string_view(cl_ord_id, cl_ord_id_len), order.price,
+                               order.quantity, body.data() + start)) {
+        body.resize(start);
+        body.append(convert_order_to_json(order).dump());
+    }
 }
 
-void BitMEXConnector::convert_order_to_dict(const Order& order, py::dict& order_dict) {
-    order_dict["symbol"] = config_.symbol;
-    order_dict["side"] = order.side == OrderSide::BUY ? "Buy" : "Sell";
-    order_dict["orderQty"] = order.quantity;
-    order_dict["price"] = order.price;
-    order_dict["ordType"] = "Limit";
+nlohmann::json BitMEXConnector::convert_order_to_json(const Order& order) const {
+    nlohmann::json order_json{
+        {"symbol", config_.symbol},
+        {"side", order.side == OrderSide::BUY ? "Buy" : "Sell"},
+        {"orderQty", order.quantity},
+        {"price", order.price},
+        {"ordType", "Limit"},
+        {"clOrdID", client_order_id(order.order_id)}
+    };
     
     if (config_.post_only) {
-        order_dict["execInst"] = "ParticipateDoNotInitiate";
+        order_json["execInst"] = "ParticipateDoNotInitiate";
     }
+    return order_json;
 }
 
-void BitMEXConnector::subscribe_market_data(
-    const std::function<void(const MarketDepth&)>& callback) {
-    
-    // Import WebSocket module
-    py::module ws = py::module::import("market_maker.ws.ws_thread");
-    
-    // Create WebSocket instance
-    ws_thread_ = ws.attr("BitMEXWebsocket")(
-        py::arg("endpoint") = config_.base_url,
-        py::arg("symbol") = config_.symbol,
-        py::arg("api_key") = config_.api_key,
-        py::arg("api_secret") = config_.api_secret
-    );
+nlohmann::json BitMEXConnector::convert_amend_to_json(const Order& order) const {
+    return nlohmann::json{
+        {"origClOrdID", client_order_id(order.order_id)},
+        {"orderQty", order.quantity},
+        {"price", order.price}
+    };
+}
+
+Order BitMEXConnector::convert_json_to_order(const nlohmann::json& order_json) const {
+    Order order{};
     
-    // Subscribe to orderBook10 topic
-    ws_thread_.attr("subscribe")(py::str("orderBook10"));
+    order.order_id = order_ids_.parse_cl_ord_id(order_json.value("clOrdID", ""));
     
-    // Start WebSocket thread
-    ws_thread_.attr("connect")();
+    order.side = order_json.value("side", "") == "Buy" ? OrderSide::BUY : OrderSide::SELL;
+    order.price = order_json.value("price", 0.0);
+    order.quantity = order_json.value("orderQty", 0.0);
+    order.filled_quantity = order_json.value("cumQty", 0.0);
     
-    // Create callback wrapper
-    auto py_callback = [callback](const py::dict& data) {
-        MarketDepth depth = convert_orderbook_to_depth(data);
-        callback(depth);
-    };
+    const std::string status = order_json.value("ordStatus", "New");
+    if (status == "Filled") {
+        order.status = OrderStatus::FILLED;
+    } else if (status == "PartiallyFilled") {
+        order.status = OrderStatus::PARTIALLY_FILLED;
+    } else if (status == "Canceled") {
+        order.status = OrderStatus::CANCELLED;
+    } else if (status == "Rejected") {
+        order.status = OrderStatus::REJECTED;
+    } else {
+        order.status = OrderStatus::NEW;
+    }
     
-    // Register callback
-    ws_thread_.attr("on_message")(py::cpp_function(py_callback));
-} 
+    order.last_update_time = std::chrono::system_clock::now().time_since_epoch().count();
+    return order;
+}
 
-bool BitMEXConnector::ensure_connection() {
-    if (connection_state_.is_connected) {
-        return true;
-    }
+void BitMEXConnector::subscribe_market_data(
+    const std::function<void(const MarketDepth&)>& callback) {
     
-    if (connection_state_.retry_count >= ConnectionState::MAX_RETRIES) {
-        throw std::runtime_error("Max connection retries exceeded");
-    }
+    // The live book is updated in place and only reported when its top
+    // levels actually changed
+    market_data_callback_ = callback;
     
-    try {
-        reset_connection();
-        connection_state_.is_connected = true;
-        connection_state_.retry_count = 0;
-        connection_state_.last_heartbeat = std::chrono::steady_clock::now();
-        return true;
-    }
-    catch (const std::exception& e) {
-        handle_connection_error();
-        return false;
+    // Subscribe to incremental L2 updates, and to the tape when it is journaled
+    ensure_ws("orderBookL2:" + config_.symbol);
+    if (journal_) {
+        ensure_ws("trade:" + config_.symbol);
     }
 }
 
-void BitMEXConnector::handle_connection_error() {
-    connection_state_.is_connected = false;
-    connection_state_.retry_count++;
+void BitMEXConnector::ensure_ws(const std::string& topic) {
+    if (ws_) {
+        ws_->subscribe({topic});
+        return;
+    }
     
-    std::this_thread::sleep_for(ConnectionState::RETRY_DELAY);
-} 
+    BitMEXWebSocketClient::Config ws_config;
+    ws_config.url = config_.ws_url.empty() ? BitMEXWebSocketClient::realtime_url(config_.base_url)
+                                           : config_.ws_url;
+    if (config_.should_ws_auth) {
+        ws_config.api_key = config_.api_key;
+    }
+    ws_config.api_secret = config_.api_secret;
+    ws_config.subscriptions = {topic};
+    ws_ = std::make_unique<BitMEXWebSocketClient>(
+        std::move(ws_config),
+        [this](std::string_view text) { handle_ws_message(text); });
+    ws_->start();
+}
 
-bool BitMEXConnector::RateLimiter::should_throttle() {
-    std::lock_guard<std::mutex> lock(mutex);
-    auto now = std::chrono::steady_clock::now();
-    
-    // Remove old requests
-    while (!request_times.empty() && 
-           now - request_times.front() > std::chrono::minutes(1)) {
-        request_times.pop_front();
+void BitMEXConnector::handle_ws_message(std::string_view text) {
+    bitmex_frame::Frame frame;
+    if (!bitmex_frame::parse_frame(text, frame)) {
+        return;
     }
     
-    return request_times.size() >= MAX_REQUESTS_PER_MINUTE;
-} 
+    switch (frame.table) {
+    case bitmex_frame::Table::ORDER_BOOK_L2:
+        if (apply_orderbook_l2(frame, *live_depth_) && market_data_callback_) {
+            market_data_callback_(*live_depth_);
+        }
+        break;
+    case bitmex_frame::Table::EXECUTION:
+        bitmex_frame::for_each_execution(frame.data, [this](const bitmex_frame::ExecutionRow& row) {
+            apply_execution(row);
+        });
+        break;
+    case bitmex_frame::Table::TRADE:
+        // Stamped on receipt like the book updates, so the journal stays in
+        // timestamp order across both record types
+        if (journal_) {
+            const int64_t now = FastClock::now_ns();
+            bitmex_frame::for_each_trade(frame.data, [&](const bitmex_frame::TradeRow& row) {
+                journal_->append_trade(now, row.side == "Buy" ? BookSide::BID : BookSide::ASK,
+                                       row.price, row.size);
+            });
+        }
+        break;
+    default:
+        break;
+    }
+}
 
 void BitMEXConnector::subscribe_executions(
     const std::function<void(const ExecutionUpdate&)>& callback) {
@@ -156,32 +508,80 @@ void BitMEXConnector::subscribe_executions(
     execution_callback_ = callback;
     
     // Subscribe to execution topic on WebSocket
-    ws_thread_.attr("subscribe")(py::str("execution"));
-    
-    // Add execution handler
-    auto py_execution_handler = [this](const py::dict& data) {
-        ExecutionUpdate update;
-        update.order_id = data["orderID"].cast<int64_t>();
-        update.exec_id = data["execID"].cast<std::string>();
-        update.exec_price = data["price"].cast<double>();
-        update.exec_quantity = data["lastQty"].cast<double>();
-        update.exec_type = data["execType"].cast<std::string>();
-        update.timestamp = std::chrono::system_clock::now();
-        
-        // Store execution
-        {
-            std::lock_guard<std::mutex> lock(execution_mutex_);
-            execution_history_.push_back(update);
-            if (execution_history_.size() > 1000) {
-                execution_history_.pop_front();
-            }
-        }
-        
-        // Notify callback
-        if (execution_callback_) {
-            execution_callback_(update);
-        }
-    };
+    ensure_ws("execution:" + config_.symbol);
+}
+
+void BitMEXConnector::apply_execution(const bitmex_frame::ExecutionRow& row) {
+    // Our orders carry the internal id after the clOrdID prefix; rows that
+    // only name the exchange orderID resolve through the id learnt earlier
+    ExecutionReport& report = report_scratch_;
+    report.order_id = order_ids_.parse_cl_ord_id(row.cl_ord_id);
+    if (report.order_id != 0) {
+        order_ids_.bind(report.order_id, row.order_id);
+    } else {
+        report.order_id = order_ids_.find(row.order_id);
+    }
+    report.exec_type = ExecutionReport::parse_exec_type(row.exec_type);
+    // A trade row without leavesQty does not say the order is done; only a
+    // terminal ordStatus or an explicit zero does
+    const bool closed = report.exec_type == ExecType::CANCELED ||
+                        report.exec_type == ExecType::REJECTED ||
+                        row.ord_status == "Filled" || row.ord_status == "Canceled" ||
+                        row.ord_status == "Rejected" ||
+                        (report.exec_type == ExecType::TRADE && row.has_leaves_qty && row.leaves_qty == 0.0);
+    if (closed && report.order_id != 0) {
+        order_ids_.erase(report.order_id);
+    }
+    report.side = row.side == "Sell" ? OrderSide::SELL : OrderSide::BUY;
+    report.last_px = row.last_px;
+    report.last_qty = row.last_qty;
+    report.cum_qty = row.cum_qty;
+    report.leaves_qty = row.leaves_qty;
+    report.has_leaves_qty = row.has_leaves_qty;
+    report.timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+    report.set_exec_id(row.exec_id);
     
-    ws_thread_.attr("on_execution")(py::cpp_function(py_execution_handler));
-} 
\ No newline at end of file
+    execution_history_.push(report);
+    if (reconciler_) {
+        reconciler_->enqueue(report);
+    }
+    
+    // Notify callback
+    if (execution_callback_) {
+        ExecutionUpdate& update = execution_scratch_;
+        update.order_id = report.order_id;
+        update.exec_id.assign(row.exec_id);
+        update.exec_price = row.last_px;
+        update.exec_quantity = row.last_qty;
+        update.exec_type.assign(row.exec_type);
+        update.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(report.timestamp));
+        execution_callback_(update);
+    }
+}
+
+std::vector<BitMEXConnector::ExecutionUpdate> BitMEXConnector::get_recent_executions(size_t n) {
+    static constexpr std::string_view EXEC_TYPES[] = {
+        "New", "Trade", "Canceled", "Rejected", "Replaced", "Other"};
+    
+    std::vector<ExecutionUpdate> updates;
+    const auto view = execution_history_.recent(n);
+    updates.reserve(view.size());
+    ExecutionReport report;
+    for (size_t i = 0; i < view.size(); ++i) {
+        // Entries overwritten while we read are skipped
+        if (!view.copy(i, report)) {
+            continue;
+        }
+        updates.push_back({
+            .order_id = report.order_id,
+            .exec_id = std::string(report.exec_id_view()),
+            .exec_price = report.last_px,
+            .exec_quantity = report.last_qty,
+            .exec_type = std::string(EXEC_TYPES[static_cast<size_t>(report.exec_type)]),
+            .timestamp = std::chrono::system_clock::time_point(
+                std::chrono::system_clock::duration(report.timestamp))
+        });
+    }
+    return updates;
+}
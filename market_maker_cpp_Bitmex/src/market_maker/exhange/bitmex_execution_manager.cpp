@@ -1,42 +1,323 @@
 #include "bitmex_execution_manager.h"
+#include <limits>
 #include <thread>
 
+namespace {
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+BitMEXExecutionManager::BitMEXExecutionManager(
+    std::shared_ptr<BitMEXConnector> connector,
+    std::shared_ptr<OrderManager> order_manager)
+    : BitMEXExecutionManager(std::move(connector), std::move(order_manager), ExecutionConfig{}) {}
+
+BitMEXExecutionManager::BitMEXExecutionManager(
+    std::shared_ptr<BitMEXConnector> connector,
+    std::shared_ptr<OrderManager> order_manager,
+    ExecutionConfig config)
+    : connector_(std::move(connector))
+    , order_manager_(std::move(order_manager))
+    , config_(config)
+    , retry_wheel_(RETRY_WHEEL_SLOTS, RETRY_WHEEL_TICK_NS, config.max_pending_retries, steady_now_ns())
+    , jitter_rng_(std::random_device{}()) {
+    submit_thread_ = std::thread([this] { run_submissions(); });
+}
+
+BitMEXExecutionManager::~BitMEXExecutionManager() {
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        stopping_ = true;
+    }
+    submit_cv_.notify_one();
+    submit_thread_.join();
+    
+    // Replies still to come land on pool threads and call back into us
+    std::unique_lock<std::mutex> lock(submit_mutex_);
+    idle_cv_.wait(lock, [this] { return requests_in_flight_ == 0; });
+}
+
 bool BitMEXExecutionManager::submit_order(Order& order) {
     // Perform risk checks
     if (!check_risk_limits(order)) {
         return false;
     }
     
-    // Try to submit the order
-    return retry_order_submission(order);
-}
-
-bool BitMEXExecutionManager::retry_order_submission(Order& order, int attempts) {
-    while (attempts < config_.max_retry_attempts) {
-        try {
-            if (connector_->place_order(order)) {
-                // Update order tracking
-                std::unique_lock<std::shared_mutex> lock(orders_mutex_);
-                active_orders_[order.order_id] = order;
-                return true;
+    if (!send_once([&] { return connector_->place_order(order); })) {
+        return false;
+    }
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    active_orders_[order.order_id] = order;
+    return true;
+}
+
+bool BitMEXExecutionManager::cancel_order(int64_t order_id) {
+    return cancel_orders(&order_id, 1);
+}
+
+bool BitMEXExecutionManager::amend_order(const Order& order) {
+    return amend_orders(&order, 1);
+}
+
+template <class Send>
+bool BitMEXExecutionManager::send_once(Send&& send) {
+    try {
+        return send();
+    }
+    catch (const std::exception& e) {
+        // Thrown while building the request, before anything was sent
+        return false;
+    }
+}
+
+bool BitMEXExecutionManager::submit_orders(Order* orders, size_t count) {
+    accepted_.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (check_risk_limits(orders[i])) {
+            accepted_.push_back(orders[i]);
+        } else {
+            orders[i].status = OrderStatus::REJECTED;
+        }
+    }
+    if (accepted_.empty()) {
+        return false;
+    }
+    
+    if (!send_once([&] { return connector_->place_orders(accepted_.data(), accepted_.size()); })) {
+        return false;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    for (const auto& order : accepted_) {
+        active_orders_[order.order_id] = order;
+    }
+    return true;
+}
+
+bool BitMEXExecutionManager::cancel_orders(const int64_t* order_ids, size_t count) {
+    if (!send_once([&] { return connector_->cancel_orders(order_ids, count); })) {
+        return false;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        active_orders_.erase(order_ids[i]);
+    }
+    return true;
+}
+
+bool BitMEXExecutionManager::amend_orders(const Order* orders, size_t count) {
+    if (!send_once([&] { return connector_->amend_orders(orders, count); })) {
+        return false;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        auto it = active_orders_.find(orders[i].order_id);
+        if (it != active_orders_.end()) {
+            it->second.price = orders[i].price;
+            it->second.quantity = orders[i].quantity;
+        }
+    }
+    return true;
+}
+
+bool BitMEXExecutionManager::execute(OrderBatch& batch) {
+    // Cancels first so the margin they free is there for the places
+    bool ok = cancel_orders(batch.cancels.data(), batch.cancels.size()) &&
+              amend_orders(batch.amends.data(), batch.amends.size());
+    if (ok && !batch.places.empty()) {
+        ok = submit_orders(batch.places.data(), batch.places.size());
+    }
+    return ok;
+}
+
+void BitMEXExecutionManager::submit_order_async(const Order& order, SubmitCallback on_done) {
+    if (!check_risk_limits(order)) {
+        Order rejected = order;
+        rejected.status = OrderStatus::REJECTED;
+        on_done(rejected, false);
+        return;
+    }
+    attempt_submission(PendingSubmit{order, 0, false, std::move(on_done)});
+}
+
+std::future<bool> BitMEXExecutionManager::submit_order_async(const Order& order) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+    submit_order_async(order, [promise](const Order&, bool accepted) {
+        promise->set_value(accepted);
+    });
+    return future;
+}
+
+void BitMEXExecutionManager::run_submissions() {
+    std::vector<ParkedRetry> batch;
+    auto has_work = [this] { return stopping_ || !incoming_.empty(); };
+    
+    std::unique_lock<std::mutex> lock(submit_mutex_);
+    while (true) {
+        if (retry_wheel_.empty()) {
+            submit_cv_.wait(lock, has_work);
+        } else {
+            // Straight to the earliest parked retry, not tick by tick
+            const std::chrono::steady_clock::time_point next_retry(
+                std::chrono::nanoseconds(retry_wheel_.next_deadline_ns()));
+            submit_cv_.wait_until(lock, next_retry, has_work);
+        }
+        if (stopping_) {
+            break;
+        }
+        batch.swap(incoming_);
+        lock.unlock();
+        
+        for (auto& parked : batch) {
+            if (retry_wheel_.full()) {
+                finish_submission(std::move(parked.pending), false);
+            } else {
+                retry_wheel_.schedule(parked.deadline_ns, std::move(parked.pending));
             }
         }
-        catch (const std::exception& e) {
-            // Log error and retry
-            attempts++;
-            if (attempts < config_.max_retry_attempts) {
-                std::this_thread::sleep_for(config_.retry_delay);
+        batch.clear();
+        retry_wheel_.advance(steady_now_ns(), [this](PendingSubmit&& pending) {
+            attempt_submission(std::move(pending));
+        });
+        
+        lock.lock();
+    }
+    
+    // Shutting down: whatever is still parked is reported failed
+    batch.swap(incoming_);
+    lock.unlock();
+    for (auto& parked : batch) {
+        finish_submission(std::move(parked.pending), false);
+    }
+    retry_wheel_.advance(std::numeric_limits<int64_t>::max(), [this](PendingSubmit&& pending) {
+        finish_submission(std::move(pending), false);
+    });
+}
+
+void BitMEXExecutionManager::attempt_submission(PendingSubmit&& pending) {
+    ++pending.attempts;
+    if (!pending.in_doubt) {
+        place_submission(std::move(pending));
+        return;
+    }
+    
+    // The last place may have gone through; never place it twice
+    const int64_t order_id = pending.order.order_id;
+    begin_request();
+    connector_->has_order_async(order_id,
+        [this, pending = std::move(pending)](std::optional<bool> found) mutable {
+            if (!found) {
+                retry_submission(std::move(pending));
+            } else if (*found) {
+                finish_submission(std::move(pending), true);
+            } else {
+                pending.in_doubt = false;
+                place_submission(std::move(pending));
             }
-            continue;
+            end_request();
+        });
+}
+
+void BitMEXExecutionManager::place_submission(PendingSubmit&& pending) {
+    const Order order = pending.order;
+    begin_request();
+    connector_->place_order_async(order,
+        [this, pending = std::move(pending)](const BitMEXRestClient::Response& reply) mutable {
+            if (reply.ok()) {
+                finish_submission(std::move(pending), true);
+            } else if (reply.retry_safe()) {
+                retry_submission(std::move(pending));
+            } else if (reply.status >= 400 && reply.status < 500) {
+                finish_submission(std::move(pending), false);
+            } else {
+                pending.in_doubt = true;
+                retry_submission(std::move(pending));
+            }
+            end_request();
+        });
+}
+
+void BitMEXExecutionManager::retry_submission(PendingSubmit&& pending) {
+    if (pending.attempts < config_.max_retry_attempts) {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        if (!stopping_) {
+            const double unit = std::uniform_real_distribution<double>(0.0, 1.0)(jitter_rng_);
+            const int64_t deadline =
+                steady_now_ns() + config_.retry_backoff(pending.attempts, unit).count();
+            incoming_.push_back(ParkedRetry{deadline, std::move(pending)});
+            submit_cv_.notify_one();
+            return;
         }
     }
-    return false;
+    finish_submission(std::move(pending), false);
+}
+
+void BitMEXExecutionManager::finish_submission(PendingSubmit&& pending, bool accepted) {
+    if (accepted) {
+        std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+        active_orders_[pending.order.order_id] = pending.order;
+    }
+    pending.on_done(pending.order, accepted);
+}
+
+void BitMEXExecutionManager::begin_request() {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    ++requests_in_flight_;
+}
+
+void BitMEXExecutionManager::end_request() {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    if (--requests_in_flight_ == 0) {
+        idle_cv_.notify_all();
+    }
+}
+
+std::optional<Order> BitMEXExecutionManager::get_order_status(int64_t order_id) {
+    std::shared_lock<std::shared_mutex> lock(orders_mutex_);
+    auto it = active_orders_.find(order_id);
+    if (it == active_orders_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<Order> BitMEXExecutionManager::get_active_orders() {
+    std::shared_lock<std::shared_mutex> lock(orders_mutex_);
+    std::vector<Order> orders;
+    orders.reserve(active_orders_.size());
+    for (const auto& [order_id, order] : active_orders_) {
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+void BitMEXExecutionManager::update_order_status(const Order& order) {
+    std::unique_lock<std::shared_mutex> lock(orders_mutex_);
+    auto it = active_orders_.find(order.order_id);
+    if (it == active_orders_.end()) {
+        return;
+    }
+    if (order.status == OrderStatus::FILLED ||
+        order.status == OrderStatus::CANCELLED ||
+        order.status == OrderStatus::REJECTED) {
+        active_orders_.erase(it);
+        return;
+    }
+    it->second.status = order.status;
+    it->second.filled_quantity = order.filled_quantity;
+    it->second.last_update_time = order.last_update_time;
 }
 
 bool BitMEXExecutionManager::check_risk_limits(const Order& order) {
     return validate_order_size(order) &&
-           validate_position_value(order) &&
-           validate_leverage(order);
+           validate_position_value(order);
 }
 
 bool BitMEXExecutionManager::validate_order_size(const Order& order) {
@@ -45,8 +326,7 @@ bool BitMEXExecutionManager::validate_order_size(const Order& order) {
 }
 
 bool BitMEXExecutionManager::validate_position_value(const Order& order) {
-    // Get current position from BitMEX
-    double current_position = connector_->get_current_position();
+    double current_position = order_manager_->get_position();
     double new_position = current_position;
     
     if (order.side == OrderSide::BUY) {
@@ -58,8 +338,3 @@ bool BitMEXExecutionManager::validate_position_value(const Order& order) {
     double position_value = std::abs(new_position * order.price);
     return position_value <= config_.max_position_value;
 }
-
-bool BitMEXExecutionManager::validate_leverage(const Order& order) {
-    double leverage = get_current_leverage();
-    return leverage <= config_.max_leverage;
-} 
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "bitmex_frame_parser.h"
+#include <charconv>
+
+namespace bitmex_frame {
+namespace detail {
+
+bool Cursor::string(std::string_view& out) {
+    skip_ws();
+    if (end_ - p_ >= 4 && std::string_view(p_, 4) == "null") {
+        p_ += 4;
+        out = {};
+        return true;
+    }
+    if (p_ == end_ || *p_ != '"') {
+        return false;
+    }
+    const char* start = ++p_;
+    while (p_ < end_ && *p_ != '"') {
+        if (*p_ == '\\') {
+            // An escape needs its second byte; a frame cut after the
+            // backslash is malformed rather than a step past the end
+            if (end_ - p_ < 2) {
+                return false;
+            }
+            p_ += 2;
+        } else {
+            ++p_;
+        }
+    }
+    if (p_ == end_) {
+        return false;
+    }
+    out = std::string_view(start, static_cast<size_t>(p_ - start));
+    ++p_;
+    return true;
+}
+
+bool Cursor::number(double& out) {
+    skip_ws();
+    auto [ptr, ec] = std::from_chars(p_, end_, out);
+    if (ec != std::errc()) {
+        return false;
+    }
+    p_ = ptr;
+    return true;
+}
+
+bool Cursor::integer(int64_t& out) {
+    skip_ws();
+    const char* start = p_;
+    auto [ptr, ec] = std::from_chars(p_, end_, out);
+    if (ec != std::errc()) {
+        return false;
+    }
+    p_ = ptr;
+    // Tolerate integral values written with a fraction or exponent
+    if (p_ != end_ && (*p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+        double value;
+        p_ = start;
+        if (!number(value)) {
+            return false;
+        }
+        out = static_cast<int64_t>(value);
+    }
+    return true;
+}
+
+bool Cursor::null() {
+    skip_ws();
+    if (end_ - p_ >= 4 && std::string_view(p_, 4) == "null") {
+        p_ += 4;
+        return true;
+    }
+    return false;
+}
+
+bool Cursor::number_or_null(double& out) {
+    if (null()) {
+        out = 0.0;
+        return true;
+    }
+    return number(out);
+}
+
+bool Cursor::skip_value() {
+    skip_ws();
+    if (p_ == end_) {
+        return false;
+    }
+    if (*p_ == '"') {
+        std::string_view ignored;
+        return string(ignored);
+    }
+    if (*p_ == '{' || *p_ == '[') {
+        // Bracket depth only; strings are skipped so their contents cannot
+        // unbalance the count
+        int depth = 0;
+        while (p_ != end_) {
+            const char c = *p_;
+            if (c == '"') {
+                std::string_view ignored;
+                if (!string(ignored)) {
+                    return false;
+                }
+                continue;
+            }
+            ++p_;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    // Number or literal
+    const char* start = p_;
+    while (p_ != end_ && *p_ != ',' && *p_ != '}' && *p_ != ']' &&
+           *p_ != ' ' && *p_ != '\n' && *p_ != '\r' && *p_ != '\t') {
+        ++p_;
+    }
+    return p_ != start;
+}
+
+bool Cursor::value_span(std::string_view& out) {
+    skip_ws();
+    const char* start = p_;
+    if (!skip_value()) {
+        return false;
+    }
+    out = std::string_view(start, static_cast<size_t>(p_ - start));
+    return true;
+}
+
+}  // namespace detail
+
+bool parse_frame(std::string_view text, Frame& frame) {
+    frame = Frame{};
+    detail::Cursor cursor(text);
+
+    std::string_view action;
+    const bool ok = detail::for_each_member(cursor, [&](std::string_view key, detail::Cursor& v) {
+        if (key == "table") return v.string(frame.table_name);
+        if (key == "action") return v.string(action);
+        if (key == "data") return v.value_span(frame.data);
+        return v.skip_value();
+    });
+    if (!ok) {
+        return false;
+    }
+
+    if (frame.table_name == "orderBookL2") {
+        frame.table = Table::ORDER_BOOK_L2;
+    } else if (frame.table_name == "execution") {
+        frame.table = Table::EXECUTION;
+    } else if (frame.table_name == "trade") {
+        frame.table = Table::TRADE;
+    } else if (!frame.table_name.empty()) {
+        frame.table = Table::OTHER;
+    }
+
+    if (action == "partial") {
+        frame.action = L2OrderBook::Action::PARTIAL;
+    } else if (action == "insert") {
+        frame.action = L2OrderBook::Action::INSERT;
+    } else if (action == "delete") {
+        frame.action = L2OrderBook::Action::DELETE;
+    } else {
+        frame.action = L2OrderBook::Action::UPDATE;
+    }
+    return true;
+}
+
+bool parse_l2(std::string_view data, const L2OrderBook& book,
+              std::vector<L2OrderBook::Entry>& out) {
+    detail::Cursor cursor(data);
+    return detail::for_each_element(cursor, [&](detail::Cursor& c) {
+        int64_t id = 0;
+        BookSide side = BookSide::BID;
+        double price = 0.0;
+        double size = 0.0;
+        const bool ok = detail::for_each_member(c, [&](std::string_view key, detail::Cursor& v) {
+            if (key == "id") return v.integer(id);
+            if (key == "price") return v.number_or_null(price);
+            if (key == "size") return v.number_or_null(size);
+            if (key == "side") {
+                std::string_view s;
+                if (!v.string(s)) return false;
+                side = s == "Buy" ? BookSide::BID : BookSide::ASK;
+                return true;
+            }
+            return v.skip_value();
+        });
+        if (ok) {
+            out.push_back(book.make_entry(id, side, price, size));
+        }
+        return ok;
+    });
+}
+
+}  // namespace bitmex_frame
@@ -0,0 +1,285 @@
+#include "bitmex_rest_client.h"
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <strings.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+namespace bitmex_auth {
+
+namespace {
+
+constexpr size_t SHA256_BLOCK = 64;
+
+void write_hex(const unsigned char* digest, size_t size, char* out) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    for (size_t i = 0; i < size; ++i) {
+        out[2 * i] = HEX[digest[i] >> 4];
+        out[2 * i + 1] = HEX[digest[i] & 0xf];
+    }
+}
+
+}  // namespace
+
+std::string sign(std::string_view secret, std::string_view verb,
+                 std::string_view path, int64_t expires, std::string_view body) {
+    std::string message;
+    message.reserve(verb.size() + path.size() + 20 + body.size());
+    message.append(verb).append(path).append(std::to_string(expires)).append(body);
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len = 0;
+    HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+         reinterpret_cast<const unsigned char*>(message.data()), message.size(),
+         digest, &digest_len);
+
+    std::string hex(digest_len * 2, '0');
+    write_hex(digest, digest_len, hex.data());
+    return hex;
+}
+
+PrefixSigner::PrefixSigner(std::string_view secret, std::string_view verb, std::string_view path)
+    : verb_(verb)
+    , path_(path)
+    , inner_(EVP_MD_CTX_new())
+    , outer_(EVP_MD_CTX_new())
+    , scratch_(EVP_MD_CTX_new()) {
+    if (inner_ == nullptr || outer_ == nullptr || scratch_ == nullptr) {
+        EVP_MD_CTX_free(inner_);
+        EVP_MD_CTX_free(outer_);
+        EVP_MD_CTX_free(scratch_);
+        throw std::runtime_error("Failed to create digest context");
+    }
+
+    // HMAC (RFC 2104) by hand so the keyed states can be kept and copied
+    unsigned char key[SHA256_BLOCK]{};
+    if (secret.size() > SHA256_BLOCK) {
+        unsigned int key_len = 0;
+        EVP_Digest(secret.data(), secret.size(), key, &key_len, EVP_sha256(), nullptr);
+    } else {
+        std::memcpy(key, secret.data(), secret.size());
+    }
+    unsigned char pad[SHA256_BLOCK];
+    for (size_t i = 0; i < SHA256_BLOCK; ++i) {
+        pad[i] = key[i] ^ 0x36;
+    }
+    EVP_DigestInit_ex(inner_, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(inner_, pad, SHA256_BLOCK);
+    EVP_DigestUpdate(inner_, verb.data(), verb.size());
+    EVP_DigestUpdate(inner_, path.data(), path.size());
+    for (size_t i = 0; i < SHA256_BLOCK; ++i) {
+        pad[i] = key[i] ^ 0x5c;
+    }
+    EVP_DigestInit_ex(outer_, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(outer_, pad, SHA256_BLOCK);
+}
+
+PrefixSigner::~PrefixSigner() {
+    EVP_MD_CTX_free(inner_);
+    EVP_MD_CTX_free(outer_);
+    EVP_MD_CTX_free(scratch_);
+}
+
+void PrefixSigner::sign(int64_t expires, std::string_view body, char* out) {
+    char digits[20];
+    const auto end = std::to_chars(digits, digits + sizeof(digits), expires).ptr;
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len = 0;
+    EVP_MD_CTX_copy_ex(scratch_, inner_);
+    EVP_DigestUpdate(scratch_, digits, static_cast<size_t>(end - digits));
+    EVP_DigestUpdate(scratch_, body.data(), body.size());
+    EVP_DigestFinal_ex(scratch_, digest, &digest_len);
+
+    EVP_MD_CTX_copy_ex(scratch_, outer_);
+    EVP_DigestUpdate(scratch_, digest, digest_len);
+    EVP_DigestFinal_ex(scratch_, digest, &digest_len);
+    write_hex(digest, digest_len, out);
+}
+
+}  // namespace bitmex_auth
+
+BitMEXRestClient::BitMEXRestClient(Config config) : config_(std::move(config)) {
+    static std::once_flag curl_init;
+    std::call_once(curl_init, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+    // Split base_url so the path prefix can be included in signatures
+    const size_t scheme = config_.base_url.find("://");
+    const size_t path_start = config_.base_url.find('/', scheme == std::string::npos ? 0 : scheme + 3);
+    origin_ = config_.base_url.substr(0, path_start);
+    base_path_ = path_start == std::string::npos ? "" : config_.base_url.substr(path_start);
+    while (!base_path_.empty() && base_path_.back() == '/') {
+        base_path_.pop_back();
+    }
+
+    curl_ = curl_easy_init();
+    if (curl_ == nullptr) {
+        throw std::runtime_error("Failed to create libcurl handle");
+    }
+
+    curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl_, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl_, CURLOPT_TIMEOUT, static_cast<long>(config_.timeout));
+    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, &BitMEXRestClient::write_body);
+    curl_easy_setopt(curl_, CURLOPT_HEADERFUNCTION, &BitMEXRestClient::read_header);
+}
+
+BitMEXRestClient::~BitMEXRestClient() {
+    if (curl_ != nullptr) {
+        curl_easy_cleanup(curl_);
+    }
+}
+
+BitMEXRestClient::Response BitMEXRestClient::get(std::string_view endpoint, std::string_view query) {
+    return request("GET", endpoint, query, {});
+}
+
+BitMEXRestClient::Response BitMEXRestClient::post(std::string_view endpoint, std::string_view body) {
+    return request("POST", endpoint, {}, body);
+}
+
+BitMEXRestClient::Response BitMEXRestClient::put(std::string_view endpoint, std::string_view body) {
+    return request("PUT", endpoint, {}, body);
+}
+
+BitMEXRestClient::Response BitMEXRestClient::del(std::string_view endpoint, std::string_view body) {
+    return request("DELETE", endpoint, {}, body);
+}
+
+BitMEXRestClient::Response BitMEXRestClient::request(
+    std::string_view verb,
+    std::string_view endpoint,
+    std::string_view query,
+    std::string_view body) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Response response;
+
+    path_.assign(base_path_).append(endpoint);
+    if (!query.empty()) {
+        path_.append("?").append(query);
+    }
+    url_.assign(origin_).append(path_);
+
+    const int64_t expires = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count() + config_.expires_window;
+    const std::string verb_str(verb);
+
+    curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+    headers = curl_slist_append(headers, "Accept: application/json");
+    headers = curl_slist_append(headers, "Connection: Keep-Alive");
+    // Send bodies straight away instead of waiting on 100-continue
+    headers = curl_slist_append(headers, "Expect:");
+    if (!config_.api_key.empty()) {
+        static constexpr std::string_view SIGNATURE_HEADER = "api-signature: ";
+        char signature[SIGNATURE_HEADER.size() + bitmex_auth::PrefixSigner::SIGNATURE_SIZE + 1];
+        std::memcpy(signature, SIGNATURE_HEADER.data(), SIGNATURE_HEADER.size());
+        char* hex = signature + SIGNATURE_HEADER.size();
+        if (auto* signer = query.empty() ? signer_for(verb) : nullptr) {
+            signer->sign(expires, body, hex);
+        } else {
+            const std::string digest = bitmex_auth::sign(config_.api_secret, verb, path_, expires, body);
+            std::memcpy(hex, digest.data(), bitmex_auth::PrefixSigner::SIGNATURE_SIZE);
+        }
+        signature[sizeof(signature) - 1] = '\0';
+        headers = curl_slist_append(headers, ("api-expires: " + std::to_string(expires)).c_str());
+        headers = curl_slist_append(headers, ("api-key: " + config_.api_key).c_str());
+        headers = curl_slist_append(headers, signature);
+    }
+
+    curl_easy_setopt(curl_, CURLOPT_URL, url_.c_str());
+    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &response);
+
+    // GET resets the method; anything else sends the body, with
+    // CUSTOMREQUEST overriding POST for PUT and DELETE
+    curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, nullptr);
+    if (verb != "GET") {
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body.empty() ? "" : body.data());
+        if (verb != "POST") {
+            curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, verb_str.c_str());
+        }
+    }
+
+    const CURLcode code = curl_easy_perform(curl_);
+    if (code == CURLE_OK) {
+        curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &response.status);
+    } else {
+        response.error = curl_easy_strerror(code);
+        // No connection, so nothing was written
+        response.unsent = code == CURLE_COULDNT_RESOLVE_HOST ||
+                          code == CURLE_COULDNT_RESOLVE_PROXY ||
+                          code == CURLE_COULDNT_CONNECT;
+    }
+
+    // Do not leave pointers to this call's buffers on the handle
+    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, nullptr);
+    curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, nullptr);
+    curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, nullptr);
+    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, nullptr);
+    curl_slist_free_all(headers);
+
+    return response;
+}
+
+bitmex_auth::PrefixSigner* BitMEXRestClient::signer_for(std::string_view verb) {
+    for (const auto& signer : signers_) {
+        if (signer->matches(verb, path_)) {
+            return signer.get();
+        }
+    }
+    if (signers_.size() >= MAX_SIGNERS) {
+        return nullptr;
+    }
+    signers_.push_back(std::make_unique<bitmex_auth::PrefixSigner>(config_.api_secret, verb, path_));
+    return signers_.back().get();
+}
+
+size_t BitMEXRestClient::write_body(char* data, size_t size, size_t count, void* user) {
+    static_cast<std::string*>(user)->append(data, size * count);
+    return size * count;
+}
+
+size_t BitMEXRestClient::read_header(char* data, size_t size, size_t count, void* user) {
+    // Called once per header line; only the integer rate-limit fields are kept
+    auto* response = static_cast<Response*>(user);
+    const size_t length = size * count;
+    const std::string_view line(data, length);
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) {
+        return length;
+    }
+
+    int64_t* field = nullptr;
+    const std::string_view name = line.substr(0, colon);
+    auto is = [&](std::string_view expected) {
+        return name.size() == expected.size() &&
+               ::strncasecmp(name.data(), expected.data(), name.size()) == 0;
+    };
+    if (is("x-ratelimit-remaining")) {
+        field = &response->ratelimit_remaining;
+    } else if (is("x-ratelimit-remaining-1s")) {
+        field = &response->ratelimit_remaining_1s;
+    } else if (is("x-ratelimit-reset")) {
+        field = &response->ratelimit_reset;
+    } else if (is("retry-after")) {
+        field = &response->retry_after;
+    } else {
+        return length;
+    }
+
+    size_t start = colon + 1;
+    while (start < length && line[start] == ' ') {
+        ++start;
+    }
+    std::from_chars(line.data() + start, line.data() + length, *field);
+    return length;
+}
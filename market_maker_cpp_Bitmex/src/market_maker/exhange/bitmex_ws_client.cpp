@@ -0,0 +1,318 @@
+#include "bitmex_ws_client.h"
+#include "bitmex_rest_client.h"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = net::ssl;
+using tcp = net::ip::tcp;
+
+namespace {
+
+struct Endpoint {
+    bool tls{false};
+    std::string host;
+    std::string port;
+    std::string target;
+};
+
+Endpoint parse_url(const std::string& url) {
+    Endpoint endpoint;
+    const size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        throw std::runtime_error("WebSocket URL has no scheme: " + url);
+    }
+    const std::string scheme = url.substr(0, scheme_end);
+    endpoint.tls = scheme == "wss" || scheme == "https";
+
+    const size_t host_start = scheme_end + 3;
+    const size_t path_start = url.find('/', host_start);
+    std::string authority = url.substr(host_start, path_start - host_start);
+    endpoint.target = path_start == std::string::npos ? "/" : url.substr(path_start);
+
+    const size_t colon = authority.find(':');
+    if (colon != std::string::npos) {
+        endpoint.host = authority.substr(0, colon);
+        endpoint.port = authority.substr(colon + 1);
+    } else {
+        endpoint.host = authority;
+        endpoint.port = endpoint.tls ? "443" : "80";
+    }
+    return endpoint;
+}
+
+}  // namespace
+
+struct BitMEXWebSocketClient::Impl {
+    using PlainStream = websocket::stream<beast::tcp_stream>;
+    using SecureStream = websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+
+    Impl(Config cfg, MessageHandler on_message, std::atomic<bool>& connected_flag)
+        : config(std::move(cfg))
+        , handler(std::move(on_message))
+        , connected(connected_flag)
+        , endpoint(parse_url(config.url))
+        , subscriptions(config.subscriptions) {
+        ssl_ctx.set_default_verify_paths();
+        if (!config.ca_pem.empty()) {
+            ssl_ctx.add_certificate_authority(net::buffer(config.ca_pem));
+        }
+        ssl_ctx.set_verify_mode(ssl::verify_peer);
+    }
+
+    Config config;
+    MessageHandler handler;
+    std::atomic<bool>& connected;
+    Endpoint endpoint;
+
+    net::io_context ioc;
+    net::executor_work_guard<net::io_context::executor_type> work{ioc.get_executor()};
+    ssl::context ssl_ctx{ssl::context::tls_client};
+    tcp::resolver resolver{ioc};
+    net::steady_timer reconnect_timer{ioc};
+    std::thread thread;
+
+    // Everything below is touched only on the I/O thread
+    std::optional<PlainStream> plain;
+    std::optional<SecureStream> secure;
+    beast::flat_buffer buffer;
+    std::deque<std::string> outbox;
+    bool writing{false};
+    bool stopping{false};
+    uint64_t session{0};  // Bumped on every teardown; stale handlers bail out
+    std::vector<std::string> subscriptions;
+
+    template <class F>
+    void with_stream(F&& fn) {
+        if (secure) {
+            fn(*secure);
+        } else if (plain) {
+            fn(*plain);
+        }
+    }
+
+    void connect() {
+        if (stopping) {
+            return;
+        }
+        const uint64_t id = ++session;
+        resolver.async_resolve(endpoint.host, endpoint.port,
+            [this, id](beast::error_code ec, tcp::resolver::results_type results) {
+                if (id != session) return;
+                if (ec) return fail();
+                on_resolve(id, results);
+            });
+    }
+
+    void on_resolve(uint64_t id, const tcp::resolver::results_type& results) {
+        plain.reset();
+        secure.reset();
+        buffer.clear();
+        outbox.clear();
+        writing = false;
+
+        if (endpoint.tls) {
+            secure.emplace(ioc, ssl_ctx);
+            SSL_set_tlsext_host_name(secure->next_layer().native_handle(), endpoint.host.c_str());
+            // A valid chain alone would accept any site's certificate
+            secure->next_layer().set_verify_callback(ssl::host_name_verification(endpoint.host));
+        } else {
+            plain.emplace(ioc);
+        }
+
+        with_stream([&](auto& ws) {
+            beast::get_lowest_layer(ws).expires_after(std::chrono::seconds(30));
+            beast::get_lowest_layer(ws).async_connect(results,
+                [this, id](beast::error_code ec, const tcp::endpoint&) {
+                    if (id != session) return;
+                    if (ec) return fail();
+                    if (secure) {
+                        secure->next_layer().async_handshake(ssl::stream_base::client,
+                            [this, id](beast::error_code ec) {
+                                if (id != session) return;
+                                if (ec) return fail();
+                                handshake(id);
+                            });
+                    } else {
+                        handshake(id);
+                    }
+                });
+        });
+    }
+
+    void handshake(uint64_t id) {
+        with_stream([&](auto& ws) {
+            beast::get_lowest_layer(ws).expires_never();
+            // suggested() for a client turns idle detection off altogether
+            websocket::stream_base::timeout timeout{};
+            timeout.handshake_timeout = std::chrono::seconds(30);
+            timeout.idle_timeout = config.idle_timeout;
+            timeout.keep_alive_pings = true;
+            ws.set_option(timeout);
+            ws.async_handshake(endpoint.host, endpoint.target,
+                [this, id](beast::error_code ec) {
+                    if (id != session) return;
+                    if (ec) return fail();
+                    connected.store(true, std::memory_order_release);
+                    authenticate();
+                    send_subscribe(subscriptions);
+                    read(id);
+                });
+        });
+    }
+
+    void authenticate() {
+        if (config.api_key.empty()) {
+            return;
+        }
+        const int64_t expires = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count() + config.expires_window;
+        const std::string signature =
+            bitmex_auth::sign(config.api_secret, "GET", "/realtime", expires, "");
+        send(R"({"op":"authKeyExpires","args":[")" + config.api_key + "\"," +
+             std::to_string(expires) + ",\"" + signature + "\"]}");
+    }
+
+    void send_subscribe(const std::vector<std::string>& topics) {
+        if (topics.empty()) {
+            return;
+        }
+        std::string message = R"({"op":"subscribe","args":[)";
+        for (size_t i = 0; i < topics.size(); ++i) {
+            message += (i ? ",\"" : "\"") + topics[i] + "\"";
+        }
+        message += "]}";
+        send(std::move(message));
+    }
+
+    void read(uint64_t id) {
+        with_stream([&](auto& ws) {
+            ws.async_read(buffer, [this, id](beast::error_code ec, size_t) {
+                if (id != session) return;
+                if (ec) return fail();
+
+                const auto data = buffer.cdata();
+                try {
+                    handler(std::string_view(static_cast<const char*>(data.data()), data.size()));
+                }
+                catch (const std::exception& e) {
+                    // Whatever the handler was building from this stream is
+                    // suspect now; start over from fresh partials
+                    if (config.on_error) {
+                        config.on_error(e.what());
+                    }
+                    return fail();
+                }
+                buffer.consume(buffer.size());
+                read(id);
+            });
+        });
+    }
+
+    void send(std::string message) {
+        outbox.push_back(std::move(message));
+        if (!writing) {
+            write(session);
+        }
+    }
+
+    void write(uint64_t id) {
+        writing = true;
+        with_stream([&](auto& ws) {
+            ws.text(true);
+            ws.async_write(net::buffer(outbox.front()), [this, id](beast::error_code ec, size_t) {
+                if (id != session) return;
+                if (ec) return fail();
+                outbox.pop_front();
+                if (outbox.empty()) {
+                    writing = false;
+                } else {
+                    write(id);
+                }
+            });
+        });
+    }
+
+    // Drops the session; pending handlers see a new session id and return
+    void teardown() {
+        ++session;
+        connected.store(false, std::memory_order_release);
+        resolver.cancel();
+        with_stream([](auto& ws) {
+            beast::error_code ignored;
+            beast::get_lowest_layer(ws).socket().close(ignored);
+        });
+    }
+
+    void fail() {
+        teardown();
+        if (stopping) {
+            return;
+        }
+        reconnect_timer.expires_after(config.reconnect_delay);
+        reconnect_timer.async_wait([this](beast::error_code ec) {
+            if (!ec) {
+                connect();
+            }
+        });
+    }
+};
+
+BitMEXWebSocketClient::BitMEXWebSocketClient(Config config, MessageHandler handler)
+    : impl_(std::make_unique<Impl>(std::move(config), std::move(handler), connected_)) {}
+
+BitMEXWebSocketClient::~BitMEXWebSocketClient() {
+    stop();
+}
+
+void BitMEXWebSocketClient::start() {
+    if (impl_->thread.joinable()) {
+        return;
+    }
+    net::post(impl_->ioc, [impl = impl_.get()] { impl->connect(); });
+    impl_->thread = std::thread([impl = impl_.get()] { impl->ioc.run(); });
+}
+
+void BitMEXWebSocketClient::stop() {
+    if (!impl_->thread.joinable()) {
+        return;
+    }
+    net::post(impl_->ioc, [impl = impl_.get()] {
+        impl->stopping = true;
+        impl->reconnect_timer.cancel();
+        impl->teardown();
+        impl->work.reset();
+        impl->ioc.stop();
+    });
+    impl_->thread.join();
+}
+
+void BitMEXWebSocketClient::subscribe(const std::vector<std::string>& topics) {
+    net::post(impl_->ioc, [impl = impl_.get(), topics] {
+        impl->subscriptions.insert(impl->subscriptions.end(), topics.begin(), topics.end());
+        if (impl->connected.load(std::memory_order_acquire)) {
+            impl->send_subscribe(topics);
+        }
+    });
+}
+
+std::string BitMEXWebSocketClient::realtime_url(const std::string& rest_base_url) {
+    const Endpoint endpoint = parse_url(rest_base_url);
+    std::string url = endpoint.tls ? "wss://" : "ws://";
+    url += endpoint.host;
+    if (endpoint.port != (endpoint.tls ? "443" : "80")) {
+        url += ":" + endpoint.port;
+    }
+    return url + "/realtime";
+}
@@ -0,0 +1,203 @@
+#include "kill_switch.h"
+#include <algorithm>
+#include <stdexcept>
+
+KillSwitch::KillSwitch(std::shared_ptr<BitMEXConnector> connector)
+    : KillSwitch(std::move(connector), Config{}) {}
+
+KillSwitch::KillSwitch(std::shared_ptr<BitMEXConnector> connector, Config config)
+    : connector_(std::move(connector))
+    , config_(config) {
+    if (config_.heartbeat_interval.count() <= 0 ||
+        config_.dead_man_timeout <= config_.heartbeat_interval) {
+        throw std::runtime_error("Kill switch dead_man_timeout must exceed a positive heartbeat_interval");
+    }
+}
+
+KillSwitch::~KillSwitch() {
+    stop();
+}
+
+void KillSwitch::attach(std::shared_ptr<OrderManager> order_manager) {
+    std::lock_guard<std::mutex> lock(attached_mutex_);
+    order_managers_.push_back(std::move(order_manager));
+}
+
+void KillSwitch::detach(const std::shared_ptr<OrderManager>& order_manager) {
+    std::lock_guard<std::mutex> lock(attached_mutex_);
+    auto it = std::find(order_managers_.begin(), order_managers_.end(), order_manager);
+    if (it != order_managers_.end()) {
+        order_managers_.erase(it);
+    }
+}
+
+void KillSwitch::attach(std::shared_ptr<BitMEXConnector> connector) {
+    if (connector == connector_) {
+        return;
+    }
+    connector->halt_new_orders(tripped());
+    std::lock_guard<std::mutex> lock(attached_mutex_);
+    connectors_.push_back(std::move(connector));
+}
+
+KillSwitch::ListenerId KillSwitch::add_cancel_listener(std::function<void()> listener) {
+    std::lock_guard<std::mutex> lock(attached_mutex_);
+    const ListenerId id = next_listener_++;
+    cancel_listeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void KillSwitch::remove_cancel_listener(ListenerId id) {
+    std::lock_guard<std::mutex> lock(attached_mutex_);
+    cancel_listeners_.erase(std::remove_if(cancel_listeners_.begin(), cancel_listeners_.end(),
+        [id](const auto& entry) { return entry.first == id; }), cancel_listeners_.end());
+}
+
+void KillSwitch::acquire() {
+    // Held across start()/stop() so a release and an acquire cannot cross
+    std::lock_guard<std::mutex> lock(users_mutex_);
+    if (users_++ == 0) {
+        start();
+    }
+}
+
+void KillSwitch::release() {
+    std::lock_guard<std::mutex> lock(users_mutex_);
+    if (users_ > 0 && --users_ == 0) {
+        stop();
+    }
+}
+
+void KillSwitch::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread([this] { run(); });
+}
+
+void KillSwitch::stop() {
+    bool cancel_pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    thread_.join();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancel_pending = cancel_pending_;
+    }
+
+    // A trip the thread did not get to still cancels; a clean shutdown is
+    // not a hang, so the dead man's switch is disarmed
+    if (cancel_pending && connector_->cancel_all_orders()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cancel_pending_ = false;
+        }
+        cancelled_all();
+    }
+    connector_->cancel_all_after(std::chrono::milliseconds(0));
+}
+
+void KillSwitch::trip(const std::string& reason) {
+    // Stop new quotes before anything else; the cancel follows on our thread
+    halt_new_orders(true);
+    tripped_.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancel_pending_ = true;
+        reason_ = reason;
+    }
+    cv_.notify_all();
+}
+
+void KillSwitch::reset() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancel_pending_ = false;
+        ++generation_;
+        reason_.clear();
+    }
+    tripped_.store(false, std::memory_order_release);
+    halt_new_orders(false);
+}
+
+void KillSwitch::halt_new_orders(bool halted) {
+    connector_->halt_new_orders(halted);
+    std::lock_guard<std::mutex> lock(attached_mutex_);
+    for (const auto& connector : connectors_) {
+        connector->halt_new_orders(halted);
+    }
+}
+
+void KillSwitch::cancelled_all() {
+    std::lock_guard<std::mutex> lock(attached_mutex_);
+    for (const auto& order_manager : order_managers_) {
+        order_manager->cancel_all_orders();
+    }
+    for (const auto& [id, listener] : cancel_listeners_) {
+        listener();
+    }
+}
+
+std::string KillSwitch::reason() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reason_;
+}
+
+void KillSwitch::run() {
+    using clock = std::chrono::steady_clock;
+    auto next_heartbeat = clock::now();
+    auto next_cancel = clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        // Requests go out without the lock so trip() never waits on them
+        auto now = clock::now();
+        if (cancel_pending_ && now >= next_cancel) {
+            cancel_pending_ = false;
+            const uint64_t generation = generation_;
+            lock.unlock();
+            const bool cancelled = connector_->cancel_all_orders();
+            lock.lock();
+            cancel_alls_.fetch_add(1, std::memory_order_relaxed);
+            if (generation != generation_) {
+                // reset() while it was on the wire: quoting has resumed, and
+                // orders placed since may have landed after it
+            } else if (!cancelled) {
+                cancel_pending_ = true;
+                next_cancel = clock::now() + config_.retry_delay;
+            } else {
+                lock.unlock();
+                cancelled_all();
+                lock.lock();
+            }
+        }
+
+        now = clock::now();
+        if (now >= next_heartbeat) {
+            lock.unlock();
+            const bool armed = connector_->cancel_all_after(config_.dead_man_timeout);
+            lock.lock();
+            if (armed) {
+                heartbeats_.fetch_add(1, std::memory_order_relaxed);
+                next_heartbeat = clock::now() + config_.heartbeat_interval;
+            } else {
+                // The last good heartbeat still has dead_man_timeout to run
+                heartbeat_failures_.fetch_add(1, std::memory_order_relaxed);
+                next_heartbeat = clock::now() + config_.retry_delay;
+            }
+        }
+
+        const auto wake = cancel_pending_ ? std::min(next_heartbeat, next_cancel) : next_heartbeat;
+        cv_.wait_until(lock, wake, [&] {
+            return !running_ || (cancel_pending_ && clock::now() >= next_cancel);
+        });
+    }
+}
@@ -0,0 +1,97 @@
+#include "order_template.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace order_format {
+
+int decimals_for(double increment) {
+    int decimals = 0;
+    double scaled = increment;
+    while (decimals < 8 && std::abs(scaled - std::round(scaled)) > 1e-9 * std::max(1.0, scaled)) {
+        scaled *= 10.0;
+        ++decimals;
+    }
+    return decimals;
+}
+
+size_t write_decimal(double value, int decimals, int64_t scale, char* out, size_t width) {
+    const double scaled = value * static_cast<double>(scale);
+    if (!std::isfinite(scaled) || std::abs(scaled) >= 9e18) {
+        return 0;
+    }
+    int64_t units = std::llround(scaled);
+
+    char digits[24];
+    char* p = digits;
+    if (units < 0) {
+        *p++ = '-';
+        units = -units;
+    }
+    p = std::to_chars(p, digits + sizeof(digits), units / scale).ptr;
+    if (decimals > 0) {
+        *p++ = '.';
+        int64_t fraction = units % scale;
+        for (int i = decimals - 1; i >= 0; --i) {
+            p[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        p += decimals;
+    }
+
+    const size_t length = static_cast<size_t>(p - digits);
+    if (length > width) {
+        return 0;
+    }
+    std::memcpy(out, digits, length);
+    return length;
+}
+
+}  // namespace order_format
+
+OrderTemplate::OrderTemplate(std::string_view symbol, OrderSide side, bool post_only,
+                             double tick_size, double lot_size)
+    : price_decimals_(order_format::decimals_for(tick_size))
+    , qty_decimals_(order_format::decimals_for(lot_size)) {
+    for (int i = 0; i < price_decimals_; ++i) {
+        price_scale_ *= 10;
+    }
+    for (int i = 0; i < qty_decimals_; ++i) {
+        qty_scale_ *= 10;
+    }
+
+    body_.append("{\"symbol\":\"").append(symbol)
+         .append("\",\"side\":\"").append(side == OrderSide::BUY ? "Buy" : "Sell")
+         .append("\",\"ordType\":\"Limit\"");
+    if (post_only) {
+        body_.append(",\"execInst\":\"ParticipateDoNotInitiate\"");
+    }
+    // The closing quote of clOrdID moves with its length, so its slot has
+    // room for it
+    body_.append(",\"clOrdID\":\"");
+    cl_ord_id_offset_ = body_.size();
+    body_.append(CL_ORD_ID_WIDTH + 1, ' ');
+    body_.append(",\"orderQty\":");
+    qty_offset_ = body_.size();
+    body_.append(QTY_WIDTH, ' ');
+    body_.append(",\"price\":");
+    price_offset_ = body_.size();
+    body_.append(PRICE_WIDTH, ' ');
+    body_.append("}");
+}
+
+bool OrderTemplate::render(std::string_view cl_ord_id, double price, double quantity, char* out) const {
+    if (cl_ord_id.size() > CL_ORD_ID_WIDTH) {
+        return false;
+    }
+    std::memcpy(out, body_.data(), body_.size());
+
+    char* id = out + cl_ord_id_offset_;
+    std::memcpy(id, cl_ord_id.data(), cl_ord_id.size());
+    id[cl_ord_id.size()] = '"';
+
+    // Slots are blank in the template, so only the digits are written
+    return order_format::write_decimal(quantity, qty_decimals_, qty_scale_, out + qty_offset_, QTY_WIDTH) != 0 &&
+           order_format::write_decimal(price, price_decimals_, price_scale_, out + price_offset_, PRICE_WIDTH) != 0;
+}
@@ -0,0 +1,155 @@
+#include "rest_connection_pool.h"
+#include <future>
+#include <stdexcept>
+
+RestConnectionPool::RestConnectionPool(const BitMEXRestClient::Config& client, size_t connections) {
+    if (connections == 0) {
+        throw std::runtime_error("REST connection pool needs at least one connection");
+    }
+    connections_.reserve(connections);
+    for (size_t i = 0; i < connections; ++i) {
+        connections_.push_back(std::make_unique<Connection>(client));
+    }
+    for (auto& connection : connections_) {
+        connection->thread = std::thread([c = connection.get()] { run(*c); });
+    }
+}
+
+RestConnectionPool::~RestConnectionPool() {
+    stop();
+}
+
+void RestConnectionPool::submit(Lane lane, std::string_view verb, std::string_view endpoint,
+                                std::string_view query, std::string body, Completion done,
+                                int64_t order_id) {
+    Connection& connection = order_id != 0 ? connection_for(order_id) : least_loaded();
+    {
+        std::lock_guard<std::mutex> lock(connection.mutex);
+        if (!connection.stopping) {
+            connection.load.fetch_add(1, std::memory_order_relaxed);
+            if (lane == Lane::PRIORITY && order_id != 0) {
+                // The order's own queued requests go first, still in order,
+                // so the cancel never reaches the exchange before its place
+                auto& normal = connection.normal;
+                for (auto it = normal.begin(); it != normal.end();) {
+                    if (it->order_id == order_id) {
+                        connection.priority.push_back(std::move(*it));
+                        it = normal.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            auto& queue = lane == Lane::PRIORITY ? connection.priority : connection.normal;
+            queue.push_back({std::string(verb), std::string(endpoint), std::string(query),
+                             std::move(body), std::move(done), order_id});
+            connection.cv.notify_one();
+            return;
+        }
+    }
+    BitMEXRestClient::Response stopped;
+    stopped.error = "Connection pool stopped";
+    stopped.unsent = true;
+    if (done) {
+        done(stopped);
+    }
+}
+
+BitMEXRestClient::Response RestConnectionPool::request(
+    Lane lane, std::string_view verb, std::string_view endpoint,
+    std::string_view query, std::string_view body, int64_t order_id) {
+    std::promise<BitMEXRestClient::Response> promise;
+    auto result = promise.get_future();
+    submit(lane, verb, endpoint, query, std::string(body),
+           [&promise](const BitMEXRestClient::Response& response) { promise.set_value(response); },
+           order_id);
+    return result.get();
+}
+
+void RestConnectionPool::stop() {
+    for (auto& connection : connections_) {
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            connection->stopping = true;
+        }
+        connection->cv.notify_one();
+    }
+    for (auto& connection : connections_) {
+        if (connection->thread.joinable()) {
+            connection->thread.join();
+        }
+    }
+}
+
+size_t RestConnectionPool::in_flight() const {
+    size_t total = 0;
+    for (const auto& connection : connections_) {
+        total += connection->load.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+RestConnectionPool::Connection& RestConnectionPool::least_loaded() {
+    // Ties go to the lowest index, so a lightly used pool keeps reusing the
+    // connections it has already opened
+    Connection* best = connections_.front().get();
+    size_t best_load = best->load.load(std::memory_order_relaxed);
+    for (size_t i = 1; i < connections_.size() && best_load > 0; ++i) {
+        const size_t load = connections_[i]->load.load(std::memory_order_relaxed);
+        if (load < best_load) {
+            best = connections_[i].get();
+            best_load = load;
+        }
+    }
+    return *best;
+}
+
+RestConnectionPool::Connection& RestConnectionPool::connection_for(int64_t order_id) {
+    // Internal ids are sequential, so consecutive orders still spread out
+    return *connections_[static_cast<uint64_t>(order_id) % connections_.size()];
+}
+
+void RestConnectionPool::run(Connection& connection) {
+    std::unique_lock<std::mutex> lock(connection.mutex);
+    while (true) {
+        connection.cv.wait(lock, [&] {
+            return connection.stopping || !connection.priority.empty() || !connection.normal.empty();
+        });
+        if (connection.stopping) {
+            break;
+        }
+        auto& queue = connection.priority.empty() ? connection.normal : connection.priority;
+        Request request = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        const auto response = connection.client.request(
+            request.verb, request.endpoint, request.query, request.body);
+        // Released before the completion so a caller reacting to it sees
+        // this connection free again
+        connection.load.fetch_sub(1, std::memory_order_relaxed);
+        if (request.done) {
+            request.done(response);
+        }
+        lock.lock();
+    }
+
+    // Whatever was still queued fails rather than going out late
+    std::deque<Request> abandoned;
+    abandoned.swap(connection.priority);
+    for (auto& request : connection.normal) {
+        abandoned.push_back(std::move(request));
+    }
+    connection.normal.clear();
+    lock.unlock();
+
+    BitMEXRestClient::Response stopped;
+    stopped.error = "Connection pool stopped";
+    stopped.unsent = true;
+    for (auto& request : abandoned) {
+        connection.load.fetch_sub(1, std::memory_order_relaxed);
+        if (request.done) {
+            request.done(stopped);
+        }
+    }
+}
@@ -25,26 +25,65 @@ MarketPredictor::MarketPredictor(Config config) : config_(config) {
     model_->to(device_);
 }
 
-torch::Tensor MarketPredictor::predict(const stable_vector<float>& features) {
+torch::Tensor MarketPredictor::predict(const FeatureWindow& window) {
     torch::NoGradGuard no_grad;
     model_->eval();
     
-    auto input_tensor = preprocess_features(features);
+    auto input_tensor = preprocess_features(window);
     return model_->forward(input_tensor);
 }
 
-torch::Tensor MarketPredictor::preprocess_features(const stable_vector<float>& features) {
-    // Convert to tensor and reshape
-    auto tensor = torch::from_blob(
-        const_cast<float*>(features.data()),
-        {1, config_.model_args.num_channels, -1},
-        torch::kFloat32
-    ).to(device_);
+torch::Tensor MarketPredictor::preprocess_features(const FeatureWindow& window) {
+    const int64_t channels = config_.model_args.num_channels;
+    const int64_t seq_len = config_.model_args.seq_len;
+    if (static_cast<int64_t>(window.num_channels()) != channels ||
+        static_cast<int64_t>(window.seq_len()) != seq_len) {
+        throw MarketPredictorError(
+            MarketPredictorError::ErrorCode::DATA_ERROR,
+            "Feature window shape does not match model configuration");
+    }
+    
+    // The window is copied, not viewed: a view would let samples the feed
+    // commits during forward() change this call's input, and the seqlock can
+    // only vouch for a copy taken between two commits. The copy lands in
+    // per-thread scratch sized on first use, so concurrent predict() calls
+    // share nothing and a steady-state call allocates nothing.
+    struct Scratch {
+        torch::Tensor input;   // [1 x channels x seq_len] on the CPU
+        torch::Tensor device_input;
+        std::vector<double> mean;
+        std::vector<double> stddev;
+    };
+    thread_local Scratch scratch;
+    if (!scratch.input.defined() || scratch.input.size(1) != channels ||
+        scratch.input.size(2) != seq_len) {
+        scratch.input = torch::empty({1, channels, seq_len}, torch::kFloat32);
+        scratch.device_input = torch::Tensor();
+        scratch.mean.assign(channels, 0.0);
+        scratch.stddev.assign(channels, 0.0);
+    }
+    float* data = scratch.input.data_ptr<float>();
+    window.snapshot(data, scratch.mean.data(), scratch.stddev.data());
     
-    // Apply normalization if needed
+    // Channels are prices, sizes and ratios, so each is scaled by its own
+    // moments from the same version of the window
     if (config_.preprocessing.normalize) {
-        tensor = (tensor - tensor.mean()) / (tensor.std() + 1e-8);
+        for (int64_t c = 0; c < channels; ++c) {
+            const float m = static_cast<float>(scratch.mean[c]);
+            const float inv = static_cast<float>(1.0 / (scratch.stddev[c] + 1e-8));
+            float* row = data + c * seq_len;
+            for (int64_t t = 0; t < seq_len; ++t) {
+                row[t] = (row[t] - m) * inv;
+            }
+        }
     }
     
-    return tensor;
-}
+    if (device_.is_cpu()) {
+        return scratch.input;
+    }
+    if (!scratch.device_input.defined() || scratch.device_input.device() != device_) {
+        scratch.device_input = torch::empty_like(scratch.input, torch::TensorOptions().device(device_));
+    }
+    scratch.device_input.copy_(scratch.input);
+    return scratch.device_input;
+}
\ No newline at end of file
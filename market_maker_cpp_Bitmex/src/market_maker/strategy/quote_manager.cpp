@@ -0,0 +1,169 @@
+#include "quote_manager.h"
+#include <algorithm>
+#include <cstdlib>
+
+QuoteManager::QuoteManager(std::shared_ptr<OrderManager> order_manager, Config config)
+    : order_manager_(std::move(order_manager))
+    , config_(config)
+    , tick_size_(config.tick_size)
+    , lot_size_(config.lot_size) {
+    bids_.reserve(static_cast<size_t>(config_.max_levels));
+    asks_.reserve(static_cast<size_t>(config_.max_levels));
+    amended_.reserve(static_cast<size_t>(2 * config_.max_levels));
+    cancelled_.reserve(static_cast<size_t>(2 * config_.max_levels));
+}
+
+void QuoteManager::update(
+    const Quote* bids, size_t bid_count,
+    const Quote* asks, size_t ask_count,
+    OrderBatch& batch) {
+
+    update_side(OrderSide::BUY, bids, bid_count, batch);
+    update_side(OrderSide::SELL, asks, ask_count, batch);
+}
+
+void QuoteManager::update_side(
+    OrderSide side,
+    const Quote* quotes,
+    size_t count,
+    OrderBatch& batch) {
+
+    auto& resting = side_of(side);
+
+    // Quotes that filled or were cancelled elsewhere have left OrderManager
+    resting.erase(std::remove_if(resting.begin(), resting.end(), [this](const Resting& r) {
+        return !order_manager_->get_order(r.order_id).has_value();
+    }), resting.end());
+
+    count = std::min(count, static_cast<size_t>(config_.max_levels));
+    size_t kept = 0;
+    for (size_t level = 0; level < count; ++level) {
+        const Price price = tick_size_.from_double<Price>(quotes[level].price);
+        const Qty quantity = lot_size_.from_double<Qty>(quotes[level].quantity);
+        if (quantity.raw() <= 0) {
+            continue;
+        }
+
+        if (kept < resting.size()) {
+            Resting& current = resting[kept];
+            const int64_t price_move = std::abs((price - current.price).raw());
+            const int64_t size_change = std::abs((quantity - current.quantity).raw());
+            if (price_move < config_.amend_ticks && size_change < config_.amend_lots) {
+                ++kept;
+                continue;
+            }
+
+            auto amended = order_manager_->amend_order(
+                current.order_id, tick_size_.to_double(price), lot_size_.to_double(quantity));
+            if (amended) {
+                amended_.push_back({side, current});
+                current.price = price;
+                current.quantity = quantity;
+                batch.amends.push_back(*amended);
+                ++kept;
+                continue;
+            }
+            // Refused by risk or already partly filled past the new size:
+            // pull it rather than leave a stale price resting, and quote the
+            // level afresh below
+            cancel(side, current, batch);
+            resting.erase(resting.begin() + kept);
+        }
+
+        auto placed = order_manager_->place_order(
+            side, tick_size_.to_double(price), lot_size_.to_double(quantity));
+        if (placed) {
+            resting.insert(resting.begin() + kept, {placed->order_id, price, quantity});
+            batch.places.push_back(*placed);
+            ++kept;
+        }
+    }
+
+    // Levels no longer wanted
+    for (size_t i = kept; i < resting.size(); ++i) {
+        cancel(side, resting[i], batch);
+    }
+    resting.resize(kept);
+}
+
+void QuoteManager::cancel_all(OrderBatch& batch) {
+    for (const OrderSide side : {OrderSide::BUY, OrderSide::SELL}) {
+        for (const auto& resting : side_of(side)) {
+            cancel(side, resting, batch);
+        }
+        side_of(side).clear();
+    }
+}
+
+void QuoteManager::forget() {
+    bids_.clear();
+    asks_.clear();
+    amended_.clear();
+    cancelled_.clear();
+}
+
+void QuoteManager::settle(const OrderBatch& batch, const BatchResult& result) {
+    if (!result.amends) {
+        for (const auto& order : batch.amends) {
+            const Pending* pending = find(amended_, order.order_id);
+            if (pending == nullptr) {
+                continue;
+            }
+            order_manager_->restore_order(order.order_id,
+                                          tick_size_.to_double(pending->resting.price),
+                                          lot_size_.to_double(pending->resting.quantity));
+            for (auto& resting : side_of(pending->side)) {
+                if (resting.order_id == order.order_id) {
+                    resting = pending->resting;
+                }
+            }
+        }
+    }
+
+    if (!result.places) {
+        for (const auto& order : batch.places) {
+            order_manager_->cancel_order(order.order_id);
+            auto& resting = side_of(order.side);
+            resting.erase(std::remove_if(resting.begin(), resting.end(), [&](const Resting& r) {
+                return r.order_id == order.order_id;
+            }), resting.end());
+        }
+    }
+
+    // Last, so the levels they rank against are back as they rest
+    for (const int64_t order_id : batch.cancels) {
+        if (result.cancels) {
+            order_manager_->cancel_order(order_id);
+        } else if (const Pending* pending = find(cancelled_, order_id)) {
+            // Still resting on the exchange and still held in OrderManager
+            restore(*pending);
+        }
+    }
+
+    amended_.clear();
+    cancelled_.clear();
+}
+
+void QuoteManager::cancel(OrderSide side, const Resting& resting, OrderBatch& batch) {
+    cancelled_.push_back({side, resting});
+    batch.cancels.push_back(resting.order_id);
+}
+
+void QuoteManager::restore(const Pending& pending) {
+    // Back in its rank: bids best (highest) first, asks lowest first
+    auto& resting = side_of(pending.side);
+    const bool bid = pending.side == OrderSide::BUY;
+    auto at = std::find_if(resting.begin(), resting.end(), [&](const Resting& r) {
+        return bid ? r.price < pending.resting.price : r.price > pending.resting.price;
+    });
+    resting.insert(at, pending.resting);
+}
+
+const QuoteManager::Pending* QuoteManager::find(const std::vector<Pending>& pending, int64_t order_id) {
+    for (const auto& p : pending) {
+        if (p.resting.order_id == order_id) {
+            return &p;
+        }
+    }
+    return nullptr;
+}
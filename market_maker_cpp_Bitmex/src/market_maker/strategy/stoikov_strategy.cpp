@@ -4,15 +4,15 @@
 #include <random>
 
 void StoikovStrategy::on_market_data(const MarketDepth& depth) {
+    // The feed keeps writing the shared book while we run, so it is read
+    // once, consistently, and everything below works from that value
+    const double mid_price = depth.get_mid_price();
+    if (mid_price <= 0.0) return;  // One-sided or empty book
+
     // Update price history and volatility estimate
     {
         std::lock_guard<std::mutex> lock(market_data_mutex_);
-        double mid_price = depth.get_mid_price();
         volatility_estimator_.update(mid_price);
-        
-        if (price_history_.size() >= config_.volatility_window) {
-            price_history_.erase(price_history_.begin());
-        }
         price_history_.push_back(mid_price);
     }
     market_data_cv_.notify_one();
@@ -25,7 +25,6 @@ void StoikovStrategy::on_market_data(const MarketDepth& depth) {
     // Get current position and volatility
     double inventory = order_manager_->get_position();
     double volatility = volatility_estimator_.get_volatility();
-    double mid_price = depth.get_mid_price();
 
     // Calculate reserve price (similar to Bitmex/main.py implementation)
     double reserve_price = mid_price - 
@@ -55,29 +54,30 @@ void StoikovStrategy::on_market_data(const MarketDepth& depth) {
     double bid_size = base_size * std::exp(-config_.risk_aversion * inventory_skew);
     double ask_size = base_size * std::exp(config_.risk_aversion * inventory_skew);
 
-    // Place orders through BitMEX
-    if (bid_size > 0.0 && bid_intensity > config_.min_intensity) {
-        Order bid_order{
-            .side = OrderSide::BUY,
-            .price = bid_price,
-            .quantity = bid_size
-        };
-        
-        if (bitmex_connector_->place_order(bid_order)) {
-            order_manager_->update_order(bid_order);
-        }
+    // Diff against what is already resting; only changes beyond the amend
+    // thresholds reach the exchange, in one batch
+    const QuoteManager::Quote bid{bid_price, bid_size};
+    const QuoteManager::Quote ask{ask_price, ask_size};
+    const bool quote_bid = bid_size > 0.0 && bid_intensity > config_.min_intensity;
+    const bool quote_ask = ask_size > 0.0 && ask_intensity > config_.min_intensity;
+    
+    // StrategyManager may run two ticks of this symbol on different pool
+    // threads; the diff and its round trip go one tick at a time
+    std::lock_guard<std::mutex> quote_lock(quote_mutex_);
+    
+    // The kill switch already cancelled everything at the exchange and in
+    // OrderManager; nothing goes out again until it is reset
+    if (quotes_cancelled_.exchange(false, std::memory_order_acq_rel)) {
+        quote_manager_.forget();
     }
+    if (trading_halted()) return;
+    
+    order_batch_.clear();
+    quote_manager_.update(&bid, quote_bid ? 1 : 0, &ask, quote_ask ? 1 : 0, order_batch_);
     
-    if (ask_size > 0.0 && ask_intensity > config_.min_intensity) {
-        Order ask_order{
-            .side = OrderSide::SELL,
-            .price = ask_price,
-            .quantity = ask_size
-        };
-        
-        if (bitmex_connector_->place_order(ask_order)) {
-            order_manager_->update_order(ask_order);
-        }
+    if (!order_batch_.empty()) {
+        // Local state follows what the exchange accepted; the rest is undone
+        quote_manager_.settle(order_batch_, bitmex_connector_->send_batch(order_batch_));
     }
 }
 
@@ -0,0 +1,162 @@
+#include "book_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace book_kernels {
+
+namespace {
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+inline double hsum(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+#endif
+
+// Scalar tail of a sweep, continuing from an already accumulated result
+inline void sweep_scalar(const double* px, const double* qty, size_t begin, size_t n,
+                         double size, SweepResult& result) {
+    for (size_t i = begin; i < n && result.filled < size; ++i) {
+        const double take = std::min(qty[i], size - result.filled);
+        result.filled += take;
+        result.notional += take * px[i];
+    }
+}
+
+} // namespace
+
+double cumulative_depth(const double* qty, size_t n) {
+    size_t i = 0;
+    double sum = 0.0;
+#if defined(__AVX512F__)
+    const size_t blocks_end = n - n % 8;
+    __m512d acc = _mm512_setzero_pd();
+    for (; i < blocks_end; i += 8) {
+        acc = _mm512_add_pd(acc, _mm512_loadu_pd(qty + i));
+    }
+    if (i < n) {
+        const __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+        acc = _mm512_add_pd(acc, _mm512_maskz_loadu_pd(tail, qty + i));
+        i = n;
+    }
+    sum = _mm512_reduce_add_pd(acc);
+#elif defined(__AVX2__)
+    // Trip count fixed up front so the compiler can bound the scalar tail
+    const size_t blocks_end = n - n % 4;
+    __m256d acc = _mm256_setzero_pd();
+    for (; i < blocks_end; i += 4) {
+        acc = _mm256_add_pd(acc, _mm256_loadu_pd(qty + i));
+    }
+    sum = hsum(acc);
+#endif
+    for (; i < n; ++i) {
+        sum += qty[i];
+    }
+    return sum;
+}
+
+SweepResult sweep(const double* px, const double* qty, size_t n, double size) {
+    SweepResult result;
+    if (size <= 0.0) {
+        return result;
+    }
+    
+    // Whole blocks are taken with vector multiply-adds while the running
+    // fill stays below size; the block that crosses it is finished scalar.
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const size_t blocks_end = n - n % 8;
+    __m512d notional = _mm512_setzero_pd();
+    for (; i < blocks_end; i += 8) {
+        const __m512d q = _mm512_loadu_pd(qty + i);
+        const double block_qty = _mm512_reduce_add_pd(q);
+        if (result.filled + block_qty >= size) {
+            break;
+        }
+        notional = _mm512_fmadd_pd(_mm512_loadu_pd(px + i), q, notional);
+        result.filled += block_qty;
+    }
+    result.notional = _mm512_reduce_add_pd(notional);
+#elif defined(__AVX2__)
+    const size_t blocks_end = n - n % 4;
+    __m256d notional = _mm256_setzero_pd();
+    for (; i < blocks_end; i += 4) {
+        const __m256d q = _mm256_loadu_pd(qty + i);
+        const double block_qty = hsum(q);
+        if (result.filled + block_qty >= size) {
+            break;
+        }
+        notional = _mm256_fmadd_pd(_mm256_loadu_pd(px + i), q, notional);
+        result.filled += block_qty;
+    }
+    result.notional = hsum(notional);
+#endif
+    sweep_scalar(px, qty, i, n, size, result);
+    return result;
+}
+
+double vwap_to_size(const double* px, const double* qty, size_t n, double size) {
+    const SweepResult result = sweep(px, qty, n, size);
+    return result.filled > 0.0 ? result.notional / result.filled : 0.0;
+}
+
+double sweep_cost(const double* px, const double* qty, size_t n, double size, double reference_price) {
+    const SweepResult result = sweep(px, qty, n, size);
+    return std::abs(result.notional - reference_price * result.filled);
+}
+
+double imbalance(const double* bid_qty, const double* ask_qty, size_t n) {
+    const double bid_depth = cumulative_depth(bid_qty, n);
+    const double ask_depth = cumulative_depth(ask_qty, n);
+    const double total = bid_depth + ask_depth;
+    return total > 0.0 ? (bid_depth - ask_depth) / total : 0.0;
+}
+
+void extract_features(const DepthSoA& book, float* out) {
+    const double best_bid = book.bid_px[0];
+    const double best_ask = book.ask_px[0];
+    const bool two_sided = book.bid_levels > 0 && book.ask_levels > 0;
+    
+    const double mid = two_sided ? (best_bid + best_ask) * 0.5 : 0.0;
+    const double top_qty = book.bid_qty[0] + book.ask_qty[0];
+    const double microprice = two_sided && top_qty > 0.0
+        ? (best_ask * book.bid_qty[0] + best_bid * book.ask_qty[0]) / top_qty
+        : mid;
+    
+    out[0] = static_cast<float>(mid);
+    out[1] = static_cast<float>(two_sided ? best_ask - best_bid : 0.0);
+    out[2] = static_cast<float>(microprice);
+    out[3] = static_cast<float>(imbalance(book, 1));
+    out[4] = static_cast<float>(imbalance(book, 5));
+    out[5] = static_cast<float>(imbalance(book, DepthSoA::LEVELS));
+    out[6] = static_cast<float>(cumulative_depth(book, BookSide::BID));
+    out[7] = static_cast<float>(cumulative_depth(book, BookSide::ASK));
+}
+
+void push_features(const MarketDepth& depth, FeatureWindow& window) {
+    if (window.num_channels() < NUM_BOOK_FEATURES) {
+        throw std::runtime_error("Feature window has fewer channels than the book features");
+    }
+    const DepthSoA book(depth);
+    extract_features(book, window.staging());
+    window.commit();
+}
+
+const char* simd_level() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace book_kernels
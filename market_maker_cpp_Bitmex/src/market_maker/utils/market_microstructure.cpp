@@ -1,4 +1,5 @@
 #include "market_microstructure.h"
+#include "book_kernels.h"
 #include <numeric>
 #include <algorithm>
 
@@ -7,27 +8,41 @@ void MarketMicrostructure::update(const MarketDepth& depth, const Order& order)
     OrderBookSnapshot snapshot;
     snapshot.timestamp = std::chrono::system_clock::now().time_since_epoch();
     
-    // Convert market depth to snapshot format
-    for (size_t i = 0; i < MarketDepth::MAX_LEVELS; ++i) {
-        if (depth.bids[i].price > 0) {
-            snapshot.bids.push_back({
-                depth.bids[i].price,
-                depth.bids[i].quantity,
-                1,  // Assuming one order per level for simplicity
-                std::chrono::nanoseconds(depth.bids[i].update_time)
-            });
-        }
-        
-        if (depth.asks[i].price > 0) {
-            snapshot.asks.push_back({
-                depth.asks[i].price,
-                depth.asks[i].quantity,
-                1,
-                std::chrono::nanoseconds(depth.asks[i].update_time)
-            });
+    // Convert market depth to snapshot format from one consistent copy of
+    // the prices, quantities and level timestamps
+    DepthSoA book;
+    int64_t bid_times[DepthSoA::LEVELS];
+    int64_t ask_times[DepthSoA::LEVELS];
+    depth.read_consistent([&](const MarketDepth& src) {
+        book.copy_from(src);
+        for (size_t i = 0; i < DepthSoA::LEVELS; ++i) {
+            bid_times[i] = src.bids[i].update_time.load(std::memory_order_relaxed);
+            ask_times[i] = src.asks[i].update_time.load(std::memory_order_relaxed);
         }
+    });
+    snapshot.bids.reserve(book.bid_levels);
+    snapshot.asks.reserve(book.ask_levels);
+    
+    for (size_t i = 0; i < book.bid_levels; ++i) {
+        snapshot.bids.push_back({
+            book.bid_px[i],
+            book.bid_qty[i],
+            1,  // Assuming one order per level for simplicity
+            std::chrono::nanoseconds(bid_times[i])
+        });
     }
     
+    for (size_t i = 0; i < book.ask_levels; ++i) {
+        snapshot.asks.push_back({
+            book.ask_px[i],
+            book.ask_qty[i],
+            1,
+            std::chrono::nanoseconds(ask_times[i])
+        });
+    }
+    
+    snapshot.imbalance = book_kernels::imbalance(book, IMBALANCE_LEVELS);
+    
     // Store snapshot
     book_history_.push_back(snapshot);
     if (book_history_.size() > HISTORY_SIZE) {
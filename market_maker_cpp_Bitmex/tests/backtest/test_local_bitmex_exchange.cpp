@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <market_maker/backtest/local_bitmex_exchange.h>
+#include <market_maker/exchange/bitmex_connector.h>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "../exchange/order_fixtures.h"
+
+namespace {
+
+BitMEXConnector::Config connector_config(const LocalBitMEXExchange& exchange) {
+    BitMEXConnector::Config config;
+    config.base_url = exchange.rest_url();
+    config.symbol = "XBTUSD";
+    config.api_key = "key";
+    config.api_secret = "secret";
+    return config;
+}
+
+// Collects feed callbacks and lets the test wait for a condition on them
+template <class T>
+struct Collector {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<T> items;
+
+    void add(const T& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push_back(item);
+        cv.notify_all();
+    }
+
+    template <class Pred>
+    bool wait_until(Pred pred) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return pred(items); });
+    }
+};
+
+}  // namespace
+
+TEST(LocalBitMEXExchangeTest, RestOrdersRestFillAndCancel) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    exchange.set_level(OrderSide::SELL, 10000.5, 100);
+    BitMEXConnector connector(connector_config(exchange));
+
+    ASSERT_TRUE(connector.place_order(make_order(1, OrderSide::BUY, 9999.5, 10)));
+    EXPECT_EQ(exchange.open_orders(), 1u);
+
+    // Someone sells into our bid
+    exchange.trade(OrderSide::SELL, 9999.5, 4);
+    EXPECT_DOUBLE_EQ(exchange.position(), 4);
+    EXPECT_EQ(exchange.open_orders(), 1u);
+
+    // Crossing order takes liquidity straight away
+    ASSERT_TRUE(connector.place_order(make_order(2, OrderSide::BUY, 10000.5, 6)));
+    EXPECT_DOUBLE_EQ(exchange.position(), 10);
+    EXPECT_EQ(exchange.open_orders(), 1u);
+
+    ASSERT_TRUE(connector.cancel_order(1));
+    EXPECT_EQ(exchange.open_orders(), 0u);
+    // Unknown or closed orders are reported per row, not as a failed request
+    EXPECT_TRUE(connector.cancel_order(1));
+}
+
+TEST(LocalBitMEXExchangeTest, ClosedOrdersStayQueryableAndKeepTheirClOrdID) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    BitMEXConnector connector(connector_config(exchange));
+
+    ASSERT_TRUE(connector.place_order(make_order(1, OrderSide::BUY, 9999.5, 5)));
+    ASSERT_TRUE(connector.place_order(make_order(2, OrderSide::BUY, 9999.0, 5)));
+    exchange.trade(OrderSide::SELL, 9999.5, 5);
+    ASSERT_EQ(exchange.open_orders(), 1u);
+
+    // The filled order is still found by clOrdID, and only it is returned
+    EXPECT_EQ(connector.has_order(1), std::optional<bool>(true));
+    BitMEXRestClient client({exchange.rest_url(), "key", "secret"});
+    const auto reply = client.request(
+        "GET", "/order", "filter=%7B%22clOrdID%22%3A%22mm_bitmex_1%22%7D&count=1", {});
+    ASSERT_EQ(reply.status, 200);
+    const auto rows = nlohmann::json::parse(reply.body);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0]["clOrdID"], "mm_bitmex_1");
+    EXPECT_EQ(rows[0]["ordStatus"], "Filled");
+    EXPECT_EQ(connector.has_order(3), std::optional<bool>(false));
+
+    // Neither a filled nor a cancelled clOrdID can be placed again
+    EXPECT_FALSE(connector.place_order(make_order(1, OrderSide::BUY, 9000.0, 1)));
+    ASSERT_TRUE(connector.cancel_order(2));
+    EXPECT_EQ(connector.has_order(2), std::optional<bool>(true));
+    EXPECT_FALSE(connector.place_order(make_order(2, OrderSide::BUY, 9000.0, 1)));
+    EXPECT_EQ(exchange.open_orders(), 0u);
+}
+
+TEST(LocalBitMEXExchangeTest, FeedsBookAndExecutionsOverWebSocket) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    exchange.set_level(OrderSide::BUY, 9999.0, 50);
+    exchange.set_level(OrderSide::SELL, 10001.0, 50);
+
+    BitMEXConnector connector(connector_config(exchange));
+    Collector<double> best_bids;
+    Collector<BitMEXConnector::ExecutionUpdate> executions;
+    connector.subscribe_market_data([&](const MarketDepth& depth) { best_bids.add(depth.bids[0].price); });
+    connector.subscribe_executions([&](const auto& update) { executions.add(update); });
+    ASSERT_TRUE(best_bids.wait_until([](const auto& v) { return !v.empty() && v.back() == 9999.0; }));
+
+    // A new best bid is pushed as an orderBookL2 delta
+    ASSERT_TRUE(connector.place_order(make_order(7, OrderSide::BUY, 9999.5, 5)));
+    ASSERT_TRUE(best_bids.wait_until([](const auto& v) { return v.back() == 9999.5; }));
+
+    exchange.trade(OrderSide::SELL, 9999.5, 5);
+    ASSERT_TRUE(executions.wait_until([](const auto& v) {
+        return !v.empty() && v.back().exec_type == "Trade";
+    }));
+    const auto fill = executions.items.back();
+    EXPECT_EQ(fill.order_id, 7);
+    EXPECT_DOUBLE_EQ(fill.exec_price, 9999.5);
+    EXPECT_DOUBLE_EQ(fill.exec_quantity, 5);
+    ASSERT_TRUE(best_bids.wait_until([](const auto& v) { return v.back() == 9999.0; }));
+}
+
+TEST(LocalBitMEXExchangeTest, MalformedFieldsGetABitMEXError) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    BitMEXRestClient client({exchange.rest_url(), "key", "secret"});
+
+    const auto reply = client.request(
+        "POST", "/order", {},
+        R"({"symbol":"XBTUSD","side":"Buy","ordType":"Limit","orderQty":1,"price":"cheap","clOrdID":"x"})");
+    EXPECT_EQ(reply.status, 400);
+    const auto body = nlohmann::json::parse(reply.body, nullptr, false);
+    ASSERT_TRUE(body.contains("error"));
+    EXPECT_EQ(body["error"]["name"], "ValidationError");
+
+    // The session is still there for the next request
+    EXPECT_EQ(client.request("GET", "/position", {}, {}).status, 200);
+    EXPECT_EQ(exchange.open_orders(), 0u);
+}
+
+TEST(LocalBitMEXExchangeTest, InjectsLatencyAndRateLimits) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = std::chrono::milliseconds(20);
+    config.requests_per_minute = 3;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    auto client_config = connector_config(exchange);
+    client_config.rate_limit.cancel_reserve_minute = 0;
+    BitMEXConnector connector(client_config);
+
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(connector.place_order(make_order(1, OrderSide::BUY, 9000.0, 1)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+    exchange.inject_overload(1);
+    EXPECT_FALSE(connector.place_order(make_order(2, OrderSide::BUY, 9000.0, 1)));
+    ASSERT_TRUE(connector.place_order(make_order(3, OrderSide::BUY, 9000.0, 1)));
+
+    // The server did not count the 503, but syncs never hand a spent token
+    // back, so 1, 2 and 3 use up the budget of 3 and nothing more is sent;
+    // anything that still got through would be a 429
+    const uint64_t sent = exchange.requests();
+    EXPECT_FALSE(connector.place_order(make_order(4, OrderSide::BUY, 9000.0, 1)));
+    EXPECT_FALSE(connector.cancel_order(1));
+    EXPECT_EQ(exchange.requests(), sent);
+    EXPECT_EQ(exchange.open_orders(), 2u);
+}
+
+TEST(LocalBitMEXExchangeTest, InjectedRateLimitHoldsClientOff) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    BitMEXConnector connector(connector_config(exchange));
+
+    exchange.inject_rate_limit(1, 30);
+    EXPECT_FALSE(connector.place_order(make_order(1, OrderSide::BUY, 9000.0, 1)));
+    // Retry-After: 30 keeps the next request from leaving the client
+    EXPECT_FALSE(connector.place_order(make_order(2, OrderSide::BUY, 9000.0, 1)));
+    EXPECT_EQ(exchange.requests(), 1u);
+    EXPECT_EQ(exchange.open_orders(), 0u);
+}
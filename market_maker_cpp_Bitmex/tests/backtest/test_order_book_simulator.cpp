@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "order_book_simulator.h"
+
+namespace {
+
+Order limit(int64_t id, OrderSide side, double price, double quantity) {
+    Order order{};
+    order.order_id = id;
+    order.side = side;
+    order.price = price;
+    order.quantity = quantity;
+    return order;
+}
+
+}  // namespace
+
+TEST(OrderBookSimulatorTest, MatchesByPriceThenTime) {
+    OrderBookSimulator sim(OrderBookSimulator::SimConfig{.base_tick_size = 0.5});
+    sim.add_order(limit(1, OrderSide::SELL, 100.5, 5));
+    sim.add_order(limit(2, OrderSide::SELL, 100.0, 5));
+    sim.add_order(limit(3, OrderSide::SELL, 100.0, 5));
+    EXPECT_FALSE(sim.would_cross(OrderSide::BUY, 99.5));
+    EXPECT_TRUE(sim.would_cross(OrderSide::BUY, 100.0));
+
+    // Sweeps the better level oldest first, then trades into the next
+    sim.add_order(limit(4, OrderSide::BUY, 100.5, 12));
+    const auto fills = sim.take_fills();
+    ASSERT_EQ(fills.size(), 3u);
+    EXPECT_EQ(fills[0].maker_order_id, 2);
+    EXPECT_EQ(fills[1].maker_order_id, 3);
+    EXPECT_EQ(fills[2].maker_order_id, 1);
+    EXPECT_DOUBLE_EQ(fills[2].price, 100.5);
+    EXPECT_DOUBLE_EQ(fills[2].quantity, 2);
+    EXPECT_EQ(fills[0].taker_order_id, 4);
+
+    EXPECT_FALSE(sim.has_order(4));
+    EXPECT_DOUBLE_EQ(sim.leaves_quantity(1), 3);
+    EXPECT_TRUE(sim.take_fills().empty());
+}
+
+TEST(OrderBookSimulatorTest, RemainderRestsAndLevelsAggregate) {
+    OrderBookSimulator sim(OrderBookSimulator::SimConfig{.base_tick_size = 0.5});
+    sim.add_order(limit(1, OrderSide::SELL, 100.0, 3));
+    sim.add_order(limit(2, OrderSide::BUY, 100.0, 10));
+    sim.add_order(limit(3, OrderSide::BUY, 100.0, 4));
+    sim.add_order(limit(4, OrderSide::BUY, 99.0, 1));
+
+    std::vector<OrderBookSimulator::BookLevel> levels;
+    ASSERT_EQ(sim.get_levels(OrderSide::BUY, 10, levels), 2u);
+    EXPECT_DOUBLE_EQ(levels[0].price, 100.0);
+    EXPECT_DOUBLE_EQ(levels[0].size, 11);
+    EXPECT_DOUBLE_EQ(levels[1].price, 99.0);
+    EXPECT_EQ(sim.get_levels(OrderSide::SELL, 10, levels), 0u);
+    EXPECT_DOUBLE_EQ(sim.get_current_depth().bids[0].quantity, 11);
+
+    sim.cancel_order(2);
+    sim.get_levels(OrderSide::BUY, 1, levels);
+    EXPECT_DOUBLE_EQ(levels[0].size, 4);
+    EXPECT_FALSE(sim.has_order(2));
+}
+
+TEST(OrderBookSimulatorTest, SizeDownKeepsPriorityOtherChangesRequeue) {
+    OrderBookSimulator sim(OrderBookSimulator::SimConfig{.base_tick_size = 0.5});
+    sim.add_order(limit(1, OrderSide::BUY, 100.0, 10));
+    sim.add_order(limit(2, OrderSide::BUY, 100.0, 10));
+
+    sim.modify_order(limit(1, OrderSide::BUY, 100.0, 6));
+    sim.add_order(limit(9, OrderSide::SELL, 100.0, 1));
+    auto fills = sim.take_fills();
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_EQ(fills[0].maker_order_id, 1);
+    EXPECT_DOUBLE_EQ(sim.leaves_quantity(1), 5);
+
+    // Growing the order sends it to the back of the queue
+    Order grown = limit(1, OrderSide::BUY, 100.0, 20);
+    grown.filled_quantity = 1;
+    sim.modify_order(grown);
+    sim.add_order(limit(10, OrderSide::SELL, 100.0, 1));
+    fills = sim.take_fills();
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_EQ(fills[0].maker_order_id, 2);
+
+    // Repricing through the book trades
+    sim.add_order(limit(11, OrderSide::SELL, 101.0, 5));
+    sim.modify_order(limit(2, OrderSide::BUY, 101.0, 10));
+    fills = sim.take_fills();
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_EQ(fills[0].taker_order_id, 2);
+    EXPECT_DOUBLE_EQ(fills[0].quantity, 5);
+}
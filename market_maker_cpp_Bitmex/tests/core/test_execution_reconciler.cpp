@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <market_maker/risk/execution_reconciler.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../exchange/order_fixtures.h"
+
+namespace {
+
+ExecutionReport trade(int64_t order_id, const std::string& exec_id,
+                      double last_qty, double cum_qty, double leaves_qty) {
+    ExecutionReport report;
+    report.order_id = order_id;
+    report.exec_type = ExecType::TRADE;
+    report.last_px = 10000.0;
+    report.last_qty = last_qty;
+    report.cum_qty = cum_qty;
+    report.leaves_qty = leaves_qty;
+    report.set_exec_id(exec_id);
+    return report;
+}
+
+}  // namespace
+
+TEST(ExecutionReconcilerTest, AppliesPartialThenCompleteFill) {
+    auto orders = make_order_manager();
+    ExecutionReconciler reconciler(orders);
+    std::vector<PositionDelta> deltas;
+    reconciler.add_listener([&](const PositionDelta& delta) { deltas.push_back(delta); });
+
+    auto order = orders->place_order(OrderSide::BUY, 10000.0, 10.0);
+    ASSERT_TRUE(order);
+
+    ASSERT_TRUE(reconciler.enqueue(trade(order->order_id, "e1", 4.0, 4.0, 6.0)));
+    EXPECT_EQ(reconciler.poll(), 1u);
+    auto partial = orders->get_order(order->order_id);
+    ASSERT_TRUE(partial);
+    EXPECT_EQ(partial->status, OrderStatus::PARTIALLY_FILLED);
+    EXPECT_DOUBLE_EQ(partial->filled_quantity, 4.0);
+    EXPECT_DOUBLE_EQ(orders->get_position(), 4.0);
+
+    ASSERT_TRUE(reconciler.enqueue(trade(order->order_id, "e2", 6.0, 10.0, 0.0)));
+    reconciler.poll();
+    // Complete fills leave the live store
+    EXPECT_FALSE(orders->get_order(order->order_id));
+    EXPECT_DOUBLE_EQ(orders->get_position(), 10.0);
+
+    ASSERT_EQ(deltas.size(), 2u);
+    EXPECT_DOUBLE_EQ(deltas[0].quantity, 4.0);
+    EXPECT_DOUBLE_EQ(deltas[1].quantity, 6.0);
+    EXPECT_DOUBLE_EQ(deltas[1].position, 10.0);
+    EXPECT_EQ(reconciler.applied(), 2u);
+}
+
+TEST(ExecutionReconcilerTest, MissingLeavesQtyIsNotAFullFill) {
+    auto orders = make_order_manager();
+    ExecutionReconciler reconciler(orders);
+    auto order = orders->place_order(OrderSide::BUY, 10000.0, 10.0);
+    ASSERT_TRUE(order);
+
+    auto partial = trade(order->order_id, "e1", 4.0, 4.0, 0.0);
+    partial.has_leaves_qty = false;
+    ASSERT_TRUE(reconciler.enqueue(partial));
+    reconciler.poll();
+    auto live = orders->get_order(order->order_id);
+    ASSERT_TRUE(live);
+    EXPECT_EQ(live->status, OrderStatus::PARTIALLY_FILLED);
+
+    // Our own quantity still tells when it is done
+    auto rest = trade(order->order_id, "e2", 6.0, 10.0, 0.0);
+    rest.has_leaves_qty = false;
+    ASSERT_TRUE(reconciler.enqueue(rest));
+    reconciler.poll();
+    EXPECT_FALSE(orders->get_order(order->order_id));
+    EXPECT_DOUBLE_EQ(orders->get_position(), 10.0);
+}
+
+TEST(ExecutionReconcilerTest, ReplayedExecIdsAreIgnored) {
+    auto orders = make_order_manager();
+    ExecutionReconciler reconciler(orders);
+    int deltas = 0;
+    reconciler.add_listener([&](const PositionDelta&) { ++deltas; });
+
+    auto order = orders->place_order(OrderSide::SELL, 10000.0, 10.0);
+    ASSERT_TRUE(order);
+
+    // Same execution twice, as after a reconnect replays the table
+    reconciler.enqueue(trade(order->order_id, "dup", 3.0, 3.0, 7.0));
+    reconciler.enqueue(trade(order->order_id, "dup", 3.0, 3.0, 7.0));
+    reconciler.poll();
+
+    EXPECT_EQ(reconciler.duplicates(), 1u);
+    EXPECT_EQ(deltas, 1);
+    EXPECT_DOUBLE_EQ(orders->get_position(), -3.0);
+}
+
+TEST(ExecutionReconcilerTest, DedupWindowForgetsOldest) {
+    auto orders = make_order_manager();
+    ExecutionReconciler reconciler(orders, {.queue_capacity = 16, .dedup_window = 2});
+
+    ExecutionReport report;
+    report.exec_type = ExecType::NEW;
+    for (const char* id : {"a", "b", "c", "a"}) {
+        report.set_exec_id(id);
+        reconciler.enqueue(report);
+    }
+    reconciler.poll();
+    // "a" had been evicted by "c" before it came round again
+    EXPECT_EQ(reconciler.duplicates(), 0u);
+
+    report.set_exec_id("c");
+    reconciler.enqueue(report);
+    reconciler.poll();
+    EXPECT_EQ(reconciler.duplicates(), 1u);
+}
+
+TEST(ExecutionReconcilerTest, CancelReleasesAndUnknownFillsAreCounted) {
+    auto orders = make_order_manager();
+    ExecutionReconciler reconciler(orders, {.queue_capacity = 2, .dedup_window = 16});
+
+    auto order = orders->place_order(OrderSide::BUY, 10000.0, 5.0);
+    ASSERT_TRUE(order);
+
+    ExecutionReport cancel;
+    cancel.order_id = order->order_id;
+    cancel.exec_type = ExecType::CANCELED;
+    cancel.set_exec_id("c1");
+    reconciler.enqueue(cancel);
+    // Not ours: order_id 0
+    reconciler.enqueue(trade(0, "t1", 1.0, 1.0, 0.0));
+    // Queue is full: dropped rather than waited on
+    EXPECT_FALSE(reconciler.enqueue(trade(0, "t2", 1.0, 1.0, 0.0)));
+    EXPECT_EQ(reconciler.dropped(), 1u);
+
+    reconciler.poll();
+    EXPECT_FALSE(orders->get_order(order->order_id));
+    EXPECT_EQ(orders->active_order_count(), 0);
+    EXPECT_EQ(reconciler.unmatched(), 1u);
+    EXPECT_DOUBLE_EQ(orders->get_position(), 0.0);
+}
+
+TEST(ExecutionReconcilerTest, FillRacingLocalCancelStillMovesPosition) {
+    auto orders = make_order_manager();
+    ExecutionReconciler reconciler(orders);
+    std::vector<PositionDelta> deltas;
+    reconciler.add_listener([&](const PositionDelta& delta) { deltas.push_back(delta); });
+
+    auto order = orders->place_order(OrderSide::SELL, 10000.0, 5.0);
+    ASSERT_TRUE(order);
+    ASSERT_TRUE(orders->cancel_order(order->order_id));
+    EXPECT_DOUBLE_EQ(orders->get_notional_exposure(), 0.0);
+
+    // The exchange filled part of it before our cancel arrived
+    ExecutionReport fill = trade(order->order_id, "late", 2.0, 2.0, 3.0);
+    fill.side = OrderSide::SELL;
+    reconciler.enqueue(fill);
+    reconciler.poll();
+
+    EXPECT_EQ(reconciler.untracked(), 1u);
+    EXPECT_EQ(reconciler.unmatched(), 0u);
+    EXPECT_DOUBLE_EQ(orders->get_position(), -2.0);
+    EXPECT_DOUBLE_EQ(orders->get_notional_exposure(), 20000.0);
+    ASSERT_EQ(deltas.size(), 1u);
+    EXPECT_DOUBLE_EQ(deltas[0].quantity, -2.0);
+    EXPECT_DOUBLE_EQ(deltas[0].position, -2.0);
+
+    // Buying it back hands the headroom back as usual
+    auto cover = orders->place_order(OrderSide::BUY, 10000.0, 2.0);
+    ASSERT_TRUE(cover);
+    reconciler.enqueue(trade(cover->order_id, "cover", 2.0, 2.0, 0.0));
+    reconciler.poll();
+    EXPECT_DOUBLE_EQ(orders->get_position(), 0.0);
+    EXPECT_DOUBLE_EQ(orders->get_notional_exposure(), 0.0);
+}
+
+TEST(ExecutionReconcilerTest, BackgroundThreadDrainsFeed) {
+    auto orders = make_order_manager();
+    ExecutionReconciler reconciler(orders);
+    std::atomic<int> deltas{0};
+    reconciler.add_listener([&](const PositionDelta&) { deltas.fetch_add(1); });
+
+    auto order = orders->place_order(OrderSide::BUY, 10000.0, 50.0);
+    ASSERT_TRUE(order);
+    reconciler.start();
+
+    std::thread feed([&] {
+        for (int i = 1; i <= 50; ++i) {
+            while (!reconciler.enqueue(
+                trade(order->order_id, "e" + std::to_string(i), 1.0, i, 50.0 - i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    feed.join();
+    reconciler.stop();
+
+    EXPECT_EQ(deltas.load(), 50);
+    EXPECT_DOUBLE_EQ(orders->get_position(), 50.0);
+    EXPECT_FALSE(orders->get_order(order->order_id));
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <market_maker/risk/exposure_limiter.h>
+#include <market_maker/risk/order_manager.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST(ExposureLimiterTest, ReservationsCountAgainstLimits) {
+    ExposureLimiter limiter(10, 1000);
+
+    EXPECT_TRUE(limiter.reserve(6, 100));
+    EXPECT_FALSE(limiter.reserve(5, 1));      // 6 + 5 > 10 long
+    EXPECT_TRUE(limiter.reserve(-3, 100));    // Shorts have their own headroom
+    EXPECT_FALSE(limiter.reserve(-2, 100));   // Notional 900 + 200 > 1000
+
+    limiter.fill(6, 100);
+    EXPECT_EQ(limiter.position(), 6);
+    EXPECT_EQ(limiter.long_exposure(), 6);
+    EXPECT_EQ(limiter.short_exposure(), -3);  // Long position frees short headroom
+
+    limiter.release(-3, 100);
+    EXPECT_EQ(limiter.short_exposure(), -6);
+    EXPECT_EQ(limiter.notional(), 600);
+}
+
+TEST(ExposureLimiterTest, OffsettingFillsHandNotionalBack) {
+    ExposureLimiter limiter(100, 2500);
+
+    // Round trips must not ratchet notional up
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(limiter.reserve(10, 100)) << i;
+        limiter.fill(10, 100);
+        EXPECT_EQ(limiter.notional(), 1000);
+        ASSERT_TRUE(limiter.reserve(-10, 110)) << i;
+        limiter.fill(-10, 110);
+        EXPECT_EQ(limiter.position(), 0);
+        EXPECT_EQ(limiter.notional(), 0);
+    }
+    EXPECT_TRUE(limiter.reserve(25, 100));  // The whole limit is available again
+    limiter.release(25, 100);
+
+    // Partial close keeps the remaining lots' share; a flip opens at the fill price
+    ASSERT_TRUE(limiter.reserve(10, 100));
+    limiter.fill(10, 100);
+    ASSERT_TRUE(limiter.reserve(-4, 120));
+    limiter.fill(-4, 120);
+    EXPECT_EQ(limiter.notional(), 600);
+    ASSERT_TRUE(limiter.reserve(-10, 120));
+    limiter.fill(-10, 120);
+    EXPECT_EQ(limiter.position(), -4);
+    EXPECT_EQ(limiter.notional(), 480);
+}
+
+TEST(ExposureLimiterTest, FailedNotionalReserveLeavesNoResidue) {
+    ExposureLimiter limiter(100, 50);
+    EXPECT_FALSE(limiter.reserve(1, 60));
+    EXPECT_EQ(limiter.long_exposure(), 0);
+    EXPECT_EQ(limiter.notional(), 0);
+}
+
+TEST(ExposureLimiterTest, ConcurrentReservationsNeverBreachLimits) {
+    constexpr int64_t MAX_POSITION = 50;
+    constexpr int64_t MAX_NOTIONAL = 6'000;  // Binds before MAX_POSITION does at times
+    constexpr int THREADS = 8;
+    constexpr int ITERATIONS = 100'000;
+
+    ExposureLimiter limiter(MAX_POSITION, MAX_NOTIONAL);
+    std::atomic<bool> stop{false};
+    std::atomic<int> violations{0};
+    std::atomic<int> reserved{0};
+
+    // Watches the realised position and every bounded word while workers churn
+    std::thread monitor([&] {
+        while (!stop.load(std::memory_order_acquire)) {
+            const int64_t position = limiter.position();
+            if (position > MAX_POSITION || position < -MAX_POSITION ||
+                limiter.long_exposure() > MAX_POSITION ||
+                limiter.short_exposure() > MAX_POSITION ||
+                limiter.notional() > MAX_NOTIONAL) {
+                violations.fetch_add(1);
+            }
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            for (int i = 0; i < ITERATIONS; ++i) {
+                const int64_t size = 1 + rng() % 10;
+                const int64_t lots = (rng() & 1) ? size : -size;
+                const int64_t price = 90 + rng() % 20;
+                if (!limiter.reserve(lots, price)) {
+                    continue;
+                }
+                reserved.fetch_add(1, std::memory_order_relaxed);
+                // Fill some, cancel the rest
+                const int64_t filled = rng() % (size + 1);
+                const int64_t sign = lots > 0 ? 1 : -1;
+                if (filled > 0) {
+                    limiter.fill(sign * filled, price);
+                }
+                limiter.release(sign * (size - filled), price);
+
+                // Flatten occasionally so the position keeps moving
+                if (filled > 0 && (rng() % 4) == 0 && limiter.reserve(-sign * filled, price)) {
+                    limiter.fill(-sign * filled, price);
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    stop.store(true, std::memory_order_release);
+    monitor.join();
+
+    EXPECT_EQ(violations.load(), 0);
+    EXPECT_LE(std::abs(limiter.position()), MAX_POSITION);
+    // Headroom keeps coming back, so the limits are exercised throughout
+    EXPECT_GT(reserved.load(), THREADS * ITERATIONS / 10);
+
+    // With every order settled only the position remains
+    EXPECT_EQ(limiter.long_exposure(), limiter.position());
+    EXPECT_EQ(limiter.short_exposure(), -limiter.position());
+    EXPECT_LE(limiter.notional(), std::abs(limiter.position()) * 110);
+    EXPECT_GE(limiter.notional(), std::abs(limiter.position()) * 89);
+}
+
+TEST(OrderManagerTest, ConcurrentPlacersRespectMaxPosition) {
+    OrderManager::Config config;
+    config.max_position = 20.0;
+    config.max_order_size = 1.0;
+    config.max_notional = 1e9;
+    config.max_active_orders = 1000;
+    OrderManager manager(config);
+
+    std::atomic<int> placed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 100; ++i) {
+                if (manager.place_order(OrderSide::BUY, 100.0, 1.0)) {
+                    placed.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(placed.load(), 20);
+    EXPECT_FALSE(manager.check_risk_limits(OrderSide::BUY, 1.0, 100.0));
+    EXPECT_TRUE(manager.check_risk_limits(OrderSide::SELL, 1.0, 100.0));
+}
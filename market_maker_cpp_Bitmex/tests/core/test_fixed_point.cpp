@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/fixed_point.h>
+#include <unordered_set>
+
+TEST(FixedPointTest, RuntimeTickSizeRoundTripsDecimals) {
+    TickSize cents(0.01);
+    for (double price : {0.07, 1.1, 123.45, 99999.99}) {
+        Price ticks = cents.from_double(price);
+        EXPECT_EQ(cents.to_double(ticks), price) << price;
+    }
+    
+    TickSize five(5.0);
+    EXPECT_EQ(five.from_double(12345.0).raw(), 2469);
+    EXPECT_EQ(five.to_double(Price(2469)), 12345.0);
+}
+
+TEST(FixedPointTest, StaticTickSizeMatchesRuntime) {
+    TickSize half = HalfTick::runtime();
+    for (double price : {0.5, 43210.5, 65000.0}) {
+        EXPECT_EQ(HalfTick::from_double(price), half.from_double(price));
+        EXPECT_EQ(HalfTick::to_double(HalfTick::from_double(price)), price);
+    }
+    EXPECT_EQ(NickelTick::to_double(NickelTick::from_double(2345.65)), 2345.65);
+}
+
+TEST(FixedPointTest, SnapsToNearestTick) {
+    EXPECT_EQ(HalfTick::from_double(100.26).raw(), 201);
+    EXPECT_EQ(HalfTick::from_double(100.24).raw(), 200);
+}
+
+TEST(FixedPointTest, IntegerOrderingAndHashing) {
+    Price a(100), b(101);
+    EXPECT_LT(a, b);
+    EXPECT_EQ(a + Price(1), b);
+    
+    std::unordered_set<Qty> lots{Qty(1), Qty(2), Qty(1)};
+    EXPECT_EQ(lots.size(), 2u);
+}
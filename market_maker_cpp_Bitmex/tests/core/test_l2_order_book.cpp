@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/l2_order_book.h>
+
+class L2OrderBookTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::vector<L2OrderBook::Entry> snapshot;
+        for (int i = 0; i < 30; ++i) {
+            snapshot.push_back(book.make_entry(1000 + i, BookSide::BID, 100.0 - i, 10.0));
+            snapshot.push_back(book.make_entry(2000 + i, BookSide::ASK, 101.0 + i, 10.0));
+        }
+        ASSERT_TRUE(book.apply(L2OrderBook::Action::PARTIAL,
+                               snapshot.data(), snapshot.size(), depth));
+    }
+    
+    L2OrderBook book;
+    MarketDepth depth;
+};
+
+TEST_F(L2OrderBookTest, PartialPublishesTopLevels) {
+    EXPECT_DOUBLE_EQ(depth.bids[0].price, 100.0);
+    EXPECT_DOUBLE_EQ(depth.asks[0].price, 101.0);
+    EXPECT_DOUBLE_EQ(depth.bids[MarketDepth::MAX_LEVELS - 1].price, 81.0);
+    EXPECT_EQ(book.level_count(BookSide::BID), 30u);
+}
+
+TEST_F(L2OrderBookTest, UpdateInsideTopRepublishes) {
+    auto update = book.make_entry(1000, BookSide::BID, 0.0, 42.0);
+    EXPECT_TRUE(book.apply(L2OrderBook::Action::UPDATE, &update, 1, depth));
+    EXPECT_DOUBLE_EQ(depth.bids[0].quantity, 42.0);
+}
+
+TEST_F(L2OrderBookTest, ChangeBelowTopIsNotPublished) {
+    const uint64_t sequence = depth.sequence.load();
+    auto update = book.make_entry(1025, BookSide::BID, 0.0, 42.0);
+    EXPECT_FALSE(book.apply(L2OrderBook::Action::UPDATE, &update, 1, depth));
+    EXPECT_EQ(depth.sequence.load(), sequence);
+    
+    std::vector<L2OrderBook::PriceLevel> levels;
+    book.get_levels(BookSide::BID, 30, levels);
+    EXPECT_DOUBLE_EQ(levels[25].size, 42.0);
+}
+
+TEST_F(L2OrderBookTest, DeleteShiftsDeeperLevelIn) {
+    auto removed = book.make_entry(2000, BookSide::ASK, 0.0, 0.0);
+    EXPECT_TRUE(book.apply(L2OrderBook::Action::DELETE, &removed, 1, depth));
+    EXPECT_DOUBLE_EQ(depth.asks[0].price, 102.0);
+    EXPECT_DOUBLE_EQ(depth.asks[MarketDepth::MAX_LEVELS - 1].price, 121.0);
+}
+
+TEST_F(L2OrderBookTest, PricesRoundTripThroughTicks) {
+    L2OrderBook cents(CentTick::runtime());
+    auto level = cents.make_entry(1, BookSide::BID, 123.45, 7.0);
+    EXPECT_EQ(level.price.raw(), 12345);
+    
+    MarketDepth cent_depth;
+    cents.apply(L2OrderBook::Action::PARTIAL, &level, 1, cent_depth);
+    EXPECT_EQ(cent_depth.bids[0].price, 123.45);
+}
+
+TEST_F(L2OrderBookTest, InsertImprovingBestRepublishes) {
+    auto inserted = book.make_entry(999, BookSide::BID, 100.5, 3.0);
+    EXPECT_TRUE(book.apply(L2OrderBook::Action::INSERT, &inserted, 1, depth));
+    EXPECT_DOUBLE_EQ(depth.bids[0].price, 100.5);
+    EXPECT_DOUBLE_EQ(depth.bids[1].price, 100.0);
+}
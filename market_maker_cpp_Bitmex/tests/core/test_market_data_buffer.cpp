@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/market_data.h>
+#include <thread>
+
+class MarketDataBufferTest : public ::testing::Test {
+protected:
+    static MarketDepth make_depth(double price) {
+        MarketDepth depth;
+        depth.asks[0].price = price;
+        depth.bids[0].price = price;
+        return depth;
+    }
+};
+
+TEST_F(MarketDataBufferTest, CapacityRoundsUpToPowerOfTwo) {
+    MarketDataBuffer buffer(1000);
+    EXPECT_EQ(buffer.capacity(), 1024u);
+}
+
+TEST_F(MarketDataBufferTest, EvictsOldestWhenFull) {
+    MarketDataBuffer buffer(4);
+    for (int i = 0; i < 10; ++i) {
+        buffer.push_depth(make_depth(i));
+    }
+    EXPECT_EQ(buffer.size(), 4u);
+    
+    auto view = buffer.get_recent_depth(100);
+    ASSERT_EQ(view.size(), 4u);
+    
+    MarketDepth oldest;
+    ASSERT_TRUE(view.copy(0, oldest));
+    EXPECT_DOUBLE_EQ(oldest.asks[0].price, 6.0);
+}
+
+TEST_F(MarketDataBufferTest, ViewDetectsOverwrittenEntries) {
+    MarketDataBuffer buffer(4);
+    for (int i = 0; i < 4; ++i) {
+        buffer.push_depth(make_depth(i));
+    }
+    auto view = buffer.get_recent_depth(4);
+    buffer.push_depth(make_depth(4));
+    
+    MarketDepth depth;
+    EXPECT_FALSE(view.copy(0, depth));
+    EXPECT_TRUE(view.copy(1, depth));
+    EXPECT_EQ(view.for_each([](const MarketDepth&) {}), 3u);
+}
+
+TEST_F(MarketDataBufferTest, ConcurrentReadersNeverSeeTornSnapshots) {
+    MarketDataBuffer buffer(64);
+    std::atomic<bool> done{false};
+    std::atomic<size_t> torn{0};
+    
+    std::thread reader([&] {
+        while (!done.load()) {
+            auto view = buffer.get_recent_depth(16);
+            MarketDepth depth;
+            for (size_t i = 0; i < view.size(); ++i) {
+                if (view.copy(i, depth) && depth.asks[0].price != depth.bids[0].price) {
+                    torn.fetch_add(1);
+                }
+            }
+        }
+    });
+    
+    for (int i = 0; i < 200000; ++i) {
+        buffer.push_depth(make_depth(i));
+    }
+    done = true;
+    reader.join();
+    
+    EXPECT_EQ(torn.load(), 0u);
+}
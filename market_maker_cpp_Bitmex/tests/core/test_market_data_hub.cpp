@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/market_data_hub.h>
+
+class MarketDataHubTest : public ::testing::Test {
+protected:
+    static MarketDepth make_depth(double bid) {
+        MarketDepth depth;
+        depth.begin_update();
+        depth.update_bid(0, bid, 1.0);
+        depth.update_ask(0, bid + 1.0, 1.0);
+        depth.commit();
+        return depth;
+    }
+    
+    MarketDataHub hub;
+};
+
+TEST_F(MarketDataHubTest, SubscribersShareOneSnapshot) {
+    std::vector<const MarketDepth*> seen;
+    for (int i = 0; i < 3; ++i) {
+        hub.subscribe("XBTUSD", [&](const std::string&, const MarketDataHub::Snapshot& s) {
+            seen.push_back(s.get());
+        });
+    }
+    hub.subscribe("ETHUSD", [&](const std::string&, const MarketDataHub::Snapshot&) {
+        FAIL() << "Wrong symbol delivered";
+    });
+    
+    hub.publish("XBTUSD", make_depth(100.0));
+    
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[0], seen[1]);
+    EXPECT_EQ(seen[1], seen[2]);
+    EXPECT_DOUBLE_EQ(hub.latest("XBTUSD")->get_mid_price(), 100.5);
+}
+
+TEST_F(MarketDataHubTest, SnapshotsAreImmutableAcrossPublishes) {
+    MarketDataHub::Snapshot held;
+    hub.subscribe("XBTUSD", [&](const std::string&, const MarketDataHub::Snapshot& s) {
+        if (!held) held = s;
+    });
+    
+    auto& channel = hub.channel("XBTUSD");
+    hub.publish(channel, make_depth(100.0));
+    hub.publish(channel, make_depth(200.0));
+    
+    EXPECT_DOUBLE_EQ(held->bids[0].price, 100.0);
+    EXPECT_DOUBLE_EQ(channel.latest()->bids[0].price, 200.0);
+}
+
+TEST_F(MarketDataHubTest, UnsubscribeStopsDelivery) {
+    int calls = 0;
+    auto id = hub.subscribe("XBTUSD", [&](const std::string&, const MarketDataHub::Snapshot&) {
+        ++calls;
+    });
+    hub.publish("XBTUSD", make_depth(1.0));
+    hub.unsubscribe(id);
+    hub.publish("XBTUSD", make_depth(2.0));
+    
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(hub.latest("SOLUSD"), nullptr);
+}
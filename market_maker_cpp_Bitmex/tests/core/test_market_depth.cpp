@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/market_data.h>
+#include <thread>
+
+TEST(MarketDepthTest, MidAndSpread) {
+    MarketDepth depth;
+    depth.begin_update();
+    depth.update_bid(0, 99.5, 10.0);
+    depth.update_ask(0, 100.5, 12.0);
+    depth.commit();
+    
+    EXPECT_DOUBLE_EQ(depth.get_mid_price(), 100.0);
+    EXPECT_DOUBLE_EQ(depth.get_spread(), 1.0);
+    EXPECT_EQ(depth.sequence.load() % 2, 0u);
+}
+
+TEST(MarketDepthTest, ReadersNeverSeeTornBooks) {
+    auto depth = std::make_shared<MarketDepth>();
+    std::atomic<bool> done{false};
+    std::atomic<size_t> torn{0};
+    
+    std::thread reader([&] {
+        while (!done.load()) {
+            bool consistent = depth->read_consistent([](const MarketDepth& book) {
+                for (size_t i = 1; i < MarketDepth::MAX_LEVELS; ++i) {
+                    if (book.bids[i].price != book.bids[0].price ||
+                        book.asks[i].price != book.bids[0].price) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+            if (!consistent) {
+                torn.fetch_add(1);
+            }
+        }
+    });
+    
+    for (int update = 1; update <= 20000; ++update) {
+        depth->begin_update();
+        for (size_t i = 0; i < MarketDepth::MAX_LEVELS; ++i) {
+            depth->update_bid(i, update, 1.0);
+            depth->update_ask(i, update, 1.0);
+        }
+        depth->commit();
+    }
+    done = true;
+    reader.join();
+    
+    EXPECT_EQ(torn.load(), 0u);
+}
+
+TEST(MarketDepthTest, SnapshotIsIndependentCopy) {
+    MarketDepth depth;
+    depth.begin_update();
+    depth.update_bid(0, 50.0, 1.0);
+    depth.commit();
+    
+    MarketDepth copy = depth.snapshot();
+    depth.begin_update();
+    depth.update_bid(0, 51.0, 1.0);
+    depth.commit();
+    
+    EXPECT_DOUBLE_EQ(copy.bids[0].price, 50.0);
+}
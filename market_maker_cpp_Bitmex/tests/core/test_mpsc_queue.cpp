@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/mpsc_queue.h>
+#include <thread>
+#include <vector>
+
+TEST(MpscQueueTest, PopsInPushOrderAndReportsFull) {
+    MpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(4));
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+
+    // Slots are reusable after wrapping
+    EXPECT_TRUE(queue.try_push(5));
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, 5);
+}
+
+TEST(MpscQueueTest, ConcurrentProducersLoseNothing) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    MpscQueue<int64_t> queue(256);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                const int64_t value = static_cast<int64_t>(p) << 32 | i;
+                while (!queue.try_push(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each producer's values must arrive complete and in its own order
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    int64_t value;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        if (!queue.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int p = static_cast<int>(value >> 32);
+        ASSERT_EQ(static_cast<int>(value & 0xffffffff), next[p]);
+        ++next[p];
+        ++received;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/order_index.h>
+#include <market_maker/risk/order_manager.h>
+#include <random>
+#include <unordered_map>
+
+TEST(OrderIndexTest, InsertFindErase) {
+    OrderIndex index(8);
+
+    EXPECT_TRUE(index.insert(42, 3));
+    EXPECT_FALSE(index.insert(42, 4));
+    EXPECT_EQ(index.find(42), 3u);
+    EXPECT_EQ(index.find(43), OrderIndex::NPOS);
+
+    EXPECT_TRUE(index.erase(42));
+    EXPECT_FALSE(index.erase(42));
+    EXPECT_EQ(index.find(42), OrderIndex::NPOS);
+    EXPECT_EQ(index.size(), 0u);
+}
+
+TEST(OrderIndexTest, RejectsBeyondCapacity) {
+    OrderIndex index(4);
+    for (int64_t id = 1; id <= 4; ++id) {
+        EXPECT_TRUE(index.insert(id, static_cast<uint32_t>(id)));
+    }
+    EXPECT_FALSE(index.insert(5, 5));
+
+    index.erase(2);
+    EXPECT_TRUE(index.insert(5, 5));
+}
+
+TEST(OrderIndexTest, ChurnMatchesReferenceMap) {
+    const size_t live = 64;
+    OrderIndex index(live);
+    std::unordered_map<int64_t, uint32_t> reference;
+    std::mt19937_64 rng(7);
+
+    // Long-running session: ids keep growing, live set stays bounded
+    int64_t next_id = 1;
+    for (int step = 0; step < 200000; ++step) {
+        if (reference.size() < live && (rng() & 1)) {
+            const uint32_t value = static_cast<uint32_t>(rng());
+            ASSERT_TRUE(index.insert(next_id, value));
+            reference[next_id++] = value;
+        } else if (!reference.empty()) {
+            auto it = reference.begin();
+            std::advance(it, rng() % reference.size());
+            ASSERT_TRUE(index.erase(it->first));
+            reference.erase(it);
+        }
+
+        if (step % 1000 == 0) {
+            for (const auto& [id, value] : reference) {
+                ASSERT_EQ(index.find(id), value);
+            }
+            ASSERT_EQ(index.find(next_id), OrderIndex::NPOS);
+        }
+    }
+    EXPECT_EQ(index.size(), reference.size());
+}
+
+TEST(OrderManagerTest, ActiveOrderLimitRecyclesSlots) {
+    OrderManager::Config config;
+    config.max_active_orders = 2;
+    OrderManager manager(config);
+
+    auto a = manager.place_order(OrderSide::BUY, 100.0, 1.0);
+    auto b = manager.place_order(OrderSide::SELL, 101.0, 1.0);
+    ASSERT_TRUE(a && b);
+    EXPECT_FALSE(manager.place_order(OrderSide::BUY, 99.5, 1.0));
+    EXPECT_EQ(manager.active_order_count(), 2);
+
+    EXPECT_TRUE(manager.cancel_order(a->order_id));
+    EXPECT_FALSE(manager.cancel_order(a->order_id));
+    EXPECT_FALSE(manager.get_order(a->order_id));
+    EXPECT_EQ(manager.active_order_count(), 1);
+
+    // Terminal updates also free the slot
+    Order filled = *b;
+    filled.filled_quantity = 1.0;
+    filled.status = OrderStatus::FILLED;
+    manager.update_order(filled);
+    EXPECT_EQ(manager.active_order_count(), 0);
+    EXPECT_DOUBLE_EQ(manager.get_position(), -1.0);
+
+    EXPECT_TRUE(manager.place_order(OrderSide::BUY, 99.5, 1.0));
+    EXPECT_TRUE(manager.place_order(OrderSide::BUY, 99.0, 1.0));
+}
+
+TEST(OrderManagerTest, PartialFillsAccumulatePosition) {
+    OrderManager manager(OrderManager::Config{});
+    auto order = manager.place_order(OrderSide::BUY, 100.0, 4.0);
+    ASSERT_TRUE(order);
+
+    Order update = *order;
+    update.filled_quantity = 1.0;
+    update.status = OrderStatus::PARTIALLY_FILLED;
+    manager.update_order(update);
+    update.filled_quantity = 3.0;
+    manager.update_order(update);
+
+    EXPECT_DOUBLE_EQ(manager.get_position(), 3.0);
+    // Filled and still-resting notional are both claimed
+    EXPECT_DOUBLE_EQ(manager.get_notional_exposure(), 400.0);
+    ASSERT_TRUE(manager.get_order(order->order_id));
+    EXPECT_DOUBLE_EQ(manager.get_order(order->order_id)->filled_quantity, 3.0);
+}
+
+TEST(OrderManagerTest, HandlesGoStaleAfterCancel) {
+    OrderManager::Config config;
+    config.max_active_orders = 1;
+    OrderManager manager(config);
+
+    auto first = manager.place_order(OrderSide::BUY, 100.0, 1.0);
+    ASSERT_TRUE(first);
+    const auto handle = manager.find_handle(first->order_id);
+    ASSERT_TRUE(handle.valid());
+    EXPECT_EQ(manager.get_order(handle)->order_id, first->order_id);
+
+    EXPECT_TRUE(manager.cancel_order(handle));
+    EXPECT_FALSE(manager.cancel_order(handle));
+
+    // Same slot, new generation: the old handle must not see the new order
+    auto second = manager.place_order(OrderSide::SELL, 101.0, 1.0);
+    ASSERT_TRUE(second);
+    EXPECT_FALSE(manager.get_order(handle));
+    EXPECT_FALSE(manager.cancel_order(handle));
+    EXPECT_FALSE(manager.find_handle(first->order_id).valid());
+    EXPECT_TRUE(manager.cancel_order(second->order_id));
+}
+
+TEST(OrderManagerTest, AmendMovesReservation) {
+    OrderManager manager(OrderManager::Config{});
+    auto order = manager.place_order(OrderSide::BUY, 100.0, 4.0);
+    ASSERT_TRUE(order);
+    EXPECT_DOUBLE_EQ(manager.get_notional_exposure(), 400.0);
+
+    auto amended = manager.amend_order(order->order_id, 101.0, 2.0);
+    ASSERT_TRUE(amended);
+    EXPECT_DOUBLE_EQ(amended->price, 101.0);
+    EXPECT_DOUBLE_EQ(manager.get_notional_exposure(), 202.0);
+
+    // Cannot shrink below what already filled
+    Order update = *amended;
+    update.filled_quantity = 1.0;
+    update.status = OrderStatus::PARTIALLY_FILLED;
+    manager.update_order(update);
+    EXPECT_FALSE(manager.amend_order(order->order_id, 101.0, 1.0));
+
+    EXPECT_TRUE(manager.cancel_order(order->order_id));
+    EXPECT_DOUBLE_EQ(manager.get_notional_exposure(), 101.0);  // The filled lot
+    EXPECT_FALSE(manager.amend_order(order->order_id, 100.0, 2.0));
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/slot_pool.h>
+#include <cstdint>
+#include <vector>
+
+TEST(SlotPoolTest, SlotsAreCacheLineAligned) {
+    SlotPool<int64_t> pool(4);
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    const auto pa = reinterpret_cast<uintptr_t>(pool.get(a));
+    const auto pb = reinterpret_cast<uintptr_t>(pool.get(b));
+
+    EXPECT_EQ(pa % CACHE_LINE_SIZE, 0u);
+    EXPECT_EQ(pb % CACHE_LINE_SIZE, 0u);
+    EXPECT_NE(pa / CACHE_LINE_SIZE, pb / CACHE_LINE_SIZE);
+}
+
+TEST(SlotPoolTest, ExhaustsAndRecycles) {
+    SlotPool<int> pool(3);
+    std::vector<PoolHandle> handles;
+    for (int i = 0; i < 3; ++i) {
+        handles.push_back(pool.acquire());
+        ASSERT_TRUE(handles.back().valid());
+    }
+    EXPECT_TRUE(pool.full());
+    EXPECT_FALSE(pool.acquire().valid());
+
+    EXPECT_TRUE(pool.release(handles[1]));
+    auto reused = pool.acquire();
+    EXPECT_EQ(reused.index, handles[1].index);
+    EXPECT_NE(reused.generation, handles[1].generation);
+}
+
+TEST(SlotPoolTest, StaleHandlesAreRejected) {
+    SlotPool<int> pool(1);
+    auto first = pool.acquire();
+    *pool.get(first) = 7;
+    ASSERT_TRUE(pool.release(first));
+
+    EXPECT_EQ(pool.get(first), nullptr);
+    EXPECT_FALSE(pool.release(first));  // Double release
+
+    auto second = pool.acquire();
+    EXPECT_EQ(second.index, first.index);
+    EXPECT_EQ(pool.get(first), nullptr);
+    EXPECT_FALSE(pool.release(first));
+    EXPECT_NE(pool.get(second), nullptr);
+    EXPECT_EQ(pool.size(), 1u);
+
+    EXPECT_EQ(PoolHandle::unpack(second.pack()), second);
+    EXPECT_EQ(pool.get(PoolHandle{}), nullptr);
+}
+
+TEST(SlotPoolTest, ForEachVisitsLiveSlotsAndAllowsRelease) {
+    SlotPool<int> pool(4);
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    auto c = pool.acquire();
+    ASSERT_TRUE(pool.release(b));
+
+    std::vector<PoolHandle> seen;
+    pool.for_each([&](PoolHandle handle) {
+        seen.push_back(handle);
+        pool.release(handle);
+    });
+    EXPECT_EQ(seen, (std::vector<PoolHandle>{a, c}));
+    EXPECT_EQ(pool.size(), 0u);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/stable_ring.h>
+#include <numeric>
+#include <string>
+
+TEST(StableRingTest, EvictsOldestWhenFull) {
+    stable_ring<int, 4> ring(6);
+    for (int i = 0; i < 10; ++i) {
+        ring.push_back(i);
+    }
+    
+    ASSERT_EQ(ring.size(), 6u);
+    EXPECT_EQ(ring.front(), 4);
+    EXPECT_EQ(ring.back(), 9);
+    EXPECT_EQ(std::accumulate(ring.begin(), ring.end(), 0), 4 + 5 + 6 + 7 + 8 + 9);
+}
+
+TEST(StableRingTest, PointersStayValidUntilEviction) {
+    stable_ring<std::string, 4> ring(8);
+    ring.push_back("first");
+    const std::string* first = &ring.front();
+    
+    for (int i = 0; i < 7; ++i) {
+        ring.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(first, &ring.front());
+    EXPECT_EQ(*first, "first");
+}
+
+TEST(StableRingTest, SegmentsCoverContentsInOrder) {
+    stable_ring<int, 4> ring(10);
+    for (int i = 0; i < 23; ++i) {
+        ring.push_back(i);
+    }
+    
+    std::vector<int> seen;
+    size_t segments = 0;
+    ring.for_each_segment([&](const int* data, size_t count) {
+        seen.insert(seen.end(), data, data + count);
+        ++segments;
+    });
+    
+    std::vector<int> expected(10);
+    std::iota(expected.begin(), expected.end(), 13);
+    EXPECT_EQ(seen, expected);
+    EXPECT_GT(segments, 1u);
+}
+
+TEST(StableRingTest, PopFrontAndClear) {
+    stable_ring<std::string> ring(3);
+    ring.push_back("a");
+    ring.push_back("b");
+    ring.pop_front();
+    EXPECT_EQ(ring.front(), "b");
+    
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    ring.push_back("c");
+    EXPECT_EQ(ring.at(0), "c");
+    EXPECT_THROW(ring.at(1), std::out_of_range);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/tick_journal.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <sys/stat.h>
+
+class TickJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "test_journal.bin";
+        std::remove(path.c_str());
+        std::remove((path + ".idx").c_str());
+        
+        TickJournalWriter writer(path, "XBTUSD", 0.5);
+        std::vector<LevelUpdate> levels(MarketDepth::MAX_LEVELS);
+        for (int update = 0; update < NUM_UPDATES; ++update) {
+            for (size_t i = 0; i < levels.size(); ++i) {
+                levels[i] = {i, 100.0 + update - 0.5 * i, 1.0};
+            }
+            const int64_t ts = update * 1000;
+            writer.append_book(ts, BookSide::BID, levels.data(), levels.size(), false);
+            for (auto& level : levels) {
+                level.price += 1.0 + level.level;
+            }
+            writer.append_book(ts, BookSide::ASK, levels.data(), levels.size(), true);
+            if (update % 10 == 0) {
+                writer.append_trade(ts, BookSide::ASK, 100.0 + update, 2.0);
+            }
+        }
+    }
+    
+    static constexpr int NUM_UPDATES = 500;
+    std::string path;
+};
+
+TEST_F(TickJournalTest, HeaderRoundTrip) {
+    TickJournalReader reader(path);
+    EXPECT_STREQ(reader.header().symbol, "XBTUSD");
+    EXPECT_DOUBLE_EQ(reader.header().tick_size, 0.5);
+    EXPECT_EQ(reader.size(), NUM_UPDATES * 2 * MarketDepth::MAX_LEVELS + NUM_UPDATES / 10);
+}
+
+TEST_F(TickJournalTest, RangeSeeksByTimestamp) {
+    TickJournalReader reader(path);
+    auto range = reader.range(250 * 1000, 260 * 1000);
+    
+    ASSERT_GT(range.size(), 0u);
+    EXPECT_EQ(range.begin()->timestamp_ns, 250 * 1000);
+    EXPECT_LT((range.end() - 1)->timestamp_ns, 260 * 1000);
+    EXPECT_EQ(reader.seek(-1), 0u);
+    EXPECT_EQ(reader.seek(NUM_UPDATES * 1000), reader.size());
+}
+
+TEST_F(TickJournalTest, ReplayRebuildsBooks) {
+    TickJournalReader reader(path);
+    TickJournalReplay replay(reader.range(100 * 1000, 103 * 1000));
+    
+    MarketDepth depth;
+    int books = 0;
+    while (replay.next(depth)) {
+        EXPECT_DOUBLE_EQ(depth.bids[0].price, 200.0 + books);
+        EXPECT_DOUBLE_EQ(depth.asks[0].price, 201.0 + books);
+        ++books;
+    }
+    EXPECT_EQ(books, 3);
+}
+
+TEST_F(TickJournalTest, ReopenAppends) {
+    {
+        TickJournalWriter writer(path, "XBTUSD", 0.5);
+        writer.append_trade(NUM_UPDATES * 1000, BookSide::BID, 1.0, 1.0);
+    }
+    TickJournalReader reader(path);
+    EXPECT_EQ(reader.all().end()[-1].type, JournalRecord::TRADE);
+    EXPECT_THROW(TickJournalWriter(path, "ETHUSD", 0.05), std::runtime_error);
+}
+
+TEST_F(TickJournalTest, ForeignFileIsLeftUntouched) {
+    const std::string foreign = ::testing::TempDir() + "not_a_journal.txt";
+    std::remove((foreign + ".idx").c_str());
+    {
+        std::ofstream out(foreign, std::ios::trunc);
+        out << "some other file";
+    }
+    EXPECT_THROW(TickJournalWriter(foreign, "XBTUSD", 0.5), std::runtime_error);
+    
+    struct stat st{};
+    ASSERT_EQ(::stat(foreign.c_str(), &st), 0);
+    EXPECT_EQ(st.st_size, 15);
+    EXPECT_NE(::stat((foreign + ".idx").c_str(), &st), 0);
+    std::remove(foreign.c_str());
+}
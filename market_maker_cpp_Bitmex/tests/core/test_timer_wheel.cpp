@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <market_maker/core/timer_wheel.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr int64_t MS = 1'000'000;
+
+}  // namespace
+
+TEST(TimerWheelTest, FiresAtDeadlineTick) {
+    TimerWheel<int> wheel(8, MS, 16, 0);
+    wheel.schedule(3 * MS, 1);
+    wheel.schedule(1 * MS, 2);
+    wheel.schedule(3 * MS - MS / 2, 3);  // Rounded up to 3ms
+
+    std::vector<int> fired;
+    auto collect = [&](int&& value) { fired.push_back(value); };
+
+    EXPECT_EQ(wheel.advance(MS / 2, collect), 0u);
+    EXPECT_EQ(wheel.advance(MS, collect), 1u);
+    EXPECT_EQ(fired, std::vector<int>({2}));
+    EXPECT_EQ(wheel.advance(2 * MS, collect), 0u);
+    EXPECT_EQ(wheel.advance(3 * MS, collect), 2u);
+    EXPECT_EQ(wheel.size(), 0u);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, TimersBeyondOneRevolutionWaitTheirTurn) {
+    TimerWheel<int> wheel(4, MS, 16, 0);
+    wheel.schedule(2 * MS, 1);
+    wheel.schedule(6 * MS, 2);   // Same bucket, next revolution
+    wheel.schedule(10 * MS, 3);  // Two revolutions out
+
+    std::vector<int> fired;
+    auto collect = [&](int&& value) { fired.push_back(value); };
+    for (int64_t t = MS; t <= 10 * MS; t += MS) {
+        wheel.advance(t, collect);
+        if (t == 2 * MS) {
+            EXPECT_EQ(fired, std::vector<int>({1}));
+        }
+        if (t == 5 * MS) {
+            EXPECT_EQ(fired, std::vector<int>({1}));
+        }
+        if (t == 6 * MS) {
+            EXPECT_EQ(fired, std::vector<int>({1, 2}));
+        }
+    }
+    EXPECT_EQ(fired, std::vector<int>({1, 2, 3}));
+}
+
+TEST(TimerWheelTest, LongGapFiresEverythingOverdue) {
+    TimerWheel<int> wheel(4, MS, 64, 0);
+    for (int i = 1; i <= 20; ++i) {
+        wheel.schedule(i * MS, i);
+    }
+    std::vector<int> fired;
+    EXPECT_EQ(wheel.advance(15 * MS, [&](int&& value) { fired.push_back(value); }), 15u);
+    for (int value : fired) {
+        EXPECT_LE(value, 15);
+    }
+    EXPECT_EQ(wheel.size(), 5u);
+
+    // Past deadlines are never scheduled behind the wheel
+    wheel.schedule(0, 99);
+    std::vector<int> next;
+    EXPECT_EQ(wheel.advance(16 * MS, [&](int&& value) { next.push_back(value); }), 2u);
+    std::sort(next.begin(), next.end());
+    EXPECT_EQ(next, std::vector<int>({16, 99}));
+}
+
+TEST(TimerWheelTest, NextDeadlineSkipsEmptyTicks) {
+    TimerWheel<int> wheel(4, MS, 16, 0);
+    EXPECT_EQ(wheel.next_deadline_ns(), std::numeric_limits<int64_t>::max());
+
+    wheel.schedule(7 * MS, 1);  // Shares bucket 3 with tick 3, a revolution on
+    EXPECT_EQ(wheel.next_deadline_ns(), 7 * MS);
+    auto near = wheel.schedule(2 * MS, 2);
+    EXPECT_EQ(wheel.next_deadline_ns(), 2 * MS);
+
+    wheel.cancel(near);
+    EXPECT_EQ(wheel.next_deadline_ns(), 7 * MS);
+    EXPECT_EQ(wheel.advance(6 * MS, [](int&&) {}), 0u);
+    EXPECT_EQ(wheel.next_deadline_ns(), 7 * MS);
+}
+
+TEST(TimerWheelTest, CancelAndCapacity) {
+    TimerWheel<int> wheel(8, MS, 2, 0);
+    auto a = wheel.schedule(2 * MS, 1);
+    auto b = wheel.schedule(2 * MS, 2);
+    EXPECT_TRUE(wheel.full());
+    EXPECT_FALSE(wheel.schedule(3 * MS, 3).valid());
+
+    EXPECT_TRUE(wheel.cancel(a));
+    EXPECT_FALSE(wheel.cancel(a));
+    auto c = wheel.schedule(2 * MS, 3);
+    EXPECT_TRUE(c.valid());
+    EXPECT_NE(c, a);  // Reused slot, new generation
+
+    std::vector<int> fired;
+    wheel.advance(2 * MS, [&](int&& value) { fired.push_back(value); });
+    EXPECT_EQ(fired.size(), 2u);
+    EXPECT_FALSE(wheel.cancel(b));
+}
+
+TEST(TimerWheelTest, CallbacksMayRescheduleAndCancel) {
+    TimerWheel<int> wheel(4, MS, 16, 0);
+    TimerWheel<int>::TimerId victim;
+    wheel.schedule(1 * MS, 1);
+    victim = wheel.schedule(1 * MS, 2);  // Walked first: buckets push to the front
+    wheel.schedule(1 * MS, 3);
+
+    std::vector<int> fired;
+    wheel.advance(MS, [&](int&& value) {
+        fired.push_back(value);
+        if (value == 3) {
+            wheel.cancel(victim);
+            wheel.schedule(0, 4);  // Lands on the next tick, not this one
+        }
+    });
+    EXPECT_EQ(fired, std::vector<int>({3, 1}));
+
+    wheel.advance(2 * MS, [&](int&& value) { fired.push_back(value); });
+    EXPECT_EQ(fired, std::vector<int>({3, 1, 4}));
+}
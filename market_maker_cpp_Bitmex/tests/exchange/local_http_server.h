@@ -0,0 +1,159 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cctype>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal keep-alive HTTP/1.1 stand-in: records every request and answers
+// with a fixed status, body and extra headers
+class LocalHttpServer {
+public:
+    struct Request {
+        std::string method;
+        std::string path;
+        std::map<std::string, std::string> headers;
+        std::string body;
+    };
+
+    LocalHttpServer() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 8);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~LocalHttpServer() {
+        stop_ = true;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        acceptor_.join();
+        for (auto& t : connections_) {
+            t.join();
+        }
+    }
+
+    std::string base_url() const {
+        return "http://127.0.0.1:" + std::to_string(port_) + "/api/v1";
+    }
+
+    void respond_with(int status, std::string body,
+                      std::map<std::string, std::string> headers = {}) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_ = status;
+        response_body_ = std::move(body);
+        response_headers_ = std::move(headers);
+    }
+
+    std::vector<Request> requests() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+    int connections_accepted() const { return accepted_.load(); }
+
+private:
+    void accept_loop() {
+        while (!stop_) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            ++accepted_;
+            connections_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                buffer.append(chunk, n);
+            }
+
+            Request request;
+            std::string head = buffer.substr(0, header_end);
+            size_t line_end = head.find("\r\n");
+            std::string request_line = head.substr(0, line_end);
+            size_t sp1 = request_line.find(' ');
+            size_t sp2 = request_line.find(' ', sp1 + 1);
+            request.method = request_line.substr(0, sp1);
+            request.path = request_line.substr(sp1 + 1, sp2 - sp1 - 1);
+
+            size_t pos = line_end + 2;
+            while (pos < head.size()) {
+                size_t end = head.find("\r\n", pos);
+                if (end == std::string::npos) end = head.size();
+                std::string line = head.substr(pos, end - pos);
+                size_t colon = line.find(':');
+                std::string name = line.substr(0, colon);
+                for (auto& c : name) c = static_cast<char>(std::tolower(c));
+                request.headers[name] = line.substr(line.find_first_not_of(' ', colon + 1));
+                pos = end + 2;
+            }
+
+            size_t content_length = request.headers.count("content-length")
+                ? std::stoul(request.headers["content-length"]) : 0;
+            while (buffer.size() < header_end + 4 + content_length) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                buffer.append(chunk, n);
+            }
+            request.body = buffer.substr(header_end + 4, content_length);
+            buffer.erase(0, header_end + 4 + content_length);
+
+            std::string response;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                requests_.push_back(request);
+                response = "HTTP/1.1 " + std::to_string(status_) + " X\r\n";
+                for (const auto& [name, value] : response_headers_) {
+                    response += name + ": " + value + "\r\n";
+                }
+                response += "Content-Type: application/json\r\n"
+                           "Content-Length: " + std::to_string(response_body_.size()) + "\r\n"
+                           "Connection: keep-alive\r\n\r\n" + response_body_;
+            }
+            ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+    }
+
+    int listen_fd_{-1};
+    uint16_t port_{0};
+    std::atomic<bool> stop_{false};
+    std::atomic<int> accepted_{0};
+    std::thread acceptor_;
+    std::vector<std::thread> connections_;
+
+    std::mutex mutex_;
+    int status_{200};
+    std::string response_body_{"[]"};
+    std::map<std::string, std::string> response_headers_;
+    std::vector<Request> requests_;
+};
+
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <market_maker/risk/order_manager.h>
+#include <memory>
+
+// Orders and order managers shared by the exchange, strategy and risk tests
+
+inline Order make_order(int64_t id, OrderSide side, double price, double quantity = 1) {
+    Order order{};
+    order.order_id = id;
+    order.side = side;
+    order.price = price;
+    order.quantity = quantity;
+    return order;
+}
+
+// Limits loose enough that only the checks a test sets up can refuse
+inline std::shared_ptr<OrderManager> make_order_manager() {
+    OrderManager::Config config;
+    config.max_position = 1000.0;
+    config.max_order_size = 100.0;
+    config.max_notional = 1e9;
+    config.max_active_orders = 64;
+    return std::make_shared<OrderManager>(config);
+}
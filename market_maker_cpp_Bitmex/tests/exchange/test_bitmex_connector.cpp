@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <market_maker/exchange/bitmex_connector.h>
+#include <nlohmann/json.hpp>
+#include "local_http_server.h"
+#include "order_fixtures.h"
+#include <set>
+#include <string>
+
+namespace {
+
+BitMEXConnector::Config connector_config(const LocalHttpServer& server) {
+    BitMEXConnector::Config config;
+    config.base_url = server.base_url();
+    config.symbol = "XBTUSD";
+    config.api_key = "key";
+    config.api_secret = "secret";
+    return config;
+}
+
+}  // namespace
+
+TEST(BitMEXConnectorTest, PlacesOrdersInOneBulkRequest) {
+    LocalHttpServer server;
+    BitMEXConnector connector(connector_config(server));
+
+    const Order orders[] = {
+        make_order(1, OrderSide::BUY, 9999.5, 100),
+        make_order(2, OrderSide::SELL, 10000.5, 100),
+    };
+    ASSERT_TRUE(connector.place_orders(orders, 2));
+
+    auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].method, "POST");
+    EXPECT_EQ(requests[0].path, "/api/v1/order/bulk");
+
+    const auto body = nlohmann::json::parse(requests[0].body);
+    ASSERT_EQ(body["orders"].size(), 2u);
+    EXPECT_EQ(body["orders"][0]["clOrdID"], "mm_bitmex_1");
+    EXPECT_EQ(body["orders"][0]["side"], "Buy");
+    EXPECT_EQ(body["orders"][1]["clOrdID"], "mm_bitmex_2");
+    EXPECT_EQ(body["orders"][1]["symbol"], "XBTUSD");
+}
+
+TEST(BitMEXConnectorTest, AmendsAndCancelsInBulk) {
+    LocalHttpServer server;
+    BitMEXConnector connector(connector_config(server));
+
+    const Order amends[] = {
+        make_order(1, OrderSide::BUY, 9998.0, 50),
+        make_order(2, OrderSide::SELL, 10001.0, 50),
+    };
+    ASSERT_TRUE(connector.amend_orders(amends, 2));
+    const int64_t cancels[] = {3, 4, 5};
+    ASSERT_TRUE(connector.cancel_orders(cancels, 3));
+
+    auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[0].method, "PUT");
+    EXPECT_EQ(requests[0].path, "/api/v1/order/bulk");
+    const auto amend_body = nlohmann::json::parse(requests[0].body);
+    ASSERT_EQ(amend_body["orders"].size(), 2u);
+    EXPECT_EQ(amend_body["orders"][1]["origClOrdID"], "mm_bitmex_2");
+    EXPECT_EQ(amend_body["orders"][1]["price"], 10001.0);
+
+    EXPECT_EQ(requests[1].method, "DELETE");
+    EXPECT_EQ(requests[1].path, "/api/v1/order");
+    EXPECT_EQ(nlohmann::json::parse(requests[1].body)["clOrdID"],
+              nlohmann::json({"mm_bitmex_3", "mm_bitmex_4", "mm_bitmex_5"}));
+}
+
+TEST(BitMEXConnectorTest, BatchSendsOneRequestPerActionKind) {
+    LocalHttpServer server;
+    BitMEXConnector connector(connector_config(server));
+
+    OrderBatch batch;
+    EXPECT_TRUE(connector.send_batch(batch).ok());
+    EXPECT_TRUE(server.requests().empty());
+
+    batch.places.push_back(make_order(10, OrderSide::BUY, 9999.0, 10));
+    batch.places.push_back(make_order(11, OrderSide::SELL, 10001.0, 10));
+    batch.cancels.push_back(7);
+    ASSERT_TRUE(connector.send_batch(batch).ok());
+
+    // Sent together, so in either order
+    auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 2u);
+    std::multiset<std::string> methods{requests[0].method, requests[1].method};
+    EXPECT_EQ(methods, (std::multiset<std::string>{"DELETE", "POST"}));
+
+    // Each stage reports on its own; an empty one counts as accepted
+    server.respond_with(503, R"({"error":{"message":"overloaded"}})");
+    const BatchResult failed = connector.send_batch(batch);
+    EXPECT_FALSE(failed.cancels);
+    EXPECT_TRUE(failed.amends);
+    EXPECT_FALSE(failed.places);
+    EXPECT_EQ(server.requests().size(), 4u);
+}
+
+TEST(BitMEXConnectorTest, ServerBudgetHoldsBackNewOrdersBeforeCancels) {
+    LocalHttpServer server;
+    // Fewer requests left than the default cancel reserve
+    server.respond_with(200, "[]", {{"x-ratelimit-remaining", "20"}});
+    BitMEXConnector connector(connector_config(server));
+
+    ASSERT_TRUE(connector.place_order(make_order(1, OrderSide::BUY, 9999.5, 100)));
+    EXPECT_EQ(connector.rate_limiter().available(RateLimiter::Priority::NORMAL), 0);
+
+    // Refused locally, never sent
+    EXPECT_FALSE(connector.place_order(make_order(2, OrderSide::BUY, 9999.0, 100)));
+    EXPECT_EQ(server.requests().size(), 1u);
+
+    EXPECT_TRUE(connector.cancel_order(1));
+    auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[1].method, "DELETE");
+}
+
+TEST(BitMEXConnectorTest, RetryAfterStopsAllRequests) {
+    LocalHttpServer server;
+    server.respond_with(429, R"({"error":{"message":"Rate limit exceeded"}})",
+                        {{"Retry-After", "30"}});
+    BitMEXConnector connector(connector_config(server));
+
+    EXPECT_FALSE(connector.place_order(make_order(1, OrderSide::BUY, 9999.5, 100)));
+    EXPECT_FALSE(connector.cancel_order(1));
+    EXPECT_EQ(server.requests().size(), 1u);
+}
+
+TEST(BitMEXConnectorTest, LooksUpAnOrderByClOrdId) {
+    LocalHttpServer server;
+    BitMEXConnector connector(connector_config(server));
+
+    server.respond_with(200, R"([{"clOrdID":"mm_bitmex_7","ordStatus":"New"}])");
+    EXPECT_EQ(connector.has_order(7), std::optional<bool>(true));
+    auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].method, "GET");
+    EXPECT_NE(requests[0].path.find("mm_bitmex_7"), std::string::npos);
+
+    server.respond_with(200, "[]");
+    EXPECT_EQ(connector.has_order(7), std::optional<bool>(false));
+
+    // Not knowing is not the same as not there
+    server.respond_with(502, R"({"error":{"message":"Bad gateway"}})");
+    EXPECT_EQ(connector.has_order(7), std::nullopt);
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <market_maker/backtest/local_bitmex_exchange.h>
+#include <market_maker/exchange/bitmex_execution_manager.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "local_http_server.h"
+#include "order_fixtures.h"
+
+using std::chrono::milliseconds;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::shared_ptr<BitMEXConnector> make_connector(const std::string& base_url) {
+    BitMEXConnector::Config config;
+    config.base_url = base_url;
+    config.symbol = "XBTUSD";
+    config.api_key = "key";
+    config.api_secret = "secret";
+    return std::make_shared<BitMEXConnector>(config);
+}
+
+BitMEXExecutionManager::ExecutionConfig fast_retries() {
+    BitMEXExecutionManager::ExecutionConfig config;
+    config.retry_delay = milliseconds(50);
+    config.retry_jitter = 0.0;
+    return config;
+}
+
+void wait_for_requests(LocalHttpServer& server, size_t count) {
+    for (int i = 0; i < 500 && server.requests().size() < count; ++i) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+}  // namespace
+
+TEST(BitMEXExecutionManagerTest, RetryBackoffDoublesUpToCap) {
+    BitMEXExecutionManager::ExecutionConfig config;
+    config.retry_delay = milliseconds(100);
+    config.max_retry_delay = milliseconds(1000);
+    config.retry_jitter = 0.0;
+
+    EXPECT_EQ(config.retry_backoff(1, 0.7), milliseconds(100));
+    EXPECT_EQ(config.retry_backoff(2, 0.7), milliseconds(200));
+    EXPECT_EQ(config.retry_backoff(4, 0.7), milliseconds(800));
+    EXPECT_EQ(config.retry_backoff(5, 0.7), milliseconds(1000));
+    EXPECT_EQ(config.retry_backoff(60, 0.7), milliseconds(1000));
+}
+
+TEST(BitMEXExecutionManagerTest, RetryBackoffJitterStaysInBand) {
+    BitMEXExecutionManager::ExecutionConfig config;
+    config.retry_delay = milliseconds(100);
+    config.retry_jitter = 0.5;
+
+    // The last half of the delay is randomised
+    EXPECT_EQ(config.retry_backoff(3, 0.0), milliseconds(200));
+    EXPECT_EQ(config.retry_backoff(3, 0.5), milliseconds(300));
+    EXPECT_LT(config.retry_backoff(3, 0.999), milliseconds(400));
+}
+
+TEST(BitMEXExecutionManagerTest, PositionLimitCountsTheFilledPosition) {
+    LocalHttpServer server;
+    auto order_manager = make_order_manager();
+    auto config = fast_retries();
+    config.max_position_value = 50000.0;
+    BitMEXExecutionManager manager(make_connector(server.base_url()), order_manager, config);
+
+    EXPECT_TRUE(manager.check_risk_limits(make_order(1, OrderSide::BUY, 9000.0)));
+    order_manager->apply_untracked_fill(OrderSide::BUY, 5.0, 9000.0);
+    // Long 5, another lot would be 54000 of exposure; selling one reduces it
+    EXPECT_FALSE(manager.check_risk_limits(make_order(2, OrderSide::BUY, 9000.0)));
+    EXPECT_TRUE(manager.check_risk_limits(make_order(3, OrderSide::SELL, 9000.0)));
+    EXPECT_TRUE(server.requests().empty());
+}
+
+TEST(BitMEXExecutionManagerTest, SyncSubmitFailsFastWhenOverloaded) {
+    LocalHttpServer server;
+    server.respond_with(503, R"({"error":{"message":"overloaded"}})");
+    auto config = fast_retries();
+    config.retry_delay = milliseconds(5000);
+    BitMEXExecutionManager manager(make_connector(server.base_url()), make_order_manager(), config);
+
+    const auto start = std::chrono::steady_clock::now();
+    Order order = make_order(4, OrderSide::BUY, 9000.0);
+    EXPECT_FALSE(manager.submit_order(order));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+    EXPECT_EQ(server.requests().size(), 1u);
+    EXPECT_FALSE(manager.get_order_status(4).has_value());
+}
+
+TEST(BitMEXExecutionManagerTest, AsyncSubmitRetriesAnOverloadedPlace) {
+    LocalBitMEXExchange exchange(LocalBitMEXExchange::Config{});
+    exchange.start();
+    exchange.inject_overload(1);
+    auto connector = make_connector(exchange.rest_url());
+    BitMEXExecutionManager manager(connector, make_order_manager(), fast_retries());
+
+    auto accepted = manager.submit_order_async(make_order(1, OrderSide::BUY, 9000.0));
+    ASSERT_EQ(accepted.wait_for(5s), std::future_status::ready);
+    EXPECT_TRUE(accepted.get());
+
+    // The 503 was not acted on, so the order was simply placed again
+    EXPECT_EQ(exchange.requests(), 2u);
+    EXPECT_EQ(exchange.open_orders(), 1u);
+    EXPECT_TRUE(manager.get_order_status(1).has_value());
+}
+
+TEST(BitMEXExecutionManagerTest, AsyncSubmitLooksUpAnOrderInDoubt) {
+    LocalHttpServer server;
+    server.respond_with(500, R"({"error":{"message":"Internal error"}})");
+    auto connector = make_connector(server.base_url());
+    BitMEXExecutionManager manager(connector, make_order_manager(), fast_retries());
+
+    auto accepted = manager.submit_order_async(make_order(7, OrderSide::BUY, 9000.0));
+    wait_for_requests(server, 1);
+    // The place did go through; the exchange now lists it
+    server.respond_with(200, R"([{"clOrdID":"mm_bitmex_7","ordStatus":"New"}])");
+    ASSERT_EQ(accepted.wait_for(5s), std::future_status::ready);
+    EXPECT_TRUE(accepted.get());
+
+    const auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[0].method, "POST");
+    EXPECT_EQ(requests[1].method, "GET");
+    EXPECT_EQ(requests[1].path.rfind("/api/v1/order?", 0), 0u);
+}
+
+TEST(BitMEXExecutionManagerTest, AsyncSubmitDoesNotRetryARefusal) {
+    LocalHttpServer server;
+    server.respond_with(400, R"({"error":{"message":"Invalid price"}})");
+    auto connector = make_connector(server.base_url());
+    BitMEXExecutionManager manager(connector, make_order_manager(), fast_retries());
+
+    Order reported{};
+    bool reported_accepted = true;
+    std::promise<void> done;
+    manager.submit_order_async(make_order(3, OrderSide::SELL, 9000.0),
+                               [&](const Order& order, bool accepted) {
+                                   reported = order;
+                                   reported_accepted = accepted;
+                                   done.set_value();
+                               });
+    ASSERT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_FALSE(reported_accepted);
+    EXPECT_EQ(reported.order_id, 3);
+    EXPECT_EQ(server.requests().size(), 1u);
+    EXPECT_FALSE(manager.get_order_status(3).has_value());
+}
+
+TEST(BitMEXExecutionManagerTest, SlowRepliesDoNotQueueBehindEachOther) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = 100ms;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    auto connector = make_connector(exchange.rest_url());
+    BitMEXExecutionManager manager(connector, make_order_manager(), fast_retries());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<bool>> accepted;
+    for (int64_t id = 1; id <= 4; ++id) {
+        accepted.push_back(manager.submit_order_async(
+            make_order(id, id % 2 == 0 ? OrderSide::SELL : OrderSide::BUY,
+                       id % 2 == 0 ? 9500.0 : 9000.0)));
+    }
+    for (auto& future : accepted) {
+        ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+        EXPECT_TRUE(future.get());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 300ms);  // Serially this is 400ms
+    EXPECT_EQ(exchange.open_orders(), 4u);
+}
+
+TEST(BitMEXExecutionManagerTest, ParkedRetriesFailAtShutdown) {
+    LocalHttpServer server;
+    server.respond_with(503, R"({"error":{"message":"overloaded"}})");
+    auto connector = make_connector(server.base_url());
+    auto config = fast_retries();
+    config.retry_delay = milliseconds(5000);
+    auto manager = std::make_unique<BitMEXExecutionManager>(connector, make_order_manager(), config);
+
+    auto accepted = manager->submit_order_async(make_order(5, OrderSide::BUY, 9000.0));
+    wait_for_requests(server, 1);
+    std::this_thread::sleep_for(20ms);  // Let the reply park the retry
+    manager.reset();
+
+    ASSERT_EQ(accepted.wait_for(1s), std::future_status::ready);
+    EXPECT_FALSE(accepted.get());
+    EXPECT_EQ(server.requests().size(), 1u);
+}
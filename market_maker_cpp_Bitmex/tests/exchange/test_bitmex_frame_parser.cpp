@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <market_maker/exchange/bitmex_frame_parser.h>
+#include <string>
+#include <vector>
+
+TEST(BitMEXFrameParserTest, ParsesOrderBookL2Frame) {
+    const std::string text = R"({"table":"orderBookL2","action":"update","data":[
+        {"symbol":"XBTUSD","id":8799000000,"side":"Sell","size":150,"price":10000.5},
+        {"symbol":"XBTUSD","id":8799000100,"side":"Buy","size":75}]})";
+
+    bitmex_frame::Frame frame;
+    ASSERT_TRUE(bitmex_frame::parse_frame(text, frame));
+    EXPECT_EQ(frame.table, bitmex_frame::Table::ORDER_BOOK_L2);
+    EXPECT_EQ(frame.action, L2OrderBook::Action::UPDATE);
+
+    L2OrderBook book;
+    std::vector<L2OrderBook::Entry> entries;
+    ASSERT_TRUE(bitmex_frame::parse_l2(frame.data, book, entries));
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].id, 8799000000);
+    EXPECT_EQ(entries[0].side, BookSide::ASK);
+    EXPECT_EQ(entries[0].price, book.make_entry(0, BookSide::ASK, 10000.5, 0).price);
+    EXPECT_EQ(entries[0].size.raw(), 150);
+    EXPECT_EQ(entries[1].side, BookSide::BID);
+    EXPECT_EQ(entries[1].price.raw(), 0);  // Updates may omit price
+}
+
+TEST(BitMEXFrameParserTest, KeyOrderAndUnknownFieldsDoNotMatter) {
+    const std::string text = R"({"data":[{"id":1,"side":"Buy","size":5,"price":100,
+        "extra":{"nested":["]}",{"x":[1,2]}]}}],
+        "keys":["symbol","id","side"],"types":{"id":"long"},
+        "action":"partial","filter":{"symbol":"XBTUSD"},"table":"orderBookL2"})";
+
+    bitmex_frame::Frame frame;
+    ASSERT_TRUE(bitmex_frame::parse_frame(text, frame));
+    EXPECT_EQ(frame.table, bitmex_frame::Table::ORDER_BOOK_L2);
+    EXPECT_EQ(frame.action, L2OrderBook::Action::PARTIAL);
+
+    L2OrderBook book;
+    std::vector<L2OrderBook::Entry> entries;
+    ASSERT_TRUE(bitmex_frame::parse_l2(frame.data, book, entries));
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].size.raw(), 5);
+}
+
+TEST(BitMEXFrameParserTest, ControlFramesHaveNoTable) {
+    bitmex_frame::Frame frame;
+    ASSERT_TRUE(bitmex_frame::parse_frame(
+        R"({"success":true,"subscribe":"orderBookL2:XBTUSD","request":{"op":"subscribe"}})", frame));
+    EXPECT_EQ(frame.table, bitmex_frame::Table::NONE);
+
+    ASSERT_TRUE(bitmex_frame::parse_frame(R"({"table":"instrument","action":"update","data":[]})", frame));
+    EXPECT_EQ(frame.table, bitmex_frame::Table::OTHER);
+
+    EXPECT_FALSE(bitmex_frame::parse_frame(R"({"table":"orderBookL2","data":[)", frame));
+    EXPECT_FALSE(bitmex_frame::parse_frame("pong", frame));
+}
+
+TEST(BitMEXFrameParserTest, EscapeCutAtTheEndIsRejected) {
+    bitmex_frame::Frame frame;
+    ASSERT_TRUE(bitmex_frame::parse_frame(R"({"table":"instrument","note":"a\"b","data":[]})", frame));
+
+    // A frame cut straight after a backslash
+    const std::string text = R"({"table":"orderBookL2","note":"ab\)";
+    EXPECT_FALSE(bitmex_frame::parse_frame(text, frame));
+
+    std::string_view out;
+    bitmex_frame::detail::Cursor cursor(std::string_view(text).substr(30));
+    EXPECT_FALSE(cursor.string(out));
+    EXPECT_LE(cursor.position(), text.data() + text.size());
+}
+
+TEST(BitMEXFrameParserTest, ParsesExecutionRows) {
+    const std::string text = R"({"table":"execution","action":"insert","data":[
+        {"execID":"0193e879-cb6c-2642-ef6d-ce8d5e4a0ef4","orderID":"00000000-0000-0000-0000-000000000001",
+         "clOrdID":"mm_bitmex_42","symbol":"XBTUSD","side":"Buy","lastQty":30,"lastPx":9999.5,
+         "price":10000,"execType":"Trade","ordStatus":"PartiallyFilled","cumQty":30,"leavesQty":70,
+         "text":"Submitted via API.\n\"quoted\""},
+        {"execID":"b","clOrdID":null,"execType":"Canceled","lastQty":null,"lastPx":null,"leavesQty":null}]})";
+
+    bitmex_frame::Frame frame;
+    ASSERT_TRUE(bitmex_frame::parse_frame(text, frame));
+    ASSERT_EQ(frame.table, bitmex_frame::Table::EXECUTION);
+
+    std::vector<bitmex_frame::ExecutionRow> rows;
+    std::vector<std::string> exec_ids;
+    ASSERT_TRUE(bitmex_frame::for_each_execution(frame.data, [&](const bitmex_frame::ExecutionRow& row) {
+        rows.push_back(row);
+        exec_ids.emplace_back(row.exec_id);
+    }));
+
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(exec_ids[0], "0193e879-cb6c-2642-ef6d-ce8d5e4a0ef4");
+    EXPECT_EQ(rows[0].cl_ord_id, "mm_bitmex_42");
+    EXPECT_EQ(rows[0].side, "Buy");
+    EXPECT_DOUBLE_EQ(rows[0].last_px, 9999.5);
+    EXPECT_DOUBLE_EQ(rows[0].last_qty, 30.0);
+    EXPECT_DOUBLE_EQ(rows[0].leaves_qty, 70.0);
+    EXPECT_TRUE(rows[0].has_leaves_qty);
+    EXPECT_EQ(rows[0].ord_status, "PartiallyFilled");
+    EXPECT_EQ(rows[1].exec_type, "Canceled");
+    EXPECT_FALSE(rows[1].has_leaves_qty);  // null is not an explicit zero
+    EXPECT_TRUE(rows[1].cl_ord_id.empty());
+    EXPECT_DOUBLE_EQ(rows[1].last_qty, 0.0);
+}
+
+TEST(BitMEXFrameParserTest, ParsesTradeRows) {
+    const std::string text = R"({"table":"trade","action":"insert","data":[
+        {"timestamp":"2024-01-01T00:00:00.000Z","symbol":"XBTUSD","side":"Sell","size":200,
+         "price":42000.5,"tickDirection":"MinusTick","trdMatchID":"x","grossValue":476184}]})";
+
+    bitmex_frame::Frame frame;
+    ASSERT_TRUE(bitmex_frame::parse_frame(text, frame));
+    ASSERT_EQ(frame.table, bitmex_frame::Table::TRADE);
+
+    std::vector<bitmex_frame::TradeRow> rows;
+    ASSERT_TRUE(bitmex_frame::for_each_trade(frame.data, [&](const bitmex_frame::TradeRow& row) {
+        rows.push_back(row);
+    }));
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].side, "Sell");
+    EXPECT_DOUBLE_EQ(rows[0].price, 42000.5);
+    EXPECT_DOUBLE_EQ(rows[0].size, 200.0);
+}
+
+TEST(BitMEXFrameParserTest, ReusedStorageDoesNotGrow) {
+    const std::string text = R"({"table":"orderBookL2","action":"update","data":[
+        {"id":1,"side":"Buy","size":1,"price":100},{"id":2,"side":"Sell","size":2,"price":101}]})";
+
+    L2OrderBook book;
+    std::vector<L2OrderBook::Entry> entries;
+    entries.reserve(16);
+    const auto* storage = entries.data();
+
+    for (int i = 0; i < 1000; ++i) {
+        bitmex_frame::Frame frame;
+        entries.clear();
+        ASSERT_TRUE(bitmex_frame::parse_frame(text, frame));
+        ASSERT_TRUE(bitmex_frame::parse_l2(frame.data, book, entries));
+    }
+    EXPECT_EQ(entries.data(), storage);
+    EXPECT_EQ(entries.size(), 2u);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <market_maker/exchange/bitmex_rest_client.h>
+#include "local_http_server.h"
+#include <string>
+
+// Reference vectors from the BitMEX API key documentation
+TEST(BitMEXAuthTest, SignatureMatchesReferenceVectors) {
+    const std::string secret = "chNOOS4KvNXR_Xq4k4c9qsfoKWvnDecLATCRlcBwyKDYnWgO";
+
+    EXPECT_EQ(bitmex_auth::sign(secret, "GET", "/api/v1/instrument", 1518064236, ""),
+              "c7682d435d0cfe87c16098df34ef2eb5a549d4c5a3c2b1f0f77b8af73423bf00");
+
+    EXPECT_EQ(bitmex_auth::sign(secret, "GET",
+                  "/api/v1/instrument?filter=%7B%22symbol%22%3A+%22XBTM15%22%7D",
+                  1518064237, ""),
+              "e2f422547eecb5b3cb29ade2127e21b858b235b386bfa45e1c1756eb3383919f");
+
+    EXPECT_EQ(bitmex_auth::sign(secret, "POST", "/api/v1/order", 1518064238,
+                  "{\"symbol\":\"XBTM15\",\"price\":219.0,"
+                  "\"clOrdID\":\"mm_bitmex_1a/oemUeQ4CAJZgP3fjHsA\",\"orderQty\":98}"),
+              "1749cd2ccae4aa49048ae09f0b95110cee706e0944e6a14ad0b3a8cb45bd336b");
+}
+
+TEST(BitMEXAuthTest, PrefixSignerMatchesSign) {
+    const std::string secret = "chNOOS4KvNXR_Xq4k4c9qsfoKWvnDecLATCRlcBwyKDYnWgO";
+    const std::string body =
+        "{\"symbol\":\"XBTM15\",\"price\":219.0,"
+        "\"clOrdID\":\"mm_bitmex_1a/oemUeQ4CAJZgP3fjHsA\",\"orderQty\":98}";
+    bitmex_auth::PrefixSigner signer(secret, "POST", "/api/v1/order");
+    char signature[bitmex_auth::PrefixSigner::SIGNATURE_SIZE];
+
+    // Repeated use starts from the same keyed prefix
+    for (int i = 0; i < 2; ++i) {
+        signer.sign(1518064238, body, signature);
+        EXPECT_EQ(std::string(signature, sizeof(signature)),
+                  "1749cd2ccae4aa49048ae09f0b95110cee706e0944e6a14ad0b3a8cb45bd336b");
+    }
+
+    // Secrets longer than a SHA-256 block are hashed first, as in HMAC
+    const std::string long_secret(100, 'k');
+    bitmex_auth::PrefixSigner long_signer(long_secret, "DELETE", "/api/v1/order");
+    long_signer.sign(42, "{}", signature);
+    EXPECT_EQ(std::string(signature, sizeof(signature)),
+              bitmex_auth::sign(long_secret, "DELETE", "/api/v1/order", 42, "{}"));
+}
+
+TEST(BitMEXRestClientTest, SignsEveryRequest) {
+    LocalHttpServer server;
+    BitMEXRestClient client({server.base_url(), "key", "secret"});
+
+    const std::string body = R"({"symbol":"XBTUSD","orderQty":1})";
+    auto response = client.post("/order", body);
+    ASSERT_TRUE(response.ok()) << response.error;
+    EXPECT_EQ(response.body, "[]");
+
+    auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 1u);
+    const auto& request = requests[0];
+    EXPECT_EQ(request.method, "POST");
+    EXPECT_EQ(request.path, "/api/v1/order");
+    EXPECT_EQ(request.body, body);
+    EXPECT_EQ(request.headers.at("api-key"), "key");
+
+    const int64_t expires = std::stoll(request.headers.at("api-expires"));
+    EXPECT_EQ(request.headers.at("api-signature"),
+              bitmex_auth::sign("secret", "POST", "/api/v1/order", expires, body));
+}
+
+TEST(BitMEXRestClientTest, ReusesOneConnection) {
+    LocalHttpServer server;
+    BitMEXRestClient client({server.base_url(), "key", "secret"});
+
+    ASSERT_TRUE(client.get("/orderBook/L2", "symbol=XBTUSD&depth=25").ok());
+    ASSERT_TRUE(client.post("/order", "{}").ok());
+    ASSERT_TRUE(client.put("/order", "{}").ok());
+    ASSERT_TRUE(client.del("/order", "{}").ok());
+    ASSERT_TRUE(client.get("/position").ok());
+
+    auto requests = server.requests();
+    ASSERT_EQ(requests.size(), 5u);
+    EXPECT_EQ(requests[0].method, "GET");
+    EXPECT_EQ(requests[0].path, "/api/v1/orderBook/L2?symbol=XBTUSD&depth=25");
+    EXPECT_TRUE(requests[0].body.empty());
+    EXPECT_EQ(requests[2].method, "PUT");
+    EXPECT_EQ(requests[3].method, "DELETE");
+    EXPECT_EQ(requests[3].body, "{}");
+    EXPECT_EQ(requests[4].method, "GET");
+    EXPECT_EQ(server.connections_accepted(), 1);
+
+    // Query is part of the signed path
+    const int64_t expires = std::stoll(requests[0].headers.at("api-expires"));
+    EXPECT_EQ(requests[0].headers.at("api-signature"),
+              bitmex_auth::sign("secret", "GET", "/api/v1/orderBook/L2?symbol=XBTUSD&depth=25",
+                                expires, ""));
+}
+
+TEST(BitMEXRestClientTest, ReportsHttpErrors) {
+    LocalHttpServer server;
+    server.respond_with(400, R"({"error":{"message":"Invalid orderQty"}})");
+    BitMEXRestClient client({server.base_url(), "key", "secret"});
+
+    auto response = client.post("/order", "{}");
+    EXPECT_FALSE(response.ok());
+    EXPECT_EQ(response.status, 400);
+    EXPECT_NE(response.body.find("Invalid orderQty"), std::string::npos);
+    EXPECT_FALSE(response.retry_safe());
+
+    server.respond_with(503, R"({"error":{"message":"The system is currently overloaded."}})");
+    EXPECT_TRUE(client.post("/order", "{}").retry_safe());
+    server.respond_with(502, "Bad Gateway");
+    EXPECT_FALSE(client.post("/order", "{}").retry_safe());
+}
+
+TEST(BitMEXRestClientTest, ReportsTransportErrors) {
+    BitMEXRestClient client({"http://127.0.0.1:1/api/v1", "key", "secret", 1});
+    auto response = client.get("/order");
+    EXPECT_EQ(response.status, 0);
+    EXPECT_FALSE(response.error.empty());
+    // Refused connection: nothing went out, so a resend is safe
+    EXPECT_TRUE(response.retry_safe());
+}
+
+TEST(BitMEXRestClientTest, CapturesRateLimitHeaders) {
+    LocalHttpServer server;
+    server.respond_with(429, R"({"error":{"message":"Rate limit exceeded"}})",
+                        {{"X-RateLimit-Remaining", "0"},
+                         {"x-ratelimit-remaining-1s", "3"},
+                         {"X-RateLimit-Reset", "1700000060"},
+                         {"Retry-After", "12"}});
+    BitMEXRestClient client({server.base_url(), "key", "secret"});
+
+    auto response = client.post("/order", "{}");
+    EXPECT_EQ(response.status, 429);
+    EXPECT_EQ(response.ratelimit_remaining, 0);
+    EXPECT_EQ(response.ratelimit_remaining_1s, 3);
+    EXPECT_EQ(response.ratelimit_reset, 1700000060);
+    EXPECT_EQ(response.retry_after, 12);
+
+    server.respond_with(200, "[]");
+    response = client.get("/order");
+    EXPECT_EQ(response.ratelimit_remaining, -1);
+    EXPECT_EQ(response.retry_after, -1);
+}
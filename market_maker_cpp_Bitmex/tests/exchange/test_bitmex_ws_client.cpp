@@ -0,0 +1,395 @@
+#include <gtest/gtest.h>
+#include <market_maker/exchange/bitmex_ws_client.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include <sys/socket.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = net::ssl;
+using tcp = net::ip::tcp;
+
+namespace {
+
+// Accepts one connection at a time, records what the client sends and pushes
+// a canned frame after each subscribe; drop_after closes the socket once
+// that many frames were pushed so reconnects can be exercised, and silent_for
+// stops the first connection reading (so answering no pings) after its push
+class LocalWsServer {
+public:
+    explicit LocalWsServer(int drop_after = -1,
+                           std::chrono::milliseconds silent_for = std::chrono::milliseconds(0))
+        : acceptor_(ioc_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0))
+        , drop_after_(drop_after)
+        , silent_for_(silent_for) {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~LocalWsServer() {
+        stop_ = true;
+        // close() alone does not wake a blocked accept()
+        ::shutdown(acceptor_.native_handle(), SHUT_RDWR);
+        beast::error_code ignored;
+        acceptor_.close(ignored);
+        thread_.join();
+    }
+
+    std::string url() const {
+        return "ws://127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()) + "/realtime";
+    }
+
+    std::vector<std::string> received() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return received_;
+    }
+
+    int connections() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return connections_;
+    }
+
+private:
+    void run() {
+        while (!stop_) {
+            beast::error_code ec;
+            tcp::socket socket(ioc_);
+            acceptor_.accept(socket, ec);
+            if (ec) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++connections_;
+            }
+            websocket::stream<tcp::socket> ws(std::move(socket));
+            ws.accept(ec);
+            int pushed = 0;
+            while (!ec) {
+                beast::flat_buffer buffer;
+                ws.read(buffer, ec);
+                if (ec) {
+                    break;
+                }
+                std::string text = beast::buffers_to_string(buffer.data());
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    received_.push_back(text);
+                }
+                if (text.find("\"subscribe\"") != std::string::npos) {
+                    ws.text(true);
+                    ws.write(net::buffer(std::string(
+                        R"({"table":"orderBookL2","action":"partial","data":[]})")), ec);
+                    if (++pushed == drop_after_) {
+                        ws.next_layer().close(ec);
+                        break;
+                    }
+                    if (silent_for_.count() > 0 && connections() == 1) {
+                        const auto until = std::chrono::steady_clock::now() + silent_for_;
+                        while (!stop_ && std::chrono::steady_clock::now() < until) {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                        }
+                        ws.next_layer().close(ec);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    net::io_context ioc_;
+    tcp::acceptor acceptor_;
+    int drop_after_;
+    std::chrono::milliseconds silent_for_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+    std::mutex mutex_;
+    std::vector<std::string> received_;
+    int connections_{0};
+};
+
+// Self-signed certificate and key, PEM, naming `subject_alt_name`
+// (e.g. "IP:127.0.0.1")
+struct TestCertificate {
+    std::string cert_pem;
+    std::string key_pem;
+
+    explicit TestCertificate(const std::string& subject_alt_name) {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        X509* cert = X509_new();
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), -60);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("test"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509V3_CTX ctx;
+        X509V3_set_ctx_nodb(&ctx);
+        X509V3_set_ctx(&ctx, cert, cert, nullptr, nullptr, 0);
+        X509_EXTENSION* san = X509V3_EXT_conf_nid(nullptr, &ctx, NID_subject_alt_name,
+                                                  subject_alt_name.c_str());
+        X509_add_ext(cert, san, -1);
+        X509_EXTENSION_free(san);
+        X509_sign(cert, key, EVP_sha256());
+
+        cert_pem = to_pem([&](BIO* bio) { PEM_write_bio_X509(bio, cert); });
+        key_pem = to_pem([&](BIO* bio) {
+            PEM_write_bio_PrivateKey(bio, key, nullptr, nullptr, 0, nullptr, nullptr);
+        });
+        X509_free(cert);
+        EVP_PKEY_free(key);
+    }
+
+private:
+    template <class F>
+    static std::string to_pem(F&& write) {
+        BIO* bio = BIO_new(BIO_s_mem());
+        write(bio);
+        char* data = nullptr;
+        const long size = BIO_get_mem_data(bio, &data);
+        std::string pem(data, static_cast<size_t>(size));
+        BIO_free(bio);
+        return pem;
+    }
+};
+
+// wss:// server presenting `certificate`: counts TLS handshakes the client
+// let complete and answers each subscribe with a canned partial
+class LocalTlsWsServer {
+public:
+    explicit LocalTlsWsServer(const TestCertificate& certificate)
+        : acceptor_(ioc_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {
+        ctx_.use_certificate_chain(net::buffer(certificate.cert_pem));
+        ctx_.use_private_key(net::buffer(certificate.key_pem), ssl::context::pem);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~LocalTlsWsServer() {
+        stop_ = true;
+        ::shutdown(acceptor_.native_handle(), SHUT_RDWR);
+        beast::error_code ignored;
+        acceptor_.close(ignored);
+        thread_.join();
+    }
+
+    std::string url() const {
+        return "wss://127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()) + "/realtime";
+    }
+
+    int attempts() const { return attempts_.load(); }
+    int handshakes() const { return handshakes_.load(); }
+
+private:
+    void run() {
+        while (!stop_) {
+            beast::error_code ec;
+            tcp::socket socket(ioc_);
+            acceptor_.accept(socket, ec);
+            if (ec) {
+                return;
+            }
+            ++attempts_;
+            websocket::stream<beast::ssl_stream<tcp::socket>> ws(std::move(socket), ctx_);
+            ws.next_layer().handshake(ssl::stream_base::server, ec);
+            if (ec) {
+                continue;
+            }
+            ++handshakes_;
+            ws.accept(ec);
+            while (!ec && !stop_) {
+                beast::flat_buffer buffer;
+                ws.read(buffer, ec);
+                const bool subscribe = !ec &&
+                    beast::buffers_to_string(buffer.data()).find("\"subscribe\"") != std::string::npos;
+                if (subscribe) {
+                    ws.text(true);
+                    ws.write(net::buffer(std::string(
+                        R"({"table":"orderBookL2","action":"partial","data":[]})")), ec);
+                }
+            }
+        }
+    }
+
+    net::io_context ioc_;
+    ssl::context ctx_{ssl::context::tls_server};
+    tcp::acceptor acceptor_;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> attempts_{0};
+    std::atomic<int> handshakes_{0};
+    std::thread thread_;
+};
+
+struct FrameSink {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> frames;
+
+    void operator()(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames.emplace_back(text);
+        cv.notify_all();
+    }
+
+    bool wait_for(size_t n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return frames.size() >= n; });
+    }
+};
+
+}  // namespace
+
+TEST(BitMEXWebSocketClientTest, DerivesRealtimeUrl) {
+    EXPECT_EQ(BitMEXWebSocketClient::realtime_url("https://testnet.bitmex.com/api/v1"),
+              "wss://testnet.bitmex.com/realtime");
+    EXPECT_EQ(BitMEXWebSocketClient::realtime_url("http://127.0.0.1:8080/api/v1/"),
+              "ws://127.0.0.1:8080/realtime");
+}
+
+TEST(BitMEXWebSocketClientTest, AuthenticatesSubscribesAndDelivers) {
+    LocalWsServer server;
+    FrameSink sink;
+    BitMEXWebSocketClient::Config config;
+    config.url = server.url();
+    config.api_key = "key";
+    config.api_secret = "secret";
+    config.subscriptions = {"orderBookL2:XBTUSD"};
+    BitMEXWebSocketClient client(config, [&](std::string_view text) { sink(text); });
+
+    client.start();
+    ASSERT_TRUE(sink.wait_for(1));
+    EXPECT_TRUE(client.is_connected());
+    EXPECT_EQ(sink.frames[0], R"({"table":"orderBookL2","action":"partial","data":[]})");
+
+    client.subscribe({"execution:XBTUSD"});
+    ASSERT_TRUE(sink.wait_for(2));
+
+    auto received = server.received();
+    ASSERT_EQ(received.size(), 3u);
+    EXPECT_NE(received[0].find(R"("op":"authKeyExpires","args":["key",)"), std::string::npos);
+    EXPECT_EQ(received[1], R"({"op":"subscribe","args":["orderBookL2:XBTUSD"]})");
+    EXPECT_EQ(received[2], R"({"op":"subscribe","args":["execution:XBTUSD"]})");
+
+    client.stop();
+    EXPECT_FALSE(client.is_connected());
+}
+
+TEST(BitMEXWebSocketClientTest, ReconnectsAndResubscribes) {
+    LocalWsServer server(1);
+    FrameSink sink;
+    BitMEXWebSocketClient::Config config;
+    config.url = server.url();
+    config.subscriptions = {"orderBookL2:XBTUSD"};
+    config.reconnect_delay = std::chrono::milliseconds(10);
+    BitMEXWebSocketClient client(config, [&](std::string_view text) { sink(text); });
+
+    client.start();
+    ASSERT_TRUE(sink.wait_for(3));
+    EXPECT_GE(server.connections(), 3);
+    for (const auto& message : server.received()) {
+        EXPECT_EQ(message, R"({"op":"subscribe","args":["orderBookL2:XBTUSD"]})");
+    }
+}
+
+TEST(BitMEXWebSocketClientTest, DropsAConnectionThatStopsAnsweringPings) {
+    LocalWsServer server(-1, std::chrono::milliseconds(3000));
+    FrameSink sink;
+    BitMEXWebSocketClient::Config config;
+    config.url = server.url();
+    config.subscriptions = {"orderBookL2:XBTUSD"};
+    config.idle_timeout = std::chrono::milliseconds(200);
+    BitMEXWebSocketClient client(config, [&](std::string_view text) { sink(text); });
+
+    client.start();
+    ASSERT_TRUE(sink.wait_for(1));
+    // Well before the server itself gives up on the connection
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1500);
+    while (client.is_connected() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_FALSE(client.is_connected());
+    client.stop();
+}
+
+TEST(BitMEXWebSocketClientTest, HandlerErrorReconnects) {
+    LocalWsServer server;
+    FrameSink sink;
+    BitMEXWebSocketClient::Config config;
+    config.url = server.url();
+    config.subscriptions = {"orderBookL2:XBTUSD"};
+    config.reconnect_delay = std::chrono::milliseconds(10);
+    std::string reported;
+    config.on_error = [&](const std::string& error) { reported = error; };
+    bool thrown = false;
+    BitMEXWebSocketClient client(config, [&](std::string_view text) {
+        sink(text);
+        if (!thrown) {
+            thrown = true;
+            throw std::runtime_error("bad frame");
+        }
+    });
+
+    client.start();
+    ASSERT_TRUE(sink.wait_for(2));
+    EXPECT_EQ(server.connections(), 2);
+    EXPECT_EQ(sink.frames[1], R"({"table":"orderBookL2","action":"partial","data":[]})");
+    client.stop();
+    EXPECT_EQ(reported, "bad frame");
+}
+
+TEST(BitMEXWebSocketClientTest, AcceptsACertificateNamingTheHost) {
+    TestCertificate certificate("IP:127.0.0.1");
+    LocalTlsWsServer server(certificate);
+    FrameSink sink;
+    BitMEXWebSocketClient::Config config;
+    config.url = server.url();
+    config.subscriptions = {"orderBookL2:XBTUSD"};
+    config.ca_pem = certificate.cert_pem;
+    BitMEXWebSocketClient client(config, [&](std::string_view text) { sink(text); });
+
+    client.start();
+    ASSERT_TRUE(sink.wait_for(1));
+    EXPECT_TRUE(client.is_connected());
+    client.stop();
+}
+
+TEST(BitMEXWebSocketClientTest, RefusesATrustedCertificateForAnotherHost) {
+    // Chains to a trusted root, but names some other site
+    TestCertificate certificate("DNS:www.example.com");
+    LocalTlsWsServer server(certificate);
+    FrameSink sink;
+    BitMEXWebSocketClient::Config config;
+    config.url = server.url();
+    config.api_key = "key";
+    config.api_secret = "secret";
+    config.subscriptions = {"orderBookL2:XBTUSD"};
+    config.reconnect_delay = std::chrono::milliseconds(10);
+    config.ca_pem = certificate.cert_pem;
+    BitMEXWebSocketClient client(config, [&](std::string_view text) { sink(text); });
+
+    client.start();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server.attempts() < 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    client.stop();
+    EXPECT_GE(server.attempts(), 3);
+    EXPECT_EQ(server.handshakes(), 0);
+    EXPECT_FALSE(client.is_connected());
+    EXPECT_TRUE(sink.frames.empty());
+}
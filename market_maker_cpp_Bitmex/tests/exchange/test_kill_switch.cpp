@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <market_maker/backtest/local_bitmex_exchange.h>
+#include <market_maker/exchange/kill_switch.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "order_fixtures.h"
+
+namespace {
+
+BitMEXConnector::Config connector_config(const LocalBitMEXExchange& exchange) {
+    BitMEXConnector::Config config;
+    config.base_url = exchange.rest_url();
+    config.symbol = "XBTUSD";
+    config.api_key = "key";
+    config.api_secret = "secret";
+    return config;
+}
+
+KillSwitch::Config fast_config() {
+    KillSwitch::Config config;
+    config.heartbeat_interval = std::chrono::milliseconds(50);
+    config.dead_man_timeout = std::chrono::milliseconds(300);
+    config.retry_delay = std::chrono::milliseconds(10);
+    return config;
+}
+
+template <class Pred>
+bool eventually(Pred pred) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(KillSwitchTest, TripCancelsEverythingAndHaltsNewOrders) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    auto connector = std::make_shared<BitMEXConnector>(connector_config(exchange));
+    for (int64_t id = 1; id <= 3; ++id) {
+        ASSERT_TRUE(connector->place_order(make_order(id, OrderSide::BUY, 9000.0 + id)));
+    }
+
+    KillSwitch kill_switch(connector, fast_config());
+    kill_switch.start();
+    kill_switch.trip("test");
+    EXPECT_TRUE(kill_switch.tripped());
+    EXPECT_EQ(kill_switch.reason(), "test");
+    EXPECT_FALSE(connector->place_order(make_order(4, OrderSide::BUY, 9000.0)));
+    ASSERT_TRUE(eventually([&] { return exchange.open_orders() == 0; }));
+
+    // Cancels still go while halted; reset lets quoting resume
+    EXPECT_TRUE(connector->cancel_order(1));
+    kill_switch.reset();
+    EXPECT_TRUE(connector->place_order(make_order(5, OrderSide::BUY, 9000.0)));
+    EXPECT_EQ(exchange.open_orders(), 1u);
+}
+
+TEST(KillSwitchTest, AcceptedCancelAllClearsLocalState) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    auto connector = std::make_shared<BitMEXConnector>(connector_config(exchange));
+    auto orders = make_order_manager();
+    for (int64_t i = 0; i < 2; ++i) {
+        auto order = orders->place_order(OrderSide::BUY, 9000.0 + i, 1);
+        ASSERT_TRUE(order.has_value());
+        ASSERT_TRUE(connector->place_order(*order));
+    }
+
+    KillSwitch kill_switch(connector, fast_config());
+    kill_switch.attach(orders);
+    std::atomic<int> notified{0};
+    kill_switch.add_cancel_listener([&] { notified.fetch_add(1); });
+    kill_switch.start();
+    kill_switch.trip("test");
+    ASSERT_TRUE(eventually([&] { return notified.load() == 1; }));
+    EXPECT_EQ(exchange.open_orders(), 0u);
+    EXPECT_EQ(orders->active_order_count(), 0);
+    EXPECT_DOUBLE_EQ(orders->get_notional_exposure(), 0.0);
+}
+
+TEST(KillSwitchTest, ResetDropsACancelAllStillRetrying) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    auto connector = std::make_shared<BitMEXConnector>(connector_config(exchange));
+
+    KillSwitch kill_switch(connector, fast_config());
+    kill_switch.start();
+    exchange.inject_overload(1'000'000);
+    kill_switch.trip("overloaded");
+    ASSERT_TRUE(eventually([&] { return kill_switch.cancel_alls() >= 2; }));
+    kill_switch.reset();
+    EXPECT_EQ(kill_switch.reason(), "");
+
+    // Once any attempt already on the wire is back, nothing more goes out
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const uint64_t attempts = kill_switch.cancel_alls();
+    exchange.inject_overload(0);
+    ASSERT_TRUE(connector->place_order(make_order(1, OrderSide::BUY, 9000.0)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(kill_switch.cancel_alls(), attempts);
+    EXPECT_EQ(exchange.open_orders(), 1u);
+}
+
+TEST(KillSwitchTest, RetriesCancelAllUntilAccepted) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    auto connector = std::make_shared<BitMEXConnector>(connector_config(exchange));
+    ASSERT_TRUE(connector->place_order(make_order(1, OrderSide::BUY, 9000.0)));
+
+    KillSwitch kill_switch(connector, fast_config());
+    kill_switch.start();
+    ASSERT_TRUE(eventually([&] { return kill_switch.heartbeats() > 0; }));
+    exchange.inject_overload(2);
+    kill_switch.trip("overloaded");
+    ASSERT_TRUE(eventually([&] { return exchange.open_orders() == 0; }));
+    EXPECT_GE(kill_switch.cancel_alls() + kill_switch.heartbeat_failures(), 3u);
+}
+
+TEST(KillSwitchTest, HeartbeatKeepsOrdersUntilProcessGoesQuiet) {
+    LocalBitMEXExchange exchange({});
+    std::atomic<int> heartbeats{0};
+    exchange.set_request_listener([&](const std::string& method, const std::string& path, int64_t) {
+        if (method == "POST" && path == "/api/v1/order/cancelAllAfter") {
+            heartbeats.fetch_add(1);
+        }
+    });
+    exchange.start();
+    auto connector = std::make_shared<BitMEXConnector>(connector_config(exchange));
+    ASSERT_TRUE(connector->place_order(make_order(1, OrderSide::BUY, 9000.0)));
+
+    {
+        KillSwitch kill_switch(connector, fast_config());
+        kill_switch.start();
+        // Several timeouts' worth of heartbeats, each pushing the deadline on
+        std::this_thread::sleep_for(std::chrono::milliseconds(700));
+        EXPECT_GE(heartbeats.load(), 5);
+        EXPECT_EQ(exchange.open_orders(), 1u);
+    }
+    // A clean stop disarms the exchange timer
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_EQ(exchange.open_orders(), 1u);
+
+    // A process that stops heartbeating is flattened by the exchange
+    ASSERT_TRUE(connector->cancel_all_after(std::chrono::milliseconds(100)));
+    EXPECT_EQ(exchange.open_orders(), 1u);
+    ASSERT_TRUE(eventually([&] { return exchange.open_orders() == 0; }));
+}
+
+TEST(KillSwitchTest, SharedSwitchStaysArmedUntilItsLastUserReleases) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    auto connector = std::make_shared<BitMEXConnector>(connector_config(exchange));
+    auto other = std::make_shared<BitMEXConnector>(connector_config(exchange));
+    ASSERT_TRUE(connector->place_order(make_order(1, OrderSide::BUY, 9000.0)));
+
+    KillSwitch kill_switch(connector, fast_config());
+    kill_switch.attach(other);
+    std::atomic<int> first{0};
+    std::atomic<int> second{0};
+    const auto first_id = kill_switch.add_cancel_listener([&] { first.fetch_add(1); });
+    kill_switch.add_cancel_listener([&] { second.fetch_add(1); });
+    kill_switch.acquire();
+    kill_switch.acquire();
+
+    // One user leaving neither stops the heartbeat nor disarms the exchange
+    kill_switch.remove_cancel_listener(first_id);
+    kill_switch.release();
+    const uint64_t beats = kill_switch.heartbeats();
+    ASSERT_TRUE(eventually([&] { return kill_switch.heartbeats() >= beats + 3; }));
+    EXPECT_EQ(exchange.open_orders(), 1u);
+
+    // A trip halts every connector on the account and reaches the users left
+    kill_switch.trip("test");
+    EXPECT_TRUE(other->new_orders_halted());
+    ASSERT_TRUE(eventually([&] { return second.load() == 1; }));
+    EXPECT_EQ(first.load(), 0);
+    EXPECT_EQ(exchange.open_orders(), 0u);
+
+    kill_switch.release();
+    const uint64_t final_beats = kill_switch.heartbeats();
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(kill_switch.heartbeats(), final_beats);
+}
+
+TEST(KillSwitchTest, RiskCircuitBreakerTrips) {
+    LocalBitMEXExchange exchange({});
+    exchange.start();
+    auto connector = std::make_shared<BitMEXConnector>(connector_config(exchange));
+    ASSERT_TRUE(connector->place_order(make_order(1, OrderSide::BUY, 9000.0)));
+
+    RiskManager::RiskLimits limits;
+    limits.max_position_value = 1000.0;
+    RiskManager risk(limits);
+    KillSwitch kill_switch(connector, fast_config());
+    kill_switch.subscribe(risk);
+    kill_switch.start();
+
+    risk.on_position_delta({.order_id = 1, .side = OrderSide::BUY, .quantity = 1.0,
+                            .price = 9000.0, .position = 1.0, .timestamp = 0});
+    ASSERT_TRUE(eventually([&] { return exchange.open_orders() == 0; }));
+    EXPECT_EQ(kill_switch.reason(), "Position limit exceeded");
+}
+
+TEST(KillSwitchTest, RejectsTimeoutShorterThanHeartbeat) {
+    KillSwitch::Config config;
+    config.dead_man_timeout = config.heartbeat_interval;
+    EXPECT_THROW(KillSwitch(std::make_shared<BitMEXConnector>(BitMEXConnector::Config{}), config),
+                 std::runtime_error);
+}
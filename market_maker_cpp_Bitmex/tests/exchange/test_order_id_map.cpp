@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <market_maker/exchange/order_id_map.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+std::string make_uuid(uint64_t n) {
+    char text[40];
+    std::snprintf(text, sizeof(text), "%08x-%04x-%04x-%04x-%012llx",
+                  static_cast<unsigned>(n >> 32), static_cast<unsigned>(n >> 16 & 0xffff),
+                  static_cast<unsigned>(n & 0xffff), 0xbeefu,
+                  static_cast<unsigned long long>(n * 0x9E3779B97F4A7C15ull & 0xffffffffffffull));
+    return text;
+}
+
+}  // namespace
+
+TEST(OrderIdMapTest, UuidRoundTrips) {
+    const std::string text = "0cd4e3f7-9a0b-4c1d-8e2f-3a4b5c6d7e8f";
+    ExchangeOrderId id;
+    ASSERT_TRUE(ExchangeOrderId::parse(text, id));
+    EXPECT_EQ(id.bytes[0], 0x0c);
+    EXPECT_EQ(id.bytes[15], 0x8f);
+
+    char out[ExchangeOrderId::TEXT_SIZE];
+    id.format(out);
+    EXPECT_EQ(std::string(out, sizeof(out)), text);
+
+    ExchangeOrderId upper;
+    ASSERT_TRUE(ExchangeOrderId::parse("0CD4E3F7-9A0B-4C1D-8E2F-3A4B5C6D7E8F", upper));
+    EXPECT_TRUE(upper == id);
+
+    EXPECT_FALSE(ExchangeOrderId::parse("0cd4e3f7-9a0b-4c1d-8e2f-3a4b5c6d7e8", id));
+    EXPECT_FALSE(ExchangeOrderId::parse("0cd4e3f7x9a0b-4c1d-8e2f-3a4b5c6d7e8f", id));
+    EXPECT_FALSE(ExchangeOrderId::parse("0cd4e3f7-9a0b-4c1d-8e2f-3a4b5c6d7e8g", id));
+}
+
+TEST(OrderIdMapTest, ClOrdIdConvertsBothWays) {
+    OrderIdMap map("mm_bitmex_", 16);
+    char out[OrderIdMap::MAX_CL_ORD_ID];
+    const size_t len = map.format_cl_ord_id(1234567890123, out);
+    EXPECT_EQ(std::string(out, len), "mm_bitmex_1234567890123");
+
+    EXPECT_EQ(map.parse_cl_ord_id("mm_bitmex_1234567890123"), 1234567890123);
+    EXPECT_EQ(map.parse_cl_ord_id("mm_bitmex_"), 0);
+    EXPECT_EQ(map.parse_cl_ord_id("mm_bitmex_12x"), 0);
+    EXPECT_EQ(map.parse_cl_ord_id("other_12"), 0);
+    EXPECT_EQ(map.parse_cl_ord_id(""), 0);
+}
+
+TEST(OrderIdMapTest, BindFindErase) {
+    OrderIdMap map("mm_", 4);
+    const std::string uuid = make_uuid(1);
+
+    EXPECT_EQ(map.find(uuid), 0);
+    EXPECT_EQ(map.exchange_id(7), nullptr);
+
+    ASSERT_TRUE(map.bind(7, uuid));
+    EXPECT_TRUE(map.bind(7, uuid));               // Repeat rows are harmless
+    EXPECT_FALSE(map.bind(7, make_uuid(2)));      // One order, one exchange id
+    EXPECT_FALSE(map.bind(8, uuid));
+    EXPECT_FALSE(map.bind(9, "not-a-uuid"));
+    EXPECT_EQ(map.find(uuid), 7);
+    ASSERT_NE(map.exchange_id(7), nullptr);
+    char out[ExchangeOrderId::TEXT_SIZE];
+    map.exchange_id(7)->format(out);
+    EXPECT_EQ(std::string(out, sizeof(out)), uuid);
+
+    EXPECT_TRUE(map.erase(7));
+    EXPECT_FALSE(map.erase(7));
+    EXPECT_EQ(map.find(uuid), 0);
+    EXPECT_EQ(map.size(), 0u);
+}
+
+TEST(OrderIdMapTest, RejectsBeyondCapacity) {
+    OrderIdMap map("mm_", 4);
+    for (int64_t id = 1; id <= 4; ++id) {
+        EXPECT_TRUE(map.bind(id, make_uuid(id)));
+    }
+    EXPECT_FALSE(map.bind(5, make_uuid(5)));
+
+    map.erase(2);
+    EXPECT_TRUE(map.bind(5, make_uuid(5)));
+    EXPECT_EQ(map.find(make_uuid(5)), 5);
+    EXPECT_EQ(map.find(make_uuid(2)), 0);
+}
+
+TEST(OrderIdMapTest, MatchesReferenceUnderChurn) {
+    constexpr size_t CAPACITY = 256;
+    OrderIdMap map("mm_", CAPACITY);
+    std::unordered_map<int64_t, std::string> reference;
+    std::mt19937_64 rng(7);
+
+    for (int step = 0; step < 100000; ++step) {
+        const int64_t id = static_cast<int64_t>(rng() % 512) + 1;
+        if (rng() % 2 == 0) {
+            const std::string uuid = make_uuid(rng());
+            const bool fits = reference.count(id) == 0 && reference.size() < CAPACITY;
+            EXPECT_EQ(map.bind(id, uuid), fits);
+            if (fits) {
+                reference[id] = uuid;
+            }
+        } else {
+            EXPECT_EQ(map.erase(id), reference.erase(id) == 1);
+        }
+    }
+
+    EXPECT_EQ(map.size(), reference.size());
+    for (const auto& [id, uuid] : reference) {
+        EXPECT_EQ(map.find(uuid), id);
+    }
+}
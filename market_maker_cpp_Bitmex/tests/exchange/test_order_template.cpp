@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <market_maker/exchange/order_template.h>
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <string>
+
+namespace {
+
+nlohmann::json render(const OrderTemplate& order_template, std::string_view cl_ord_id,
+                      double price, double quantity) {
+    std::string body(order_template.size(), '\0');
+    EXPECT_TRUE(order_template.render(cl_ord_id, price, quantity, body.data()));
+    return nlohmann::json::parse(body);
+}
+
+}  // namespace
+
+TEST(OrderTemplateTest, RendersSameFieldsAsJsonPath) {
+    const OrderTemplate buy("XBTUSD", OrderSide::BUY, true, 0.5, 1.0);
+    const auto body = render(buy, "mm_bitmex_42", 9999.5, 100);
+
+    EXPECT_EQ(body, (nlohmann::json{
+        {"symbol", "XBTUSD"},
+        {"side", "Buy"},
+        {"orderQty", 100},
+        {"price", 9999.5},
+        {"ordType", "Limit"},
+        {"clOrdID", "mm_bitmex_42"},
+        {"execInst", "ParticipateDoNotInitiate"}
+    }));
+
+    const OrderTemplate sell("ETHUSD", OrderSide::SELL, false, 0.05, 1.0);
+    const auto sell_body = render(sell, "x", 2500.15, 3);
+    EXPECT_EQ(sell_body["side"], "Sell");
+    EXPECT_EQ(sell_body["symbol"], "ETHUSD");
+    EXPECT_FALSE(sell_body.contains("execInst"));
+    EXPECT_DOUBLE_EQ(sell_body["price"].get<double>(), 2500.15);
+}
+
+TEST(OrderTemplateTest, EveryBodyHasTheSameSize) {
+    const OrderTemplate buy("XBTUSD", OrderSide::BUY, false, 0.5, 1.0);
+    std::string first(buy.size(), '\0');
+    std::string second(buy.size(), '\0');
+    ASSERT_TRUE(buy.render("a", 1.0, 1, first.data()));
+    ASSERT_TRUE(buy.render("mm_bitmex_123456789012345678901234", 123456789.5, 987654321, second.data()));
+
+    // A longer value only overwrites padding of the shorter one
+    EXPECT_EQ(nlohmann::json::parse(first)["clOrdID"], "a");
+    EXPECT_EQ(nlohmann::json::parse(second)["orderQty"], 987654321);
+    EXPECT_DOUBLE_EQ(nlohmann::json::parse(second)["price"].get<double>(), 123456789.5);
+}
+
+TEST(OrderTemplateTest, RefusesValuesThatDoNotFit) {
+    const OrderTemplate buy("XBTUSD", OrderSide::BUY, false, 0.5, 1.0);
+    std::string body(buy.size(), '\0');
+    EXPECT_FALSE(buy.render(std::string(OrderTemplate::CL_ORD_ID_WIDTH + 1, 'x'), 1.0, 1, body.data()));
+    EXPECT_FALSE(buy.render("a", 1e30, 1, body.data()));
+    EXPECT_FALSE(buy.render("a", 1.0, std::nan(""), body.data()));
+}
+
+TEST(OrderFormatTest, WritesExactDecimals) {
+    EXPECT_EQ(order_format::decimals_for(0.5), 1);
+    EXPECT_EQ(order_format::decimals_for(0.01), 2);
+    EXPECT_EQ(order_format::decimals_for(0.00001), 5);
+    EXPECT_EQ(order_format::decimals_for(1.0), 0);
+    EXPECT_EQ(order_format::decimals_for(5.0), 0);
+
+    char out[24];
+    auto format = [&](double value, int decimals, int64_t scale) {
+        return std::string(out, order_format::write_decimal(value, decimals, scale, out, sizeof(out)));
+    };
+    EXPECT_EQ(format(9999.5, 1, 10), "9999.5");
+    EXPECT_EQ(format(10000.0, 1, 10), "10000.0");
+    EXPECT_EQ(format(0.07, 2, 100), "0.07");
+    EXPECT_EQ(format(123.456, 2, 100), "123.46");
+    EXPECT_EQ(format(-1.5, 1, 10), "-1.5");
+    EXPECT_EQ(format(-0.25, 2, 100), "-0.25");
+    EXPECT_EQ(format(42.0, 0, 1), "42");
+    EXPECT_EQ(order_format::write_decimal(123456.0, 0, 1, out, 5), 0u);
+}
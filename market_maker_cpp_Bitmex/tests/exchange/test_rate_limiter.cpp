@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <market_maker/exchange/rate_limiter.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int64_t SECOND = 1'000'000'000;
+constexpr int64_t T0 = 1000 * SECOND;
+
+RateLimiter::Config small_config() {
+    RateLimiter::Config config;
+    config.per_second = 10;
+    config.per_minute = 60;
+    config.cancel_reserve_second = 2;
+    config.cancel_reserve_minute = 6;
+    return config;
+}
+
+}  // namespace
+
+TEST(RateLimiterTest, PerSecondBucketRefills) {
+    RateLimiter limiter(small_config());
+
+    // Burst up to capacity minus the cancel reserve
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(limiter.try_acquire(RateLimiter::Priority::NORMAL, T0)) << i;
+    }
+    EXPECT_FALSE(limiter.try_acquire(RateLimiter::Priority::NORMAL, T0));
+
+    // One token per 100ms
+    EXPECT_FALSE(limiter.try_acquire(RateLimiter::Priority::NORMAL, T0 + SECOND / 20));
+    EXPECT_TRUE(limiter.try_acquire(RateLimiter::Priority::NORMAL, T0 + SECOND / 10));
+}
+
+TEST(RateLimiterTest, CancelsUseTheReserve) {
+    RateLimiter limiter(small_config());
+
+    while (limiter.try_acquire(RateLimiter::Priority::NORMAL, T0)) {}
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::NORMAL, T0), 0);
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::CANCEL, T0), 2);
+
+    EXPECT_TRUE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0));
+    EXPECT_TRUE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0));
+    EXPECT_FALSE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0));
+}
+
+TEST(RateLimiterTest, BothBucketsMustAdmit) {
+    RateLimiter::Config config = small_config();
+    config.per_second = 100;
+    config.cancel_reserve_second = 0;
+    RateLimiter limiter(config);
+
+    int admitted = 0;
+    for (int i = 0; i < 100; ++i) {
+        admitted += limiter.try_acquire(RateLimiter::Priority::NORMAL, T0);
+    }
+    EXPECT_EQ(admitted, 54);  // Minute bucket less its cancel reserve
+
+    // Refusals by the minute bucket handed their per-second tokens back, so
+    // the minute's cancel reserve is still reachable
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::CANCEL, T0), 6);
+}
+
+TEST(RateLimiterTest, ResyncsFromServerCount) {
+    RateLimiter limiter(small_config());
+
+    limiter.sync_minute(10, 0, T0);
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::NORMAL, T0), 4);
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::CANCEL, T0), 10);
+
+    // A late response with an older, higher count gives nothing back
+    limiter.sync_minute(60, 0, T0);
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::NORMAL, T0), 4);
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::CANCEL, T0), 10);
+
+    limiter.sync_second(1, T0);
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::CANCEL, T0), 1);
+    EXPECT_EQ(limiter.available(RateLimiter::Priority::NORMAL, T0), 0);
+
+    // Exhausted window stays closed until its reset
+    limiter.sync_minute(0, 5 * SECOND, T0);
+    EXPECT_FALSE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0 + 4 * SECOND));
+    EXPECT_TRUE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0 + 6 * SECOND));
+}
+
+TEST(RateLimiterTest, HoldOffBlocksEverything) {
+    RateLimiter limiter(small_config());
+
+    limiter.hold_off(2 * SECOND, T0);
+    EXPECT_FALSE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0 + SECOND));
+    EXPECT_FALSE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0 + 2 * SECOND));
+    EXPECT_TRUE(limiter.try_acquire(RateLimiter::Priority::CANCEL, T0 + 3 * SECOND));
+}
+
+TEST(RateLimiterTest, ConcurrentAcquiresNeverOvershoot) {
+    RateLimiter::Config config;
+    config.per_second = 1000;
+    config.per_minute = 5000;
+    config.cancel_reserve_second = 0;
+    config.cancel_reserve_minute = 0;
+    RateLimiter limiter(config);
+
+    std::atomic<int> admitted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                admitted += limiter.try_acquire(RateLimiter::Priority::NORMAL, T0);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(admitted.load(), 1000);
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <market_maker/backtest/local_bitmex_exchange.h>
+#include <market_maker/exchange/bitmex_connector.h>
+#include <market_maker/exchange/rest_connection_pool.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::string order_body(int64_t id, double price) {
+    return R"({"symbol":"XBTUSD","side":"Buy","ordType":"Limit","orderQty":1,"price":)" +
+           std::to_string(price) + R"(,"clOrdID":"mm_bitmex_)" + std::to_string(id) + "\"}";
+}
+
+// Records completions in order and lets the test wait for a count
+struct Completions {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> order;
+
+    RestConnectionPool::Completion record(std::string name) {
+        return [this, name](const BitMEXRestClient::Response& response) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(response.ok() ? name : name + " failed");
+            cv.notify_all();
+        };
+    }
+
+    bool wait_for(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, 5s, [&] { return order.size() >= count; });
+    }
+};
+
+}  // namespace
+
+TEST(RestConnectionPoolTest, IndependentRequestsShareOneRoundTrip) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = 100ms;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    RestConnectionPool pool({exchange.rest_url(), "key", "secret"}, 4);
+
+    Completions done;
+    const auto start = std::chrono::steady_clock::now();
+    for (int64_t id = 1; id <= 4; ++id) {
+        pool.submit(RestConnectionPool::Lane::NORMAL, "POST", "/order", {},
+                    order_body(id, 9000.0 + id), done.record("place"));
+    }
+    EXPECT_EQ(pool.in_flight(), 4u);
+    ASSERT_TRUE(done.wait_for(4));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(done.order, std::vector<std::string>(4, "place"));
+    EXPECT_GE(elapsed, 100ms);
+    EXPECT_LT(elapsed, 300ms);  // Serially this is 400ms
+    EXPECT_EQ(exchange.open_orders(), 4u);
+    EXPECT_EQ(pool.in_flight(), 0u);
+}
+
+TEST(RestConnectionPoolTest, CancelsJumpTheQueue) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = 50ms;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    RestConnectionPool pool({exchange.rest_url(), "key", "secret"}, 1);
+
+    Completions done;
+    for (int64_t id = 1; id <= 3; ++id) {
+        pool.submit(RestConnectionPool::Lane::NORMAL, "POST", "/order", {},
+                    order_body(id, 9000.0 + id), done.record("place " + std::to_string(id)));
+        if (id == 1) {
+            std::this_thread::sleep_for(10ms);  // Let it reach the wire
+        }
+    }
+    pool.submit(RestConnectionPool::Lane::PRIORITY, "DELETE", "/order", {},
+                R"({"clOrdID":"mm_bitmex_1"})", done.record("cancel"));
+    ASSERT_TRUE(done.wait_for(4));
+
+    // Place 1 was already on the wire; the cancel overtakes 2 and 3
+    EXPECT_EQ(done.order, (std::vector<std::string>{"place 1", "cancel", "place 2", "place 3"}));
+    EXPECT_EQ(exchange.open_orders(), 2u);
+}
+
+TEST(RestConnectionPoolTest, RequestsForOneOrderStayInOrder) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = 50ms;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    RestConnectionPool pool({exchange.rest_url(), "key", "secret"}, 4);
+
+    // With three idle connections the cancel would otherwise arrive first
+    Completions done;
+    pool.submit(RestConnectionPool::Lane::NORMAL, "POST", "/order", {},
+                order_body(1, 9001.0), done.record("place"), 1);
+    pool.submit(RestConnectionPool::Lane::PRIORITY, "DELETE", "/order", {},
+                R"({"clOrdID":"mm_bitmex_1"})", done.record("cancel"), 1);
+    ASSERT_TRUE(done.wait_for(2));
+    EXPECT_EQ(done.order, (std::vector<std::string>{"place", "cancel"}));
+    EXPECT_EQ(exchange.open_orders(), 0u);
+}
+
+TEST(RestConnectionPoolTest, CancelTakesItsQueuedPlaceAlong) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = 50ms;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    RestConnectionPool pool({exchange.rest_url(), "key", "secret"}, 1);
+
+    Completions done;
+    for (int64_t id = 1; id <= 3; ++id) {
+        pool.submit(RestConnectionPool::Lane::NORMAL, "POST", "/order", {},
+                    order_body(id, 9000.0 + id), done.record("place " + std::to_string(id)), id);
+        if (id == 1) {
+            std::this_thread::sleep_for(10ms);  // Let it reach the wire
+        }
+    }
+    pool.submit(RestConnectionPool::Lane::PRIORITY, "DELETE", "/order", {},
+                R"({"clOrdID":"mm_bitmex_3"})", done.record("cancel 3"), 3);
+    ASSERT_TRUE(done.wait_for(4));
+
+    EXPECT_EQ(done.order,
+              (std::vector<std::string>{"place 1", "place 3", "cancel 3", "place 2"}));
+    EXPECT_EQ(exchange.open_orders(), 2u);
+}
+
+TEST(RestConnectionPoolTest, StopFailsQueuedRequests) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = 50ms;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    RestConnectionPool pool({exchange.rest_url(), "key", "secret"}, 1);
+
+    Completions done;
+    for (int64_t id = 1; id <= 3; ++id) {
+        pool.submit(RestConnectionPool::Lane::NORMAL, "POST", "/order", {},
+                    order_body(id, 9000.0 + id), done.record("place"));
+    }
+    std::this_thread::sleep_for(10ms);
+    pool.stop();
+    ASSERT_TRUE(done.wait_for(3));
+    EXPECT_EQ(done.order, (std::vector<std::string>{"place", "place failed", "place failed"}));
+
+    pool.submit(RestConnectionPool::Lane::NORMAL, "GET", "/position", {}, {}, done.record("late"));
+    ASSERT_TRUE(done.wait_for(4));
+    EXPECT_EQ(done.order.back(), "late failed");
+}
+
+TEST(RestConnectionPoolTest, ConnectorQuotesAsynchronously) {
+    LocalBitMEXExchange::Config config;
+    config.rest_latency = 100ms;
+    LocalBitMEXExchange exchange(config);
+    exchange.start();
+    BitMEXConnector::Config connector_config;
+    connector_config.base_url = exchange.rest_url();
+    connector_config.symbol = "XBTUSD";
+    connector_config.api_key = "key";
+    connector_config.api_secret = "secret";
+    BitMEXConnector connector(connector_config);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int ok = 0;
+    auto done = [&](const BitMEXRestClient::Response& reply) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ok += reply.ok() ? 1 : 0;
+        cv.notify_all();
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int64_t id = 1; id <= 4; ++id) {
+        Order order{};
+        order.order_id = id;
+        order.side = id % 2 == 0 ? OrderSide::SELL : OrderSide::BUY;
+        order.price = id % 2 == 0 ? 11000.0 + id : 9000.0 + id;
+        order.quantity = 1;
+        connector.place_order_async(order, done);
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, 5s, [&] { return ok == 4; }));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 300ms);
+    EXPECT_EQ(exchange.open_orders(), 4u);
+
+    // Halted orders are refused without a request
+    connector.halt_new_orders(true);
+    bool refused = false;
+    Order order{};
+    order.order_id = 5;
+    order.side = OrderSide::BUY;
+    order.price = 9000.0;
+    order.quantity = 1;
+    connector.place_order_async(order, [&](const BitMEXRestClient::Response& reply) {
+        refused = !reply.ok() && reply.unsent;
+    });
+    EXPECT_TRUE(refused);
+    EXPECT_EQ(connector.requests_in_flight(), 0u);
+}
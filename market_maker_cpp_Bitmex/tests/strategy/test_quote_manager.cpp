@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <market_maker/strategy/quote_manager.h>
+#include <random>
+#include "../exchange/order_fixtures.h"
+
+namespace {
+
+QuoteManager::Config quote_config() {
+    QuoteManager::Config config;
+    config.amend_ticks = 2;
+    config.amend_lots = 5;
+    return config;
+}
+
+constexpr BatchResult ACCEPTED{true, true, true};
+
+size_t messages(const OrderBatch& batch) {
+    return batch.places.size() + batch.amends.size() + batch.cancels.size();
+}
+
+}  // namespace
+
+TEST(QuoteManagerTest, PlacesThenHoldsWithinThreshold) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    const QuoteManager::Quote bid{9999.5, 10}, ask{10000.5, 10};
+    quotes.update(&bid, 1, &ask, 1, batch);
+    ASSERT_EQ(batch.places.size(), 2u);
+    EXPECT_EQ(orders->active_order_count(), 2);
+
+    // One tick and two lots: below both thresholds
+    batch.clear();
+    const QuoteManager::Quote bid2{9999.0, 12}, ask2{10000.7, 8};
+    quotes.update(&bid2, 1, &ask2, 1, batch);
+    EXPECT_TRUE(batch.empty());
+    EXPECT_EQ(quotes.resting(OrderSide::BUY), 1u);
+}
+
+TEST(QuoteManagerTest, AmendsInPlaceBeyondThreshold) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    const QuoteManager::Quote bid{9999.5, 10};
+    quotes.update(&bid, 1, nullptr, 0, batch);
+    const int64_t id = batch.places.at(0).order_id;
+
+    batch.clear();
+    const QuoteManager::Quote moved{9998.5, 10};  // Two ticks
+    quotes.update(&moved, 1, nullptr, 0, batch);
+    ASSERT_EQ(batch.amends.size(), 1u);
+    EXPECT_TRUE(batch.places.empty());
+    EXPECT_EQ(batch.amends[0].order_id, id);
+    EXPECT_DOUBLE_EQ(orders->get_order(id)->price, 9998.5);
+
+    batch.clear();
+    const QuoteManager::Quote resized{9998.5, 20};
+    quotes.update(&resized, 1, nullptr, 0, batch);
+    ASSERT_EQ(batch.amends.size(), 1u);
+    EXPECT_DOUBLE_EQ(orders->get_order(id)->quantity, 20.0);
+}
+
+TEST(QuoteManagerTest, AddsAndRemovesLevels) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    const QuoteManager::Quote ladder[] = {{9999.5, 10}, {9999.0, 10}, {9998.5, 10}, {9998.0, 10}};
+    quotes.update(ladder, 4, nullptr, 0, batch);
+    EXPECT_EQ(batch.places.size(), 3u);  // max_levels
+    EXPECT_EQ(quotes.resting(OrderSide::BUY), 3u);
+
+    quotes.settle(batch, ACCEPTED);
+
+    batch.clear();
+    quotes.update(ladder, 1, nullptr, 0, batch);
+    EXPECT_EQ(batch.cancels.size(), 2u);
+    EXPECT_TRUE(batch.places.empty() && batch.amends.empty());
+    // Cancels leave OrderManager once the exchange has taken them
+    EXPECT_EQ(orders->active_order_count(), 3);
+    quotes.settle(batch, ACCEPTED);
+    EXPECT_EQ(orders->active_order_count(), 1);
+
+    batch.clear();
+    quotes.cancel_all(batch);
+    EXPECT_EQ(batch.cancels.size(), 1u);
+    quotes.settle(batch, ACCEPTED);
+    EXPECT_EQ(orders->active_order_count(), 0);
+}
+
+TEST(QuoteManagerTest, ReplacesFilledQuotesAndRollsBackPlaces) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    const QuoteManager::Quote bid{9999.5, 10};
+    quotes.update(&bid, 1, nullptr, 0, batch);
+    Order filled = batch.places.at(0);
+    filled.filled_quantity = filled.quantity;
+    filled.status = OrderStatus::FILLED;
+    orders->update_order(filled);
+
+    batch.clear();
+    quotes.update(&bid, 1, nullptr, 0, batch);
+    ASSERT_EQ(batch.places.size(), 1u);
+    EXPECT_NE(batch.places[0].order_id, filled.order_id);
+
+    // The exchange never saw it
+    quotes.rollback(batch);
+    EXPECT_EQ(quotes.resting(OrderSide::BUY), 0u);
+    EXPECT_EQ(orders->active_order_count(), 0);
+}
+
+TEST(QuoteManagerTest, RollbackRestoresAmendsAndCancels) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    const QuoteManager::Quote ladder[] = {{9999.5, 10}, {9999.0, 10}};
+    quotes.update(ladder, 2, nullptr, 0, batch);
+    quotes.settle(batch, ACCEPTED);
+    const int64_t best = batch.places.at(0).order_id;
+    const int64_t second = batch.places.at(1).order_id;
+    const double reserved = orders->get_notional_exposure();
+
+    // Move the best level and drop the second; the exchange takes neither
+    batch.clear();
+    const QuoteManager::Quote moved{9998.0, 10};
+    quotes.update(&moved, 1, nullptr, 0, batch);
+    ASSERT_EQ(batch.amends.size(), 1u);
+    ASSERT_EQ(batch.cancels.size(), 1u);
+    quotes.rollback(batch);
+
+    EXPECT_EQ(orders->active_order_count(), 2);
+    EXPECT_DOUBLE_EQ(orders->get_order(best)->price, 9999.5);
+    EXPECT_TRUE(orders->get_order(second));
+    EXPECT_DOUBLE_EQ(orders->get_notional_exposure(), reserved);
+    EXPECT_EQ(quotes.resting(OrderSide::BUY), 2u);
+
+    // Retried on the next tick from the state that really rests
+    batch.clear();
+    quotes.update(&moved, 1, nullptr, 0, batch);
+    EXPECT_EQ(batch.amends.size(), 1u);
+    EXPECT_EQ(batch.cancels, std::vector<int64_t>{second});
+
+    // Cancels went, the amend did not
+    quotes.settle(batch, BatchResult{true, false, false});
+    EXPECT_FALSE(orders->get_order(second));
+    EXPECT_DOUBLE_EQ(orders->get_order(best)->price, 9999.5);
+    EXPECT_EQ(quotes.resting(OrderSide::BUY), 1u);
+}
+
+TEST(QuoteManagerTest, RefusedAmendIsRequotedInTheSameTick) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    const QuoteManager::Quote bid{9999.5, 10};
+    quotes.update(&bid, 1, nullptr, 0, batch);
+    quotes.settle(batch, ACCEPTED);
+    Order partial = batch.places.at(0);
+    partial.filled_quantity = 8.0;
+    partial.status = OrderStatus::PARTIALLY_FILLED;
+    orders->update_order(partial);
+
+    // Below what has filled, so the amend is refused locally
+    batch.clear();
+    const QuoteManager::Quote smaller{9999.5, 2};
+    quotes.update(&smaller, 1, nullptr, 0, batch);
+    EXPECT_EQ(batch.cancels, std::vector<int64_t>{partial.order_id});
+    ASSERT_EQ(batch.places.size(), 1u);
+    EXPECT_DOUBLE_EQ(batch.places[0].quantity, 2.0);
+    quotes.settle(batch, ACCEPTED);
+    EXPECT_EQ(quotes.resting(OrderSide::BUY), 1u);
+    EXPECT_EQ(orders->active_order_count(), 1);
+}
+
+TEST(QuoteManagerTest, ForgetsQuotesTheExchangeCancelled) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    const QuoteManager::Quote bids[] = {{9999.5, 10}, {9999.0, 10}};
+    const QuoteManager::Quote ask{10000.5, 10};
+    quotes.update(bids, 2, &ask, 1, batch);
+    quotes.settle(batch, ACCEPTED);
+
+    // A kill switch cancel-all: OrderManager is emptied by whoever sent it
+    EXPECT_EQ(orders->cancel_all_orders(), 3u);
+    quotes.forget();
+    EXPECT_EQ(quotes.resting(OrderSide::BUY), 0u);
+    EXPECT_EQ(quotes.resting(OrderSide::SELL), 0u);
+
+    // Quoting again places afresh instead of amending or cancelling the dead ones
+    batch.clear();
+    quotes.update(bids, 2, &ask, 1, batch);
+    EXPECT_EQ(batch.places.size(), 3u);
+    EXPECT_TRUE(batch.amends.empty());
+    EXPECT_TRUE(batch.cancels.empty());
+    EXPECT_EQ(orders->active_order_count(), 3);
+}
+
+TEST(QuoteManagerTest, QuietMarketCutsMessageRate) {
+    auto orders = make_order_manager();
+    QuoteManager quotes(orders, quote_config());
+    OrderBatch batch;
+
+    // Mid wanders by fractions of a tick; sizes jitter by a lot or two
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.1);
+    std::uniform_int_distribution<int> size_jitter(-2, 2);
+    double mid = 10000.0;
+    size_t sent = 0;
+    constexpr int TICKS = 10000;
+    for (int i = 0; i < TICKS; ++i) {
+        mid += noise(rng);
+        const QuoteManager::Quote bid{mid - 1.0, 10.0 + size_jitter(rng)};
+        const QuoteManager::Quote ask{mid + 1.0, 10.0 + size_jitter(rng)};
+        batch.clear();
+        quotes.update(&bid, 1, &ask, 1, batch);
+        quotes.settle(batch, ACCEPTED);
+        sent += messages(batch);
+    }
+
+    // Sending fresh quotes every tick would cost two messages per tick
+    EXPECT_LT(sent * 10, static_cast<size_t>(2 * TICKS));
+    EXPECT_EQ(orders->active_order_count(), 2);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <market_maker/utils/book_kernels.h>
+#include <random>
+
+class BookKernelsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> qty(0.5, 20.0);
+        
+        depth.begin_update();
+        for (size_t i = 0; i < MarketDepth::MAX_LEVELS; ++i) {
+            depth.update_bid(i, 100.0 - 0.5 * i, qty(rng));
+            depth.update_ask(i, 100.5 + 0.5 * i, qty(rng));
+        }
+        depth.commit();
+        book.load(depth);
+    }
+    
+    // Straightforward reference over the AoS book
+    double reference_vwap(BookSide side, double size) const {
+        const auto& levels = side == BookSide::BID ? depth.bids : depth.asks;
+        double filled = 0.0, notional = 0.0;
+        for (const auto& level : levels) {
+            double take = std::min(level.quantity, size - filled);
+            if (take <= 0.0) break;
+            filled += take;
+            notional += take * level.price;
+        }
+        return notional / filled;
+    }
+    
+    MarketDepth depth;
+    DepthSoA book;
+};
+
+TEST_F(BookKernelsTest, CumulativeDepthMatchesScalarSum) {
+    for (size_t n = 0; n <= DepthSoA::LEVELS; ++n) {
+        double expected = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            expected += depth.bids[i].quantity;
+        }
+        EXPECT_NEAR(book_kernels::cumulative_depth(book, BookSide::BID, n), expected, 1e-9);
+    }
+}
+
+TEST_F(BookKernelsTest, VwapToSizeMatchesReference) {
+    for (double size : {0.1, 5.0, 37.0, 80.0, 150.0}) {
+        EXPECT_NEAR(book_kernels::vwap_to_size(book, BookSide::ASK, size),
+                    reference_vwap(BookSide::ASK, size), 1e-9) << size;
+        EXPECT_NEAR(book_kernels::vwap_to_size(book, BookSide::BID, size),
+                    reference_vwap(BookSide::BID, size), 1e-9) << size;
+    }
+}
+
+TEST_F(BookKernelsTest, SweepBeyondVisibleDepthFillsWhatExists) {
+    const double total = book_kernels::cumulative_depth(book, BookSide::ASK);
+    auto result = book_kernels::sweep(book.ask_px, book.ask_qty, DepthSoA::LEVELS, total * 2);
+    EXPECT_NEAR(result.filled, total, 1e-9);
+    
+    const double cost = book_kernels::sweep_cost(book, BookSide::ASK, 1.0, 100.5);
+    EXPECT_NEAR(cost, 0.0, 1e-12);
+}
+
+TEST_F(BookKernelsTest, ImbalanceSignAndRange) {
+    const double imb = book_kernels::imbalance(book, 5);
+    EXPECT_GE(imb, -1.0);
+    EXPECT_LE(imb, 1.0);
+    
+    float features[book_kernels::NUM_BOOK_FEATURES];
+    book_kernels::extract_features(book, features);
+    EXPECT_FLOAT_EQ(features[0], 100.25f);
+    EXPECT_FLOAT_EQ(features[1], 0.5f);
+}
+
+TEST_F(BookKernelsTest, PushFeaturesAppendsOneSample) {
+    FeatureWindow window(4, book_kernels::NUM_BOOK_FEATURES + 1);
+    window.staging()[book_kernels::NUM_BOOK_FEATURES] = 7.0f;
+    book_kernels::push_features(depth, window);
+    
+    float features[book_kernels::NUM_BOOK_FEATURES];
+    book_kernels::extract_features(book, features);
+    EXPECT_EQ(window.size(), 1u);
+    for (size_t c = 0; c < book_kernels::NUM_BOOK_FEATURES; ++c) {
+        EXPECT_FLOAT_EQ(window.channel(c)[3], features[c]) << c;
+    }
+    EXPECT_FLOAT_EQ(window.channel(book_kernels::NUM_BOOK_FEATURES)[3], 7.0f);
+    
+    FeatureWindow narrow(4, 2);
+    EXPECT_THROW(book_kernels::push_features(depth, narrow), std::runtime_error);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <market_maker/utils/feature_window.h>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+TEST(FeatureWindowTest, RowsAreAlignedAndContiguous) {
+    FeatureWindow window(5, 3);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(window.data()) % CACHE_LINE_SIZE, 0u);
+    EXPECT_EQ(window.row_stride() * sizeof(float) % CACHE_LINE_SIZE, 0u);
+    EXPECT_GE(window.row_stride(), 10u);
+}
+
+TEST(FeatureWindowTest, WindowRollsInPlace) {
+    const size_t seq_len = 4;
+    FeatureWindow window(seq_len, 2);
+    const float* base = window.data();
+
+    for (int t = 0; t < 11; ++t) {
+        float sample[2] = {static_cast<float>(t), static_cast<float>(100 + t)};
+        window.push(sample);
+    }
+
+    EXPECT_TRUE(window.full());
+    EXPECT_EQ(window.data(), base);
+
+    // Last four samples, oldest first, read straight from each row
+    for (size_t t = 0; t < seq_len; ++t) {
+        EXPECT_FLOAT_EQ(window.channel(0)[t], 7.0f + t);
+        EXPECT_FLOAT_EQ(window.channel(1)[t], 107.0f + t);
+        EXPECT_FLOAT_EQ(window.data()[window.row_stride() + window.offset() + t], 107.0f + t);
+    }
+}
+
+TEST(FeatureWindowTest, StagingRowCommitsOneSample) {
+    FeatureWindow window(3, 2);
+    window.staging()[0] = 1.5f;
+    window.staging()[1] = -2.5f;
+    window.commit();
+
+    EXPECT_EQ(window.size(), 1u);
+    EXPECT_FLOAT_EQ(window.channel(0)[2], 1.5f);
+    EXPECT_FLOAT_EQ(window.channel(1)[2], -2.5f);
+    EXPECT_FLOAT_EQ(window.channel(0)[0], 0.0f);
+}
+
+TEST(FeatureWindowTest, MomentsMatchFullRecompute) {
+    const size_t seq_len = 6;
+    const size_t channels = 3;
+    FeatureWindow window(seq_len, channels);
+
+    for (int t = 0; t < 17; ++t) {
+        float sample[channels];
+        for (size_t c = 0; c < channels; ++c) {
+            sample[c] = std::sin(0.3f * t + c) * 10.0f;
+        }
+        window.push(sample);
+
+        // Each channel against its own row only
+        for (size_t c = 0; c < channels; ++c) {
+            const float* row = window.channel(c);
+            double mean = 0.0;
+            for (size_t t = 0; t < seq_len; ++t) mean += row[t];
+            mean /= seq_len;
+            double var = 0.0;
+            for (size_t t = 0; t < seq_len; ++t) var += (row[t] - mean) * (row[t] - mean);
+            var /= seq_len - 1;
+
+            EXPECT_NEAR(window.mean(c), mean, 1e-9);
+            EXPECT_NEAR(window.stddev(c), std::sqrt(var), 1e-6);
+        }
+    }
+}
+
+TEST(FeatureWindowTest, ChannelsKeepSeparateScales) {
+    FeatureWindow window(4, 2);
+    for (int t = 0; t < 4; ++t) {
+        float sample[2] = {10000.0f + t, 0.01f * t};
+        window.push(sample);
+    }
+
+    EXPECT_NEAR(window.mean(0), 10001.5, 1e-6);
+    EXPECT_NEAR(window.mean(1), 0.015, 1e-6);
+    EXPECT_LT(window.stddev(1), 0.02);
+}
+
+TEST(FeatureWindowTest, SnapshotIsConsistentUnderConcurrentCommits) {
+    const size_t seq_len = 32;
+    const size_t channels = 4;
+    FeatureWindow window(seq_len, channels);
+    std::atomic<bool> done{false};
+
+    // Every channel of sample t holds t, so a torn copy shows up as
+    // channels disagreeing at some position
+    std::thread writer([&] {
+        for (int t = 1; t <= 200000; ++t) {
+            for (size_t c = 0; c < channels; ++c) {
+                window.staging()[c] = static_cast<float>(t);
+            }
+            window.commit();
+        }
+        done = true;
+    });
+
+    std::vector<float> copy(seq_len * channels);
+    std::vector<double> mean(channels);
+    size_t snapshots = 0;
+    while (!done) {
+        window.snapshot(copy.data(), mean.data());
+        for (size_t c = 1; c < channels; ++c) {
+            ASSERT_EQ(std::memcmp(copy.data(), copy.data() + c * seq_len, seq_len * sizeof(float)), 0);
+            ASSERT_EQ(mean[c], mean[0]);
+        }
+        ++snapshots;
+    }
+    writer.join();
+    EXPECT_GT(snapshots, 0u);
+}